@@ -7,7 +7,10 @@ public:
     TTChatHandlerMock() : TTChatHandler() {}
     MOCK_METHOD(bool, send, (size_t, const std::string&, TTChatTimestamp), (override));
     MOCK_METHOD(bool, receive, (size_t, const std::string&, TTChatTimestamp), (override));
+    MOCK_METHOD(bool, sendMany, (size_t, const std::vector<std::string_view>&, TTChatTimestamp), (override));
+    MOCK_METHOD(bool, receiveMany, (size_t, const std::vector<std::string_view>&, TTChatTimestamp), (override));
     MOCK_METHOD(bool, select, (size_t), (override));
+    MOCK_METHOD(bool, page, (size_t), (override));
     MOCK_METHOD(bool, create, (size_t), (override));
     MOCK_METHOD(bool, size, (), (const, override));
     MOCK_METHOD(std::optional<TTChatEntries>, get, (size_t), (const, override));
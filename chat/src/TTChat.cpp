@@ -71,7 +71,9 @@ void TTChat::heartbeat(std::promise<void> promise) {
     } else {
         try {
             TTChatMessage message;
-            message.setType(TTChatMessageType::HEARTBEAT); 
+            message.setType(TTChatMessageType::HEARTBEAT);
+            // Handler replays only as much history as fits on the pane
+            message.setData(std::to_string(mHeight));
             while (true) {
                 if (isStopped()) {
                     LOG_WARNING("Forced exit on secondary (heartbeat) loop");
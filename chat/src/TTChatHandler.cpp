@@ -1,6 +1,8 @@
 #include "TTChatHandler.hpp"
 #include "TTChatSettings.hpp"
 #include "TTDiagnosticsLogger.hpp"
+#include <algorithm>
+#include <charconv>
 #include <list>
 #include <limits>
 #include <iostream>
@@ -9,8 +11,7 @@ TTChatHandler::TTChatHandler(const TTChatSettings& settings) :
         mPrimaryMessageQueue(settings.getPrimaryMessageQueue()),
         mSecondaryMessageQueue(settings.getSecondaryMessageQueue()),
         mHeartbeatResult{},
-        mHandlerResult{},
-        mCurrentId(std::nullopt) {
+        mHandlerResult{} {
     LOG_INFO("Constructing...");
     if (!mPrimaryMessageQueue->create()) {
         throw std::runtime_error("TTChatHandler: Failed to create primary message queue!");
@@ -42,46 +43,61 @@ TTChatHandler::~TTChatHandler() {
 }
 
 bool TTChatHandler::send(size_t id, const std::string& message, TTChatTimestamp timestamp) {
+    return sendMany(id, {message}, timestamp);
+}
+
+bool TTChatHandler::sendMany(size_t id, const std::vector<std::string_view>& messages, TTChatTimestamp timestamp) {
     if (isStopped()) {
         LOG_WARNING("Forced exit on send!");
         return false;
     }
-    std::scoped_lock messagesLock(mMessagesMutex);
-    if (mCurrentId == std::nullopt || mCurrentId.value() != id) {
-        LOG_ERROR("Current ID is either null or not matching the ID={} on send!", id);
+    auto* shard = getShard(id);
+    if (!shard) [[unlikely]] {
+        LOG_ERROR("ID={} out of range on send!", id);
         return false;
     }
-    if (id >= mMessages.size()) [[unlikely]] {
-        LOG_ERROR("ID={} out of range on send!", id);
+    std::scoped_lock shardLock(shard->mutex);
+    std::scoped_lock currentLock(mCurrentMutex);
+    if (mCurrentId.load() != id) {
+        LOG_ERROR("Current ID is either null or not matching the ID={} on send!", id);
         return false;
     }
-    auto& storage = mMessages[id];
-    storage.push_back({TTChatMessageType::SENDER, timestamp, message});
-    if (!send(TTChatMessageType::SENDER, message, timestamp)) {
+    for (const auto& message : messages) {
+        shard->entries.push_back({TTChatMessageType::SENDER, timestamp, std::string(message)});
+    }
+    if (!follow(*shard, TTChatMessageType::SENDER, messages, timestamp)) {
         return false;
     }
-    LOG_INFO("Successfully updated storage with new send message type, ID={}", id);
+    LOG_INFO("Successfully updated storage with {} new send message type, ID={}", messages.size(), id);
     return true;
 }
 
 bool TTChatHandler::receive(size_t id, const std::string& message, TTChatTimestamp timestamp) {
+    return receiveMany(id, {message}, timestamp);
+}
+
+bool TTChatHandler::receiveMany(size_t id, const std::vector<std::string_view>& messages, TTChatTimestamp timestamp) {
     if (isStopped()) {
         LOG_WARNING("Forced exit on receive!");
         return false;
     }
-    std::scoped_lock messagesLock(mMessagesMutex);
-    if (id >= mMessages.size()) [[unlikely]] {
+    auto* shard = getShard(id);
+    if (!shard) [[unlikely]] {
         LOG_ERROR("ID={} out of range on receive!", id);
         return false;
     }
-    auto& storage = mMessages[id];
-    storage.push_back({TTChatMessageType::RECEIVER, timestamp, message});
-    if (mCurrentId && mCurrentId.value() == id) {
-        if (!send(TTChatMessageType::RECEIVER, message, timestamp)) {
+    std::scoped_lock shardLock(shard->mutex);
+    for (const auto& message : messages) {
+        shard->entries.push_back({TTChatMessageType::RECEIVER, timestamp, std::string(message)});
+    }
+    // Contact becomes current only with its shard held, so receives of other contacts do not take current mutex
+    if (mCurrentId.load() == id) {
+        std::scoped_lock currentLock(mCurrentMutex);
+        if (mCurrentId.load() == id && !follow(*shard, TTChatMessageType::RECEIVER, messages, timestamp)) {
             return false;
         }
     }
-    LOG_INFO("Successfully updated storage with new receive message type, ID={}", id);
+    LOG_INFO("Successfully updated storage with {} new receive message type, ID={}", messages.size(), id);
     return true;
 }
 
@@ -90,73 +106,148 @@ bool TTChatHandler::select(size_t id) {
         LOG_WARNING("Forced exit on select!");
         return false;
     }
-    std::scoped_lock messagesLock(mMessagesMutex);
-    if (id >= mMessages.size()) [[unlikely]] {
+    auto* shard = getShard(id);
+    if (!shard) [[unlikely]] {
         LOG_ERROR("ID={} out of range on select!", id);
         return false;
     }
-    if (mCurrentId && mCurrentId.value() == id) [[unlikely]] {
+    std::scoped_lock shardLock(shard->mutex);
+    std::scoped_lock currentLock(mCurrentMutex);
+    const auto currentId = mCurrentId.load();
+    if (currentId == id) [[unlikely]] {
         LOG_WARNING("Current ID={} is matching, no need continue on select!", id);
         return true;
     }
-    if (mCurrentId) {
-        if (!send(TTChatMessageType::CLEAR, {}, std::chrono::system_clock::now())) {
-            return false;
-        }
+    std::list<std::unique_ptr<TTChatMessage>> queued;
+    if (currentId != NO_CURRENT_ID) {
+        chunk(TTChatMessageType::CLEAR, {}, std::chrono::system_clock::now(), queued);
     }
-    mCurrentId = id;
-    const auto& storage = mMessages[id];
-    for (const auto &message : storage) {
-        if (!send(message.type, message.data, message.timestamp)) {
-            return false;
-        }
+    mCurrentId.store(id);
+    mCurrentPage = 0;
+    // Only the latest page is replayed, so selection takes the same time regardless of the history length
+    replay(*shard, mCurrentPage, queued);
+    if (!enqueue(queued)) {
+        return false;
     }
     LOG_INFO("Successfully selected new ID={}", id);
     return true;
 }
 
+bool TTChatHandler::page(size_t page) {
+    if (isStopped()) {
+        LOG_WARNING("Forced exit on page!");
+        return false;
+    }
+    const auto id = mCurrentId.load();
+    auto* shard = (id != NO_CURRENT_ID) ? getShard(id) : nullptr;
+    if (!shard) [[unlikely]] {
+        LOG_ERROR("Current ID is null on page!");
+        return false;
+    }
+    std::scoped_lock shardLock(shard->mutex);
+    std::scoped_lock currentLock(mCurrentMutex);
+    if (mCurrentId.load() != id) [[unlikely]] {
+        LOG_ERROR("Current ID={} changed on page!", id);
+        return false;
+    }
+    const auto window = mWindow.load();
+    const auto size = shard->entries.size();
+    const auto lastPage = size ? (size - 1) / window : 0;
+    page = std::min(page, lastPage);
+    if (page == mCurrentPage) {
+        LOG_WARNING("Page={} is already shown, no need continue on page!", page);
+        return true;
+    }
+    std::list<std::unique_ptr<TTChatMessage>> queued;
+    chunk(TTChatMessageType::CLEAR, {}, std::chrono::system_clock::now(), queued);
+    mCurrentPage = page;
+    replay(*shard, mCurrentPage, queued);
+    if (!enqueue(queued)) {
+        return false;
+    }
+    LOG_INFO("Successfully shown page={} of ID={}", page, id);
+    return true;
+}
+
 bool TTChatHandler::create(size_t id) {
     if (isStopped()) {
         LOG_WARNING("Forced exit on create!");
         return false;
     }
-    std::scoped_lock messagesLock(mMessagesMutex);
-    if (id != mMessages.size()) {
+    std::scoped_lock shardsLock(mShardsMutex);
+    if (id != mShards.size()) {
         LOG_ERROR("ID={} is within existing range boundaries on create!", id);
         return false;
     }
     // New storage
-    mMessages.push_back({});
+    mShards.push_back(std::make_unique<Shard>());
     LOG_INFO("Successfully created new storage, ID={}", id);
     return true;
 }
 
 bool TTChatHandler::size() const {
-    std::shared_lock messagesLock(mMessagesMutex);
-    return mMessages.size();
+    std::shared_lock shardsLock(mShardsMutex);
+    return mShards.size();
 }
 
 std::optional<TTChatEntries> TTChatHandler::get(size_t id) const {
-    std::shared_lock messagesLock(mMessagesMutex);
-    if (id >= mMessages.size()) {
+    auto* shard = getShard(id);
+    if (!shard) {
         LOG_ERROR("Failed to return messages of ID={}", id);
         return std::nullopt;
     }
-    return {mMessages[id]};
+    std::scoped_lock shardLock(shard->mutex);
+    return {shard->entries};
 }
 
 std::optional<size_t> TTChatHandler::current() const {
-    std::shared_lock messagesLock(mMessagesMutex);
-    return mCurrentId;
+    const auto currentId = mCurrentId.load();
+    if (currentId == NO_CURRENT_ID) {
+        return std::nullopt;
+    }
+    return currentId;
 }
 
-bool TTChatHandler::send(TTChatMessageType type, const std::string& data, TTChatTimestamp timestamp) {
-    LOG_INFO("Started preparing messages to be queued");
-    if (isStopped()) {
-        LOG_WARNING("Forced exit at generic message type!");
-        return false;
+TTChatHandler::Shard* TTChatHandler::getShard(size_t id) const {
+    std::shared_lock shardsLock(mShardsMutex);
+    if (id >= mShards.size()) {
+        return nullptr;
+    }
+    return mShards[id].get();
+}
+
+bool TTChatHandler::send(TTChatMessageType type, std::string_view data, TTChatTimestamp timestamp) {
+    std::list<std::unique_ptr<TTChatMessage>> messages;
+    chunk(type, data, timestamp, messages);
+    return enqueue(messages);
+}
+
+void TTChatHandler::replay(const Shard& shard, size_t page, std::list<std::unique_ptr<TTChatMessage>>& messages) const {
+    const auto window = mWindow.load();
+    const auto& entries = shard.entries;
+    const auto end = entries.size() - std::min(entries.size(), page * window);
+    const auto begin = end - std::min(end, window);
+    for (auto i = begin; i < end; ++i) {
+        chunk(entries[i].type, entries[i].data, entries[i].timestamp, messages);
+    }
+}
+
+bool TTChatHandler::follow(const Shard& shard, TTChatMessageType type, const std::vector<std::string_view>& messages, TTChatTimestamp timestamp) {
+    std::list<std::unique_ptr<TTChatMessage>> queued;
+    if (mCurrentPage != 0) {
+        // Older page is shown, go back to the latest one which includes new messages
+        chunk(TTChatMessageType::CLEAR, {}, std::chrono::system_clock::now(), queued);
+        mCurrentPage = 0;
+        replay(shard, mCurrentPage, queued);
+    } else {
+        for (const auto& message : messages) {
+            chunk(type, message, timestamp, queued);
+        }
     }
+    return enqueue(queued);
+}
 
+void TTChatHandler::chunk(TTChatMessageType type, std::string_view data, TTChatTimestamp timestamp, std::list<std::unique_ptr<TTChatMessage>>& messages) const {
     size_t numberOfFullMessages = (data.size() / TTChatMessage::MAX_DATA_LENGTH);
     size_t totalFullMessagesDataLength = numberOfFullMessages * TTChatMessage::MAX_DATA_LENGTH;
     size_t lastMessageDataLength = data.size() - totalFullMessagesDataLength;
@@ -168,20 +259,25 @@ bool TTChatHandler::send(TTChatMessageType type, const std::string& data, TTChat
     }
 
     // Create chunk messages
-    std::list<std::unique_ptr<TTChatMessage>> messages;
     for (size_t i = 0; i < numberOfFullMessages; ++i) {
-        const char* cdata = data.c_str() + (TTChatMessage::MAX_DATA_LENGTH * i);
         const auto chunkType = static_cast<TTChatMessageType>(static_cast<size_t>(type) + 1);
-        auto message = std::make_unique<TTChatMessage>(chunkType, timestamp, std::string_view(cdata, TTChatMessage::MAX_DATA_LENGTH));
+        auto message = std::make_unique<TTChatMessage>(chunkType, timestamp, data.substr(TTChatMessage::MAX_DATA_LENGTH * i, TTChatMessage::MAX_DATA_LENGTH));
         messages.push_back(std::move(message));
     }
     // Create full message
     {
-        const char* cdata = data.c_str() + totalFullMessagesDataLength;
-        auto message = std::make_unique<TTChatMessage>(type, timestamp, std::string_view(cdata, lastMessageDataLength));
+        auto message = std::make_unique<TTChatMessage>(type, timestamp, data.substr(totalFullMessagesDataLength, lastMessageDataLength));
         messages.push_back(std::move(message));
     }
-    // Fill the queue
+}
+
+bool TTChatHandler::enqueue(std::list<std::unique_ptr<TTChatMessage>>& messages) {
+    LOG_INFO("Started preparing messages to be queued");
+    if (isStopped()) {
+        LOG_WARNING("Forced exit at generic message type!");
+        return false;
+    }
+    // Fill the queue, whole batch at once, so it is sent as one contiguous burst
     {
         std::scoped_lock lock(mQueueMutex);
         for (auto & it : messages) {
@@ -191,7 +287,6 @@ bool TTChatHandler::send(TTChatMessageType type, const std::string& data, TTChat
     mQueueCondition.notify_one();
     LOG_INFO("Completed preparing messages to be queued");
     return true;
-    
 }
 
 std::list<std::unique_ptr<TTChatMessage>> TTChatHandler::dequeue() {
@@ -256,6 +351,14 @@ void TTChatHandler::heartbeat() {
                     LOG_ERROR("Received message other than the heartbeat message!");
                     break;
                 }
+                // Heartbeat carries height of the chat pane, page is what fits on it, but at least one entry
+                if (const auto data = message.getData(); !data.empty()) {
+                    size_t height = 0;
+                    auto [ptr, ec] = std::from_chars(data.data(), data.data() + data.size(), height);
+                    if (ec == std::errc() && height > 0) {
+                        mWindow.store(std::max<size_t>(height / ENTRY_MIN_LINES, 1));
+                    }
+                }
             }
         } catch (...) {
             LOG_ERROR("Caught unknown exception at secondary (heartbeat) loop!");
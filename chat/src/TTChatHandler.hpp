@@ -3,12 +3,16 @@
 #include "TTChatSettings.hpp"
 #include "TTChatEntry.hpp"
 #include "TTUtilsStopable.hpp"
+#include <atomic>
 #include <memory>
 #include <future>
 #include <queue>
-#include <vector>
+#include <deque>
+#include <limits>
 #include <list>
 #include <shared_mutex>
+#include <string_view>
+#include <vector>
 #include <optional>
 
 // Class meant to be embedded into other higher abstract class.
@@ -23,7 +27,12 @@ public:
     TTChatHandler& operator=(TTChatHandler&&) = delete;
     virtual bool send(size_t id, const std::string& message, TTChatTimestamp timestamp);
     virtual bool receive(size_t id, const std::string& message, TTChatTimestamp timestamp);
+    // Bulk variants, take the locks once and queue all messages as one burst
+    virtual bool sendMany(size_t id, const std::vector<std::string_view>& messages, TTChatTimestamp timestamp);
+    virtual bool receiveMany(size_t id, const std::vector<std::string_view>& messages, TTChatTimestamp timestamp);
     virtual bool select(size_t id);
+    // Shows older page of the current contact history, 0 is the latest one (shown on selection)
+    virtual bool page(size_t page);
     virtual bool create(size_t id);
     virtual bool size() const;
     [[nodiscard]] virtual std::optional<TTChatEntries> get(size_t id) const;
@@ -31,7 +40,21 @@ public:
 protected:
     TTChatHandler() = default;
 private:
-    bool send(TTChatMessageType type, const std::string& data, TTChatTimestamp timestamp);
+    // History of single contact with its own lock, so contacts do not block each other
+    struct Shard {
+        std::mutex mutex;
+        TTChatEntries entries;
+    };
+    // Returns shard of the contact, null if out of range
+    Shard* getShard(size_t id) const;
+    bool send(TTChatMessageType type, std::string_view data, TTChatTimestamp timestamp);
+    // Appends messages of the page of the history (called with shard held)
+    void replay(const Shard& shard, size_t page, std::list<std::unique_ptr<TTChatMessage>>& messages) const;
+    // Shows new messages of the current contact (called with shard and current mutex held)
+    bool follow(const Shard& shard, TTChatMessageType type, const std::vector<std::string_view>& messages, TTChatTimestamp timestamp);
+    // Splits data into messages of maximum length and appends them to the list
+    void chunk(TTChatMessageType type, std::string_view data, TTChatTimestamp timestamp, std::list<std::unique_ptr<TTChatMessage>>& messages) const;
+    bool enqueue(std::list<std::unique_ptr<TTChatMessage>>& messages);
     std::list<std::unique_ptr<TTChatMessage>> dequeue();
     // Receives heartbeat
     void heartbeat();
@@ -50,8 +73,19 @@ private:
     std::mutex mQueueMutex;
     std::condition_variable mQueueCondition;
     std::queue<std::unique_ptr<TTChatMessage>> mQueuedMessages;
-    // Messages storage
-    std::optional<size_t> mCurrentId;
-    mutable std::shared_mutex mMessagesMutex;
-    std::vector<TTChatEntries> mMessages;
+    // Messages storage, shards are only added
+    mutable std::shared_mutex mShardsMutex;
+    std::deque<std::unique_ptr<Shard>> mShards;
+    // Changed with both the current mutex and the shard of the new current contact held,
+    // so receive holding its shard can check it without locking
+    std::mutex mCurrentMutex;
+    std::atomic<size_t> mCurrentId{NO_CURRENT_ID};
+    // Page of the current contact history being shown, guarded by current mutex
+    size_t mCurrentPage = 0;
+    // Number of entries per page, derived from the chat pane height
+    std::atomic<size_t> mWindow{DEFAULT_WINDOW};
+    static inline constexpr size_t NO_CURRENT_ID{std::numeric_limits<size_t>::max()};
+    static inline constexpr size_t DEFAULT_WINDOW{64};
+    // Timestamp, at least one line of text and blank line
+    static inline constexpr size_t ENTRY_MIN_LINES{3};
 };
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <gmock/gmock.h>
 #include <thread>
 #include <chrono>
+#include <algorithm>
 #include <functional>
 #include <span>
 
@@ -726,3 +727,174 @@ TEST_F(TTChatHandlerTest, HappyPathCreateSendAndReceiveHugeMessages) {
     EXPECT_TRUE(IsOrderEqualTo(mSentMessages, {expectedSentMessages.begin() + 1, expectedSentMessages.end() - 1}));
     EXPECT_TRUE(IsLastEqualTo(mSentMessages, expectedSentMessages.back()));
 }
+
+TEST_F(TTChatHandlerTest, HappyPathConcurrentReceiveFromManyContacts) {
+    EXPECT_CALL(*mPrimaryMessageQueueMock, create)
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mSecondaryMessageQueueMock, create)
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mPrimaryMessageQueueMock, alive)
+        .Times(AtLeast(1))
+        .WillRepeatedly(Return(true));
+    EXPECT_CALL(*mSecondaryMessageQueueMock, alive)
+        .Times(AtLeast(1))
+        .WillRepeatedly(Return(true));
+    const auto messageToBeReceived = TTChatMessage(TTChatMessageType::HEARTBEAT);
+    EXPECT_CALL(*mSecondaryMessageQueueMock, receive)
+        .Times(AtLeast(1))
+        .WillRepeatedly(DoAll(std::bind(&TTChatHandlerTest::ProvideReceivedMessage, this, _1, messageToBeReceived, std::chrono::milliseconds{20}), Return(true)));
+    EXPECT_CALL(*mPrimaryMessageQueueMock, send)
+        .Times(AtLeast(1))
+        .WillRepeatedly(DoAll(std::bind(&TTChatHandlerTest::RetrieveSentMessage, this, _1, std::chrono::milliseconds{0}), Return(true)));
+    // Verify
+    EXPECT_TRUE(StartHandler(std::chrono::milliseconds{std::chrono::milliseconds{HEARTBEAT_TIMEOUT_MS + 100}}));
+    const size_t contacts = 8;
+    const size_t messages = 100;
+    for (size_t id = 0; id < contacts; ++id) {
+        EXPECT_TRUE(mChatHandler->create(id));
+    }
+    EXPECT_TRUE(mChatHandler->select(0));
+    // Each contact receives on its own thread while the selected one is being switched
+    std::vector<std::thread> receivers;
+    for (size_t id = 0; id < contacts; ++id) {
+        receivers.emplace_back([this, id, messages]() {
+            for (size_t i = 0; i < messages; ++i) {
+                EXPECT_TRUE(mChatHandler->receive(id, std::to_string(i), {}));
+            }
+        });
+    }
+    for (size_t i = 0; i < messages; ++i) {
+        EXPECT_TRUE(mChatHandler->select(i % contacts));
+    }
+    for (auto& receiver : receivers) {
+        receiver.join();
+    }
+    EXPECT_TRUE(mChatHandler->select(contacts - 1));
+    EXPECT_TRUE(mChatHandler->send(contacts - 1, "Thanks!", {}));
+    EXPECT_TRUE(StopHandler(std::chrono::milliseconds{100}));
+    // History of every contact is complete and in order of receiving
+    for (size_t id = 0; id < contacts; ++id) {
+        const auto entries = mChatHandler->get(id);
+        ASSERT_NE(entries, std::nullopt);
+        const size_t expectedSize = (id == contacts - 1) ? messages + 1 : messages;
+        ASSERT_EQ(entries->size(), expectedSize);
+        for (size_t i = 0; i < messages; ++i) {
+            EXPECT_EQ(entries->at(i).type, TTChatMessageType::RECEIVER);
+            EXPECT_EQ(entries->at(i).data, std::to_string(i));
+        }
+    }
+    EXPECT_EQ(mChatHandler->current(), contacts - 1);
+}
+
+TEST_F(TTChatHandlerTest, HappyPathReceiveManySentAsOneBurst) {
+    EXPECT_CALL(*mPrimaryMessageQueueMock, create)
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mSecondaryMessageQueueMock, create)
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mPrimaryMessageQueueMock, alive)
+        .Times(AtLeast(1))
+        .WillRepeatedly(Return(true));
+    EXPECT_CALL(*mSecondaryMessageQueueMock, alive)
+        .Times(AtLeast(1))
+        .WillRepeatedly(Return(true));
+    const auto messageToBeReceived = TTChatMessage(TTChatMessageType::HEARTBEAT);
+    EXPECT_CALL(*mSecondaryMessageQueueMock, receive)
+        .Times(AtLeast(1))
+        .WillRepeatedly(DoAll(std::bind(&TTChatHandlerTest::ProvideReceivedMessage, this, _1, messageToBeReceived, std::chrono::milliseconds{20}), Return(true)));
+    EXPECT_CALL(*mPrimaryMessageQueueMock, send)
+        .Times(AtLeast(1))
+        .WillRepeatedly(DoAll(std::bind(&TTChatHandlerTest::RetrieveSentMessage, this, _1, std::chrono::milliseconds{0}), Return(true)));
+    // Verify
+    EXPECT_TRUE(StartHandler(std::chrono::milliseconds{std::chrono::milliseconds{HEARTBEAT_TIMEOUT_MS + 100}}));
+    const size_t count = 1000;
+    std::vector<std::string> messages;
+    for (size_t i = 0; i < count; ++i) {
+        messages.push_back(std::to_string(i));
+    }
+    const std::vector<std::string_view> batch(messages.begin(), messages.end());
+    EXPECT_FALSE(mChatHandler->receiveMany(1, batch, {}));
+    EXPECT_FALSE(mChatHandler->sendMany(0, batch, {}));
+    EXPECT_TRUE(mChatHandler->create(0));
+    EXPECT_TRUE(mChatHandler->create(1));
+    EXPECT_FALSE(mChatHandler->sendMany(0, batch, {}));
+    EXPECT_TRUE(mChatHandler->receiveMany(1, batch, {}));
+    EXPECT_TRUE(mChatHandler->select(0));
+    EXPECT_TRUE(mChatHandler->receiveMany(0, batch, {}));
+    EXPECT_TRUE(mChatHandler->sendMany(0, {batch.begin(), batch.begin() + 2}, {}));
+    std::this_thread::sleep_for(std::chrono::milliseconds{HEARTBEAT_TIMEOUT_MS});
+    EXPECT_TRUE(StopHandler(std::chrono::milliseconds{100}));
+    // Storage
+    ASSERT_NE(mChatHandler->get(0), std::nullopt);
+    EXPECT_EQ(mChatHandler->get(0)->size(), count + 2);
+    ASSERT_NE(mChatHandler->get(1), std::nullopt);
+    EXPECT_EQ(mChatHandler->get(1)->size(), count);
+    // Messages of selected contact are queued one after another, nothing in between
+    const auto first = std::find(mSentMessages.begin(), mSentMessages.end(), TTChatMessage(TTChatMessageType::RECEIVER, {}, messages.front()));
+    ASSERT_NE(first, mSentMessages.end());
+    ASSERT_GE(std::distance(first, mSentMessages.end()), count + 2);
+    for (size_t i = 0; i < count; ++i) {
+        EXPECT_EQ(*(first + i), TTChatMessage(TTChatMessageType::RECEIVER, {}, messages[i]));
+    }
+    EXPECT_EQ(*(first + count), TTChatMessage(TTChatMessageType::SENDER, {}, messages[0]));
+    EXPECT_EQ(*(first + count + 1), TTChatMessage(TTChatMessageType::SENDER, {}, messages[1]));
+}
+
+TEST_F(TTChatHandlerTest, HappyPathSelectReplaysLatestPageOnly) {
+    EXPECT_CALL(*mPrimaryMessageQueueMock, create)
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mSecondaryMessageQueueMock, create)
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mPrimaryMessageQueueMock, alive)
+        .Times(AtLeast(1))
+        .WillRepeatedly(Return(true));
+    EXPECT_CALL(*mSecondaryMessageQueueMock, alive)
+        .Times(AtLeast(1))
+        .WillRepeatedly(Return(true));
+    // Chat pane of 10 lines fits 3 entries, partial one is not counted
+    const auto messageToBeReceived = TTChatMessage(TTChatMessageType::HEARTBEAT, {}, "10");
+    EXPECT_CALL(*mSecondaryMessageQueueMock, receive)
+        .Times(AtLeast(1))
+        .WillRepeatedly(DoAll(std::bind(&TTChatHandlerTest::ProvideReceivedMessage, this, _1, messageToBeReceived, std::chrono::milliseconds{20}), Return(true)));
+    EXPECT_CALL(*mPrimaryMessageQueueMock, send)
+        .Times(AtLeast(1))
+        .WillRepeatedly(DoAll(std::bind(&TTChatHandlerTest::RetrieveSentMessage, this, _1, std::chrono::milliseconds{0}), Return(true)));
+    const auto receiver = [](const std::string& data) { return TTChatMessage(TTChatMessageType::RECEIVER, {}, data); };
+    std::vector<TTChatMessage> expectedSentMessages = {
+        receiver("7"), receiver("8"), receiver("9"),
+        TTChatMessage(TTChatMessageType::CLEAR),
+        receiver("4"), receiver("5"), receiver("6"),
+        TTChatMessage(TTChatMessageType::CLEAR),
+        receiver("0"),
+        TTChatMessage(TTChatMessageType::CLEAR),
+        receiver("8"), receiver("9"), receiver("10")
+    };
+    // Verify
+    EXPECT_TRUE(StartHandler(std::chrono::milliseconds{std::chrono::milliseconds{HEARTBEAT_TIMEOUT_MS + 100}}));
+    EXPECT_FALSE(mChatHandler->page(0));
+    EXPECT_TRUE(mChatHandler->create(0));
+    for (size_t i = 0; i < 10; ++i) {
+        EXPECT_TRUE(mChatHandler->receive(0, std::to_string(i), {}));
+    }
+    EXPECT_TRUE(mChatHandler->select(0));
+    EXPECT_TRUE(mChatHandler->page(0));
+    EXPECT_TRUE(mChatHandler->page(1));
+    // Page past the oldest one shows the oldest one
+    EXPECT_TRUE(mChatHandler->page(100));
+    EXPECT_TRUE(mChatHandler->page(3));
+    // New message brings back the latest page
+    EXPECT_TRUE(mChatHandler->receive(0, "10", {}));
+    std::this_thread::sleep_for(std::chrono::milliseconds{HEARTBEAT_TIMEOUT_MS});
+    EXPECT_TRUE(StopHandler(std::chrono::milliseconds{100}));
+    EXPECT_EQ(mChatHandler->get(0)->size(), 11);
+    std::vector<TTChatMessage> actualSentMessages;
+    std::copy_if(mSentMessages.begin(), mSentMessages.end(), std::back_inserter(actualSentMessages), [](const auto& message) {
+        return message.getType() != TTChatMessageType::HEARTBEAT && message.getType() != TTChatMessageType::GOODBYE;
+    });
+    EXPECT_EQ(actualSentMessages, expectedSentMessages);
+}
@@ -1,13 +1,34 @@
 #pragma once
 #include <gmock/gmock.h>
 #include "TTContactsHandler.hpp"
+#include <map>
 
 class TTContactsHandlerMock : public TTContactsHandler {
 public:
-    TTContactsHandlerMock() : TTContactsHandler() {}
+    TTContactsHandlerMock() : TTContactsHandler() {
+        ON_CALL(*this, snapshot()).WillByDefault(::testing::Return(std::make_shared<const TTContactsSnapshot>()));
+    }
+    // Snapshot with given entries (by ID) indexed by identity
+    static std::shared_ptr<const TTContactsSnapshot> makeSnapshot(const std::map<size_t, TTContactsHandlerEntry>& entries) {
+        auto contacts = std::make_shared<TTContactsSnapshot>();
+        auto index = std::make_shared<TTContactsIndex>();
+        for (const auto& [id, entry] : entries) {
+            if (contacts->entries.size() <= id) {
+                contacts->entries.resize(id + 1);
+                contacts->counters.resize(id + 1);
+            }
+            contacts->entries[id] = std::make_shared<const TTContactsHandlerEntry>(entry);
+            contacts->counters[id] = std::make_shared<const TTContactsCounters>();
+            index->insert(entry.key, id, [&](size_t other) -> const std::string& { return contacts->entries[other]->key; });
+        }
+        contacts->index = std::move(index);
+        return contacts;
+    }
     MOCK_METHOD(bool, create, (const std::string&, const std::string&, const std::string&), (override));
     MOCK_METHOD(bool, send, (size_t), (override));
     MOCK_METHOD(bool, receive, (size_t), (override));
+    MOCK_METHOD(bool, sendMany, (size_t, size_t), (override));
+    MOCK_METHOD(bool, receiveMany, (size_t, size_t), (override));
     MOCK_METHOD(bool, activate, (size_t), (override));
     MOCK_METHOD(bool, deactivate, (size_t), (override));
     MOCK_METHOD(bool, select, (size_t), (override));
@@ -15,6 +36,7 @@ public:
     MOCK_METHOD(std::optional<size_t>, get, (const std::string&), (const, override));
     MOCK_METHOD(std::optional<size_t>, current, (), (const, override));
     MOCK_METHOD(size_t, size, (), (const, override));
+    MOCK_METHOD(std::shared_ptr<const TTContactsSnapshot>, snapshot, (), (const, override));
     MOCK_METHOD(void, stop, (), (override));
     MOCK_METHOD(bool, isStopped, (), (const, override));
 };
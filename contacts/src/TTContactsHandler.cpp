@@ -44,12 +44,19 @@ bool TTContactsHandler::create(const std::string& nickname, const std::string& i
     message.setIdentity(mContacts.size());
     message.setNickname(nickname);
     mContacts.emplace_back(nickname, identity, ipAddressAndPort);
-    mIdentityMap[identity] = message.getIdentity();
+    mCounters.push_back(std::make_shared<TTContactsCounters>());
+    auto index = std::make_shared<TTContactsIndex>(*mSnapshot.load()->index);
+    index->insert(mContacts.back().key, message.getIdentity(), [this](size_t id) -> const std::string& { return mContacts[id].key; });
+    publish(message.getIdentity(), std::move(index));
     return send(message);
 }
 
 bool TTContactsHandler::send(size_t id) {
-    LOG_INFO("Called send ID={}", id);
+    return sendMany(id, 1);
+}
+
+bool TTContactsHandler::sendMany(size_t id, size_t count) {
+    LOG_INFO("Called send ID={}, count={}", id, count);
     std::scoped_lock contactsLock(mContactsMutex);
     if (id >= mContacts.size()) [[unlikely]] {
         return false;
@@ -70,8 +77,9 @@ bool TTContactsHandler::send(size_t id) {
             return false;
     }
 
-    mContacts[id].sentMessages++;
+    mCounters[id]->sentMessages += count;
     if (previousState != mContacts[id].state) [[likely]] {
+        publish(id);
         TTContactsMessage message;
         message.setStatus(TTContactsStatus::STATE);
         message.setState(mContacts[id].state);
@@ -83,7 +91,11 @@ bool TTContactsHandler::send(size_t id) {
 }
 
 bool TTContactsHandler::receive(size_t id) {
-    LOG_INFO("Called receive ID={}", id);
+    return receiveMany(id, 1);
+}
+
+bool TTContactsHandler::receiveMany(size_t id, size_t count) {
+    LOG_INFO("Called receive ID={}, count={}", id, count);
     std::scoped_lock contactsLock(mContactsMutex);
     if (id >= mContacts.size()) [[unlikely]] {
         return false;
@@ -104,8 +116,9 @@ bool TTContactsHandler::receive(size_t id) {
             return false;
     }
 
-    mContacts[id].receivedMessages++;
+    mCounters[id]->receivedMessages += count;
     if (previousState != mContacts[id].state) [[likely]] {
+        publish(id);
         TTContactsMessage message;
         message.setStatus(TTContactsStatus::STATE);
         message.setState(mContacts[id].state);
@@ -139,6 +152,7 @@ bool TTContactsHandler::activate(size_t id) {
     }
 
     if (previousState != mContacts[id].state) [[likely]] {
+        publish(id);
         TTContactsMessage message;
         message.setStatus(TTContactsStatus::STATE);
         message.setState(mContacts[id].state);
@@ -172,6 +186,7 @@ bool TTContactsHandler::deactivate(size_t id) {
     }
 
     if (previousState != mContacts[id].state) [[likely]] {
+        publish(id);
         TTContactsMessage message;
         message.setStatus(TTContactsStatus::STATE);
         message.setState(mContacts[id].state);
@@ -206,6 +221,7 @@ bool TTContactsHandler::select(size_t id) {
                 LOG_ERROR("Failed to change contact state from {} on unselect", size_t(mContacts[previousContactValue].state));
                 return false;
         }
+        publish(previousContactValue);
         TTContactsMessage message;
         message.setStatus(TTContactsStatus::STATE);
         message.setState(mContacts[previousContactValue].state);
@@ -231,6 +247,7 @@ bool TTContactsHandler::select(size_t id) {
             LOG_ERROR("Failed to change contact state from {} on select", size_t(mContacts[id].state));
             return false;
     }
+    publish(id);
     TTContactsMessage message;
     message.setStatus(TTContactsStatus::STATE);
     message.setState(mContacts[id].state);
@@ -241,32 +258,50 @@ bool TTContactsHandler::select(size_t id) {
 
 std::optional<TTContactsHandlerEntry> TTContactsHandler::get(size_t id) const {
     LOG_INFO("Called get ID={}", id);
-    std::shared_lock contactsLock(mContactsMutex);
-    if (id >= mContacts.size()) [[unlikely]] {
+    const auto contacts = mSnapshot.load();
+    const auto* entry = contacts->get(id);
+    if (!entry) [[unlikely]] {
         return std::nullopt;
     }
-    return {mContacts[id]};
+    auto result = *entry;
+    result.sentMessages = contacts->counters[id]->sentMessages.load();
+    result.receivedMessages = contacts->counters[id]->receivedMessages.load();
+    return result;
 }
 
 std::optional<size_t> TTContactsHandler::get(const std::string& id) const {
     LOG_INFO("Called get ID={}", id);
-    std::shared_lock contactsLock(mContactsMutex);
-    decltype(auto) result = mIdentityMap.find(id);
-    if (result == mIdentityMap.end()) [[unlikely]] {
-        return std::nullopt;
-    }
-    return {result->second};
+    return mSnapshot.load()->get(id);
 }
 
 std::optional<size_t> TTContactsHandler::current() const {
-    std::shared_lock contactsLock(mContactsMutex);
     LOG_INFO("Called current");
-    return mCurrentContact;
+    return mSnapshot.load()->current;
 }
 
 size_t TTContactsHandler::size() const {
-    std::shared_lock contactsLock(mContactsMutex);
-    return mContacts.size();
+    return mSnapshot.load()->entries.size();
+}
+
+std::shared_ptr<const TTContactsSnapshot> TTContactsHandler::snapshot() const {
+    return mSnapshot.load();
+}
+
+void TTContactsHandler::publish(size_t id, std::shared_ptr<const TTContactsIndex> index) {
+    // Only the changed entry is copied, the others are shared with the previous snapshot
+    auto contacts = std::make_shared<TTContactsSnapshot>(*mSnapshot.load());
+    auto entry = std::make_shared<const TTContactsHandlerEntry>(mContacts[id]);
+    if (id < contacts->entries.size()) {
+        contacts->entries[id] = std::move(entry);
+    } else {
+        contacts->entries.push_back(std::move(entry));
+        contacts->counters.push_back(mCounters[id]);
+    }
+    if (index) {
+        contacts->index = std::move(index);
+    }
+    contacts->current = mCurrentContact;
+    mSnapshot.store(std::move(contacts));
 }
 
 bool TTContactsHandler::send(const TTContactsMessage& message) {
@@ -1,17 +1,17 @@
 #pragma once
 #include "TTContactsMessage.hpp"
 #include "TTContactsHandlerEntry.hpp"
+#include "TTContactsSnapshot.hpp"
 #include "TTContactsSettings.hpp"
 #include "TTUtilsSharedMem.hpp"
 #include "TTUtilsStopable.hpp"
+#include <atomic>
 #include <queue>
 #include <deque>
 #include <mutex>
-#include <shared_mutex>
 #include <thread>
 #include <condition_variable>
 #include <memory>
-#include <unordered_map>
 #include <optional>
 
 // Class meant to be embedded into other higher abstract class.
@@ -27,6 +27,9 @@ public:
     virtual bool create(const std::string& nickname, const std::string& identity, const std::string& ipAddressAndPort);
     virtual bool send(size_t id);
     virtual bool receive(size_t id);
+    // Bulk variants, state is changed and published once for the whole batch
+    virtual bool sendMany(size_t id, size_t count);
+    virtual bool receiveMany(size_t id, size_t count);
     virtual bool activate(size_t id);
     virtual bool deactivate(size_t id);
     virtual bool select(size_t id);
@@ -34,6 +37,8 @@ public:
     [[nodiscard]] virtual std::optional<size_t> get(const std::string& id) const;
     [[nodiscard]] virtual std::optional<size_t> current() const;
     [[nodiscard]] virtual size_t size() const;
+    // Current state of all contacts, never changes once returned (no lock held while reading it)
+    [[nodiscard]] virtual std::shared_ptr<const TTContactsSnapshot> snapshot() const;
 protected:
     TTContactsHandler() = default;
 private:
@@ -47,6 +52,9 @@ private:
     bool establish();
     // Sends last bit of information - goodbye message
     void sendGoodbye();
+    // Publishes snapshot with the current entry of the contact, not needed when only counters change
+    // (called with contacts mutex held)
+    void publish(size_t id, std::shared_ptr<const TTContactsIndex> index = nullptr);
     // IPC shared memory communication
     std::shared_ptr<TTUtilsSharedMem> mSharedMem;
     // Thread concurrent message communication
@@ -58,10 +66,11 @@ private:
     // Thread concurrent heartbeat
     std::thread mHeartbeatThread;
     std::mutex mHeartbeatQuitMutex;
-    // Contacts storage
-    mutable std::shared_mutex mContactsMutex;
+    // Contacts storage, modified by writers only, readers use the snapshot
+    std::mutex mContactsMutex;
     std::optional<size_t> mCurrentContact;
     std::optional<size_t> mPreviousContact;
     std::deque<TTContactsHandlerEntry> mContacts;
-    std::unordered_map<std::string, size_t> mIdentityMap;
+    std::deque<std::shared_ptr<TTContactsCounters>> mCounters;
+    std::atomic<std::shared_ptr<const TTContactsSnapshot>> mSnapshot{std::make_shared<const TTContactsSnapshot>()};
 };
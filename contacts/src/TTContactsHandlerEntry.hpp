@@ -1,17 +1,20 @@
 #pragma once
 #include "TTContactsState.hpp"
+#include "TTContactsKey.hpp"
 #include <string>
 
 struct TTContactsHandlerEntry final {
     std::string nickname;
     std::string identity;
     std::string ipAddressAndPort;
+    // Packed identity, contacts are indexed by it
+    std::string key;
     size_t sentMessages;
     size_t receivedMessages;
     TTContactsState state;
     TTContactsHandlerEntry(const std::string& nickname, const std::string& identity, const std::string& ipAddressAndPort) :
         nickname(nickname), identity(identity),
-        ipAddressAndPort(ipAddressAndPort), sentMessages(0), receivedMessages(0),
+        ipAddressAndPort(ipAddressAndPort), key(TTContactsKey::make(identity)), sentMessages(0), receivedMessages(0),
         state(TTContactsState::ACTIVE) {}
     TTContactsHandlerEntry() = default;
     ~TTContactsHandlerEntry() = default;
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+// Flat open-addressing index of contacts by key (packed identity), slot keeps precomputed hash of the key and contact ID,
+// linear probing over power-of-two table, key is compared only on hash match (not thread-safe)
+class TTContactsIndex {
+public:
+    TTContactsIndex() : mSlots(INITIAL_CAPACITY) {}
+    ~TTContactsIndex() = default;
+    TTContactsIndex(const TTContactsIndex&) = default;
+    TTContactsIndex(TTContactsIndex&&) = default;
+    TTContactsIndex& operator=(const TTContactsIndex&) = default;
+    TTContactsIndex& operator=(TTContactsIndex&&) = default;
+    // Maps key to contact ID (replaces previous mapping), key of the contact is read with accessor
+    template <typename Accessor>
+    void insert(std::string_view key, size_t id, Accessor&& keyOf) {
+        if ((mSize + 1) * 2 > mSlots.size()) {
+            grow();
+        }
+        const auto hashed = hash(key);
+        for (size_t i = hashed & (mSlots.size() - 1); ; i = (i + 1) & (mSlots.size() - 1)) {
+            auto& slot = mSlots[i];
+            if (slot.id == EMPTY) {
+                slot = {hashed, id};
+                ++mSize;
+                return;
+            }
+            if (slot.hash == hashed && keyOf(slot.id) == key) {
+                slot.id = id;
+                return;
+            }
+        }
+    }
+    // Returns ID of the contact, key of the contact is read with accessor
+    template <typename Accessor>
+    [[nodiscard]] std::optional<size_t> find(std::string_view key, Accessor&& keyOf) const {
+        const auto hashed = hash(key);
+        for (size_t i = hashed & (mSlots.size() - 1); ; i = (i + 1) & (mSlots.size() - 1)) {
+            const auto& slot = mSlots[i];
+            if (slot.id == EMPTY) {
+                return std::nullopt;
+            }
+            if (slot.hash == hashed && keyOf(slot.id) == key) {
+                return slot.id;
+            }
+        }
+    }
+    [[nodiscard]] size_t size() const { return mSize; }
+    // FNV-1a
+    [[nodiscard]] static uint64_t hash(std::string_view key) {
+        uint64_t result = 14695981039346656037ULL;
+        for (const auto character : key) {
+            result ^= static_cast<uint8_t>(character);
+            result *= 1099511628211ULL;
+        }
+        return result;
+    }
+private:
+    struct Slot {
+        uint64_t hash = 0;
+        size_t id = EMPTY;
+    };
+    // Hashes are kept in slots, so keys are not read while rehashing
+    void grow() {
+        std::vector<Slot> slots(mSlots.size() * 2);
+        for (const auto& slot : mSlots) {
+            if (slot.id == EMPTY) {
+                continue;
+            }
+            size_t i = slot.hash & (slots.size() - 1);
+            while (slots[i].id != EMPTY) {
+                i = (i + 1) & (slots.size() - 1);
+            }
+            slots[i] = slot;
+        }
+        mSlots.swap(slots);
+    }
+    std::vector<Slot> mSlots;
+    size_t mSize = 0;
+    static inline constexpr size_t EMPTY = std::numeric_limits<size_t>::max();
+    static inline constexpr size_t INITIAL_CAPACITY = 64;
+};
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Key of the contact, SHA-1 hex string identity (as made by tteams.sh) is packed into 20 raw bytes,
+// identity of any other format is the key as it is, so packed key received from the network is resolved directly
+class TTContactsKey {
+public:
+    // Returns 20 bytes key, nullopt if identity is not lowercase SHA-1 hex string
+    [[nodiscard]] static std::optional<std::string> pack(std::string_view identity) {
+        if (identity.size() != SIZE * 2) {
+            return std::nullopt;
+        }
+        std::string key(SIZE, '\0');
+        for (size_t i = 0; i < SIZE; ++i) {
+            const auto high = nibble(identity[2 * i]);
+            const auto low = nibble(identity[2 * i + 1]);
+            if (high < 0 || low < 0) {
+                return std::nullopt;
+            }
+            key[i] = static_cast<char>((high << 4) | low);
+        }
+        return key;
+    }
+    [[nodiscard]] static std::string unpack(std::string_view key) {
+        static constexpr char DIGITS[] = "0123456789abcdef";
+        std::string identity;
+        identity.reserve(key.size() * 2);
+        for (const auto byte : key) {
+            identity.push_back(DIGITS[static_cast<uint8_t>(byte) >> 4]);
+            identity.push_back(DIGITS[static_cast<uint8_t>(byte) & 0x0F]);
+        }
+        return identity;
+    }
+    // Key of identity given either as it is or already packed
+    [[nodiscard]] static std::string make(std::string_view identity) {
+        auto key = pack(identity);
+        return key ? std::move(key.value()) : std::string(identity);
+    }
+    [[nodiscard]] static bool same(std::string_view lhs, std::string_view rhs) {
+        return lhs == rhs || make(lhs) == make(rhs);
+    }
+    // Identity for logs, packed key is shown as hex string
+    [[nodiscard]] static std::string print(std::string_view identity) {
+        return identity.size() == SIZE ? unpack(identity) : std::string(identity);
+    }
+    static inline constexpr size_t SIZE = 20;
+private:
+    static int nibble(char character) {
+        if (character >= '0' && character <= '9') {
+            return character - '0';
+        }
+        if (character >= 'a' && character <= 'f') {
+            return character - 'a' + 10;
+        }
+        return -1;
+    }
+};
@@ -0,0 +1,35 @@
+#pragma once
+#include "TTContactsHandlerEntry.hpp"
+#include "TTContactsIndex.hpp"
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+// Message counters of the contact, shared by all snapshots and updated in place,
+// so sending or receiving a message does not publish new snapshot
+struct TTContactsCounters final {
+    std::atomic<size_t> sentMessages{0};
+    std::atomic<size_t> receivedMessages{0};
+};
+
+// Immutable copy of the contacts table, handler publishes new one on every membership or state change (copy-on-write),
+// so readers neither take the contacts mutex nor copy entries (loading the pointer itself is not lock-free in libstdc++,
+// it briefly spins on an internal lock), unchanged entries and index are shared between snapshots
+struct TTContactsSnapshot final {
+    [[nodiscard]] const TTContactsHandlerEntry* get(size_t id) const {
+        return id < entries.size() ? entries[id].get() : nullptr;
+    }
+    // Identity is either SHA-1 hex string or packed key as received from the network (not unpacked)
+    [[nodiscard]] std::optional<size_t> get(std::string_view identity) const {
+        const auto packed = TTContactsKey::pack(identity);
+        return index->find(packed ? std::string_view(packed.value()) : identity,
+            [this](size_t id) -> const std::string& { return entries[id]->key; });
+    }
+    // Message counters of the entries are not maintained, the shared counters are
+    std::vector<std::shared_ptr<const TTContactsHandlerEntry>> entries;
+    std::vector<std::shared_ptr<const TTContactsCounters>> counters;
+    std::shared_ptr<const TTContactsIndex> index = std::make_shared<const TTContactsIndex>();
+    std::optional<size_t> current;
+};
@@ -550,3 +550,144 @@ TEST_F(TTContactsHandlerTest, UnhappyPathNonExistingContact) {
     EXPECT_EQ(mContactsHandler->current().value(), 0);
     EXPECT_EQ(mContactsHandler->size(), mExpectedEntries.size());
 }
+
+TEST_F(TTContactsHandlerTest, HappyPathSnapshotNotChangedByWriters) {
+    // Expected entries
+    CreateEntry("A", "0feca842", "192.168.1.15", TTContactsState::ACTIVE, 0, 0);
+    CreateEntry("B", "09dda800", "192.168.1.16", TTContactsState::SELECTED_ACTIVE, 0, 0);
+    // Expected calls
+    EXPECT_CALL(*mSharedMemMock, create)
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mSharedMemMock, send)
+        .Times(AtLeast(1))
+        .WillRepeatedly(std::bind(&TTContactsHandlerTest::RetrieveSentMessageTrue, this, _1, _2, _3));
+    EXPECT_CALL(*mSharedMemMock, destroy)
+        .Times(1)
+        .WillOnce(Return(true));
+    // Flow
+    EXPECT_TRUE(StartHandler(std::chrono::milliseconds{TTCONTACTS_HEARTBEAT_TIMEOUT_MS}));
+    EXPECT_TRUE(mContactsHandler->create(mExpectedEntries[0].nickname, mExpectedEntries[0].identity, mExpectedEntries[0].ipAddressAndPort));
+    const auto before = mContactsHandler->snapshot();
+    EXPECT_TRUE(mContactsHandler->create(mExpectedEntries[1].nickname, mExpectedEntries[1].identity, mExpectedEntries[1].ipAddressAndPort));
+    EXPECT_TRUE(mContactsHandler->select(1));
+    const auto after = mContactsHandler->snapshot();
+    EXPECT_TRUE(StopHandler());
+    // Snapshot taken before is not affected
+    ASSERT_EQ(before->entries.size(), 1);
+    EXPECT_EQ(*before->get(0), mExpectedEntries[0]);
+    EXPECT_EQ(before->get(1), nullptr);
+    EXPECT_EQ(before->get(mExpectedEntries[1].identity), std::nullopt);
+    EXPECT_EQ(before->current, std::nullopt);
+    // Unchanged entry is shared
+    ASSERT_EQ(after->entries.size(), 2);
+    EXPECT_EQ(after->entries[0], before->entries[0]);
+    EXPECT_EQ(*after->get(1), mExpectedEntries[1]);
+    EXPECT_EQ(after->get(mExpectedEntries[1].identity), 1);
+    EXPECT_EQ(after->current, 1);
+}
+
+TEST_F(TTContactsHandlerTest, HappyPathSnapshotResolvesPackedKey) {
+    // Expected entries
+    CreateEntry("A", "a94a8fe5ccb19ba61c4c0873d391e987982fbbd3", "192.168.1.15", TTContactsState::SELECTED_ACTIVE, 0, 0);
+    CreateEntry("B", "09dda800", "192.168.1.16", TTContactsState::ACTIVE, 0, 0);
+    // Expected calls
+    EXPECT_CALL(*mSharedMemMock, create)
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mSharedMemMock, send)
+        .Times(AtLeast(1))
+        .WillRepeatedly(std::bind(&TTContactsHandlerTest::RetrieveSentMessageTrue, this, _1, _2, _3));
+    EXPECT_CALL(*mSharedMemMock, destroy)
+        .Times(1)
+        .WillOnce(Return(true));
+    // Flow
+    EXPECT_TRUE(StartHandler(std::chrono::milliseconds{TTCONTACTS_HEARTBEAT_TIMEOUT_MS}));
+    for (const auto& entry : mExpectedEntries) {
+        EXPECT_TRUE(mContactsHandler->create(entry.nickname, entry.identity, entry.ipAddressAndPort));
+    }
+    const auto contacts = mContactsHandler->snapshot();
+    EXPECT_TRUE(StopHandler());
+    // SHA-1 identity is resolved either as it is or packed (as received from the network)
+    EXPECT_EQ(contacts->get(mExpectedEntries[0].identity), 0);
+    EXPECT_EQ(contacts->get(TTContactsKey::pack(mExpectedEntries[0].identity).value()), 0);
+    EXPECT_EQ(contacts->get(mExpectedEntries[1].identity), 1);
+    EXPECT_EQ(contacts->get(TTContactsKey::pack("a94a8fe5ccb19ba61c4c0873d391e987982fbbd4").value()), std::nullopt);
+}
+
+TEST_F(TTContactsHandlerTest, HappyPathSnapshotNotPublishedOnCountersChange) {
+    // Expected entries
+    CreateEntry("A", "0feca842", "192.168.1.15", TTContactsState::SELECTED_ACTIVE, 2, 3);
+    // Expected calls
+    EXPECT_CALL(*mSharedMemMock, create)
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mSharedMemMock, send)
+        .Times(AtLeast(1))
+        .WillRepeatedly(std::bind(&TTContactsHandlerTest::RetrieveSentMessageTrue, this, _1, _2, _3));
+    EXPECT_CALL(*mSharedMemMock, destroy)
+        .Times(1)
+        .WillOnce(Return(true));
+    // Flow
+    EXPECT_TRUE(StartHandler(std::chrono::milliseconds{TTCONTACTS_HEARTBEAT_TIMEOUT_MS}));
+    EXPECT_TRUE(mContactsHandler->create(mExpectedEntries[0].nickname, mExpectedEntries[0].identity, mExpectedEntries[0].ipAddressAndPort));
+    EXPECT_TRUE(mContactsHandler->select(0));
+    const auto before = mContactsHandler->snapshot();
+    // Selected contact stays in the same state, only its counters change
+    EXPECT_TRUE(mContactsHandler->sendMany(0, 2));
+    EXPECT_TRUE(mContactsHandler->receiveMany(0, 3));
+    const auto after = mContactsHandler->snapshot();
+    EXPECT_TRUE(StopHandler());
+    EXPECT_EQ(before, after);
+    EXPECT_EQ(after->counters[0]->sentMessages.load(), 2);
+    EXPECT_EQ(after->counters[0]->receivedMessages.load(), 3);
+    ASSERT_NE(mContactsHandler->get(0), std::nullopt);
+    EXPECT_EQ(mContactsHandler->get(0).value(), mExpectedEntries[0]);
+}
+
+TEST_F(TTContactsHandlerTest, HappyPathSendAndReceiveManyMachineState) {
+    // Expected messages
+    CreateMessage(TTContactsStatus::HEARTBEAT);
+    CreateMessage(TTContactsStatus::STATE, TTContactsState::ACTIVE, 0, "A");
+    CreateMessage(TTContactsStatus::STATE, TTContactsState::ACTIVE, 1, "B");
+    CreateMessage(TTContactsStatus::STATE, TTContactsState::SELECTED_ACTIVE, 0, "A");
+    CreateMessage(TTContactsStatus::STATE, TTContactsState::UNREAD_MSG_ACTIVE, 1, "B");
+    CreateMessage(TTContactsStatus::GOODBYE);
+    // Expected entries
+    CreateEntry("A", "0feca842", "192.168.1.15", TTContactsState::SELECTED_ACTIVE, 5, 1000);
+    CreateEntry("B", "09dda800", "192.168.1.16", TTContactsState::UNREAD_MSG_ACTIVE, 0, 1001);
+    // Expected calls
+    EXPECT_CALL(*mSharedMemMock, create)
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mSharedMemMock, send)
+        .Times(AtLeast(mExpectedMessages.size()))
+        .WillRepeatedly(std::bind(&TTContactsHandlerTest::RetrieveSentMessageTrue, this, _1, _2, _3));
+    EXPECT_CALL(*mSharedMemMock, destroy)
+        .Times(1)
+        .WillOnce(Return(true));
+    // Flow
+    EXPECT_TRUE(StartHandler(std::chrono::milliseconds{TTCONTACTS_HEARTBEAT_TIMEOUT_MS}));
+    EXPECT_TRUE(mContactsHandler->create(mExpectedEntries[0].nickname, mExpectedEntries[0].identity, mExpectedEntries[0].ipAddressAndPort));
+    EXPECT_TRUE(mContactsHandler->create(mExpectedEntries[1].nickname, mExpectedEntries[1].identity, mExpectedEntries[1].ipAddressAndPort));
+    // Only selected contact can send
+    EXPECT_FALSE(mContactsHandler->sendMany(0, 5));
+    EXPECT_TRUE(mContactsHandler->select(0));
+    EXPECT_TRUE(mContactsHandler->sendMany(0, 5));
+    // Whole batch is a single state change
+    EXPECT_TRUE(mContactsHandler->receiveMany(0, 1000));
+    EXPECT_TRUE(mContactsHandler->receiveMany(1, 1000));
+    EXPECT_TRUE(mContactsHandler->receive(1));
+    EXPECT_FALSE(mContactsHandler->receiveMany(2, 1000));
+    std::this_thread::sleep_for(std::chrono::milliseconds{TTCONTACTS_HEARTBEAT_TIMEOUT_MS});
+    EXPECT_TRUE(StopHandler());
+    // Expected data
+    EXPECT_GT(mSentMessages.size(), mExpectedMessages.size());
+    EXPECT_TRUE(IsFirstEqualTo(mSentMessages, mExpectedMessages.front()));
+    EXPECT_TRUE(IsLastEqualTo(mSentMessages, mExpectedMessages.back()));
+    EXPECT_TRUE(IsOrderEqualTo({mSentMessages.begin(), mSentMessages.end()}, {mExpectedMessages.begin() + 1, mExpectedMessages.end() - 1}));
+    for (size_t i = 0; i < mExpectedEntries.size(); ++i) {
+        ASSERT_NE(mContactsHandler->get(i), std::nullopt);
+        EXPECT_EQ(mContactsHandler->get(i).value(), mExpectedEntries[i]);
+    }
+}
@@ -0,0 +1,51 @@
+#include "TTContactsIndex.hpp"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+class TTContactsIndexTest : public testing::Test {
+protected:
+    void Insert(const std::string& identity) {
+        mIdentities.push_back(identity);
+        mIndex.insert(identity, mIdentities.size() - 1, mIdentityOf);
+    }
+    std::vector<std::string> mIdentities;
+    TTContactsIndex mIndex;
+    std::function<const std::string&(size_t)> mIdentityOf = [this](size_t id) -> const std::string& { return mIdentities[id]; };
+};
+
+TEST_F(TTContactsIndexTest, HappyPathFindInserted) {
+    Insert("0feca842");
+    Insert("09dda800");
+    EXPECT_EQ(mIndex.find("0feca842", mIdentityOf), 0);
+    EXPECT_EQ(mIndex.find("09dda800", mIdentityOf), 1);
+    EXPECT_EQ(mIndex.find("0feca843", mIdentityOf), std::nullopt);
+    EXPECT_EQ(mIndex.find("", mIdentityOf), std::nullopt);
+    EXPECT_EQ(mIndex.size(), 2);
+}
+
+TEST_F(TTContactsIndexTest, HappyPathInsertSameIdentityReplaces) {
+    Insert("0feca842");
+    Insert("0feca842");
+    EXPECT_EQ(mIndex.find("0feca842", mIdentityOf), 1);
+    EXPECT_EQ(mIndex.size(), 1);
+}
+
+TEST_F(TTContactsIndexTest, HappyPathGrowsKeepingEntries) {
+    // Well above initial capacity, so the table is rehashed few times
+    const size_t count = 1000;
+    for (size_t i = 0; i < count; ++i) {
+        Insert("a94a8fe5ccb19ba61c4c0873d391e987982fb" + std::to_string(i));
+    }
+    EXPECT_EQ(mIndex.size(), count);
+    for (size_t i = 0; i < count; ++i) {
+        EXPECT_EQ(mIndex.find(mIdentities[i], mIdentityOf), i);
+    }
+}
+
+TEST_F(TTContactsIndexTest, HappyPathHashIsStable) {
+    EXPECT_EQ(TTContactsIndex::hash(""), 14695981039346656037ULL);
+    EXPECT_NE(TTContactsIndex::hash("0feca842"), TTContactsIndex::hash("09dda800"));
+}
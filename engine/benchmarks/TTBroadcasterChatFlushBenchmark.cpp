@@ -0,0 +1,136 @@
+#include "TTBroadcasterChat.hpp"
+#include "TTDiagnosticsLogger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+LOG_DECLARE("tteams-engine-benchmarks");
+
+// Delivery latency of outgoing chat messages (from send to the network call),
+// typing is simulated as bursts of quick follow-ups separated by pauses
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t BURSTS = 100;
+constexpr size_t SEED = 7;
+// Simulated round trip of tell/narrate
+constexpr std::chrono::milliseconds ROUND_TRIP{1};
+
+const TTContactsHandlerEntry HOST_ENTRY{"host", "888992ef", "192.168.1.1:1777"};
+const TTContactsHandlerEntry NEIGHBOR_ENTRY{"neighbor", "f71e7fb", "127.0.0.1:1"};
+
+class ContactsHandler : public TTContactsHandler {
+public:
+    bool send(size_t) override { return true; }
+    bool receive(size_t) override { return true; }
+    std::optional<TTContactsHandlerEntry> get(size_t id) const override { return id ? NEIGHBOR_ENTRY : HOST_ENTRY; }
+    std::optional<size_t> get(const std::string&) const override { return 1; }
+    std::optional<size_t> current() const override { return 1; }
+};
+
+class ChatHandler : public TTChatHandler {
+public:
+    bool send(size_t, const std::string&, TTChatTimestamp) override { return true; }
+    bool receive(size_t, const std::string&, TTChatTimestamp) override { return true; }
+    std::optional<size_t> current() const override { return 1; }
+};
+
+// Records when each message reached the network, stub is created but never connected
+class NeighborsStub : public TTNeighborsStub {
+public:
+    TTUniqueChatStream createChatStream(TTNeighborsChatStubIf&) const override { return nullptr; }
+    TTTellResponse sendTell(TTNeighborsChatStubIf&, const TTTellRequest& rhs) const override {
+        record({rhs.message});
+        return TTTellResponse{true};
+    }
+    TTNarrateResponse sendNarrate(TTNeighborsChatStubIf&, const TTNarrateRequest& rhs) const override {
+        record(rhs.messages);
+        return TTNarrateResponse{true};
+    }
+    void sent(const std::string& message) {
+        std::scoped_lock lock(mMutex);
+        mSent[message] = Clock::now();
+    }
+    [[nodiscard]] std::vector<double> latencies() const {
+        std::scoped_lock lock(mMutex);
+        return mLatencies;
+    }
+    [[nodiscard]] size_t requests() const {
+        std::scoped_lock lock(mMutex);
+        return mRequests;
+    }
+private:
+    void record(const std::deque<std::string>& messages) const {
+        std::this_thread::sleep_for(ROUND_TRIP);
+        const auto now = Clock::now();
+        std::scoped_lock lock(mMutex);
+        ++mRequests;
+        for (const auto& message : messages) {
+            mLatencies.push_back(std::chrono::duration<double, std::milli>(now - mSent.at(message)).count());
+        }
+    }
+    mutable std::mutex mMutex;
+    std::map<std::string, Clock::time_point> mSent;
+    mutable std::vector<double> mLatencies;
+    mutable size_t mRequests = 0;
+};
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    return values[static_cast<size_t>(p * (values.size() - 1) + 0.5)];
+}
+
+void measure(std::chrono::milliseconds flushWindow) {
+    ContactsHandler contactsHandler;
+    ChatHandler chatHandler;
+    NeighborsStub neighborsStub;
+    TTNeighborsLiveness liveness;
+    TTBroadcasterChatLimits limits;
+    limits.flushWindow = flushWindow;
+    TTBroadcasterChat broadcaster(contactsHandler, chatHandler, neighborsStub, liveness,
+        TTNetworkInterface("lo", "192.168.1.1", "1777"), limits);
+    std::thread loop(std::bind(&TTBroadcasterChat::run, &broadcaster));
+    std::mt19937 generator(SEED);
+    std::uniform_int_distribution<size_t> burst(1, 4);
+    std::uniform_int_distribution<int> followUp(0, 30);
+    std::uniform_int_distribution<int> pause(50, 300);
+    size_t messages = 0;
+    for (size_t i = 0; i < BURSTS; ++i) {
+        const auto size = burst(generator);
+        for (size_t j = 0; j < size; ++j) {
+            const auto message = "message " + std::to_string(messages++);
+            neighborsStub.sent(message);
+            broadcaster.handleSend(message);
+            std::this_thread::sleep_for(std::chrono::milliseconds(followUp(generator)));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(pause(generator)));
+    }
+    // Longest retry interval
+    std::this_thread::sleep_for(std::chrono::milliseconds{6000});
+    broadcaster.stop();
+    loop.join();
+    const auto latencies = neighborsStub.latencies();
+    std::printf("%10lld %10zu %10zu %10zu %10.1f %10.1f %10.1f\n", static_cast<long long>(flushWindow.count()), messages,
+        latencies.size(), neighborsStub.requests(), percentile(latencies, 0.5), percentile(latencies, 0.99),
+        percentile(latencies, 1.0));
+}
+
+}
+
+int main() {
+    std::printf("%10s %10s %10s %10s %10s %10s %10s\n", "window[ms]", "messages", "delivered", "requests", "p50 [ms]", "p99 [ms]", "max [ms]");
+    for (const auto flushWindow : {0, 5, 10, 20}) {
+        measure(std::chrono::milliseconds(flushWindow));
+    }
+    return 0;
+}
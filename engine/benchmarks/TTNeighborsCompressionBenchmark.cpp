@@ -0,0 +1,127 @@
+#include "TTNeighborsStub.hpp"
+#include "TTDiagnosticsLogger.hpp"
+#include "TerminalTeams.pb.h"
+#include <zlib.h>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+LOG_DECLARE("tteams-engine-benchmarks");
+
+// Bytes on the wire and CPU cost of chat payload compression,
+// gRPC gzip compression is zlib deflate with gzip header at default level
+namespace {
+
+struct Payload {
+    std::string name;
+    std::string message;
+};
+
+struct Result {
+    size_t raw;
+    size_t wire;
+    double compressMicroseconds;
+    double decompressMicroseconds;
+};
+
+constexpr size_t ITERATIONS = 200;
+// gRPC message prefix (compressed flag and length)
+constexpr size_t FRAME_SIZE = 5;
+
+std::string makeLog(size_t size) {
+    std::string log;
+    for (size_t i = 0; log.size() < size; ++i) {
+        log += "2024-03-0" + std::to_string(1 + i % 9) + " 12:" + std::to_string(10 + i % 50) + ":07.123 [info] [" +
+            std::to_string(4000 + i % 7) + "] TTBroadcasterChat.cpp:" + std::to_string(100 + i % 90) +
+            " Sending narrate to neighbor id=" + std::to_string(i % 13) + " messages=" + std::to_string(i % 5) + "\n";
+    }
+    log.resize(size);
+    return log;
+}
+
+std::string makeCode(size_t size) {
+    std::string code;
+    for (size_t i = 0; code.size() < size; ++i) {
+        code += "    if (!mContactsHandler.send(id" + std::to_string(i % 17) + ")) [[unlikely]] {\n"
+            "        LOG_ERROR(\"Failed to handle send (contacts handler send failure)!\");\n"
+            "        stop();\n"
+            "        return false;\n"
+            "    }\n";
+    }
+    code.resize(size);
+    return code;
+}
+
+std::string compress(const std::string& input) {
+    z_stream stream{};
+    deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS | 16, 8, Z_DEFAULT_STRATEGY);
+    std::string output(deflateBound(&stream, input.size()), '\0');
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in = input.size();
+    stream.next_out = reinterpret_cast<Bytef*>(output.data());
+    stream.avail_out = output.size();
+    deflate(&stream, Z_FINISH);
+    output.resize(stream.total_out);
+    deflateEnd(&stream);
+    return output;
+}
+
+std::string decompress(const std::string& input, size_t size) {
+    z_stream stream{};
+    inflateInit2(&stream, MAX_WBITS | 16);
+    std::string output(size, '\0');
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in = input.size();
+    stream.next_out = reinterpret_cast<Bytef*>(output.data());
+    stream.avail_out = output.size();
+    inflate(&stream, Z_FINISH);
+    output.resize(stream.total_out);
+    inflateEnd(&stream);
+    return output;
+}
+
+Result measure(const Payload& payload) {
+    tt::TellRequest request;
+    request.set_identity("5ef885a1d3c94e52b1c4b4c0d12f2ea7");
+    request.set_message(payload.message);
+    const auto serialized = request.SerializeAsString();
+    Result result{serialized.size() + FRAME_SIZE, serialized.size() + FRAME_SIZE, 0.0, 0.0};
+    if (payload.message.size() < TT_COMPRESSION_THRESHOLD) {
+        return result;
+    }
+    std::string compressed;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ITERATIONS; ++i) {
+        compressed = compress(serialized);
+    }
+    result.compressMicroseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / ITERATIONS;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ITERATIONS; ++i) {
+        if (decompress(compressed, serialized.size()) != serialized) [[unlikely]] {
+            std::fprintf(stderr, "Decompressed payload mismatch (%s)!\n", payload.name.c_str());
+        }
+    }
+    result.decompressMicroseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / ITERATIONS;
+    result.wire = compressed.size() + FRAME_SIZE;
+    return result;
+}
+
+}
+
+int main() {
+    const std::vector<Payload> payloads = {
+        {"typical short", "Hello, see you at 10:00?"},
+        {"typical sentence", "I have pushed the fix, could you please pull the latest master and check if the contacts window still freezes?"},
+        {"log 4KiB", makeLog(4096)},
+        {"log 64KiB", makeLog(65536)},
+        {"code 16KiB", makeCode(16384)},
+    };
+    std::printf("%-18s %10s %10s %8s %14s %16s\n", "payload", "raw [B]", "wire [B]", "ratio", "compress [us]", "decompress [us]");
+    for (const auto& payload : payloads) {
+        const auto result = measure(payload);
+        std::printf("%-18s %10zu %10zu %8.2f %14.1f %16.1f\n", payload.name.c_str(), result.raw, result.wire,
+            static_cast<double>(result.raw) / result.wire, result.compressMicroseconds, result.decompressMicroseconds);
+    }
+    return 0;
+}
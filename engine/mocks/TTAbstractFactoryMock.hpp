@@ -12,25 +12,37 @@ public:
     MOCK_METHOD(std::unique_ptr<TTChatHandler>, createChatHandler, (), (const, override));
     MOCK_METHOD(std::unique_ptr<TTTextBoxHandler>, createTextBoxHandler, (
         TTTextBoxCallbackMessageSent callbackMessageSent,
-        TTTextBoxCallbackContactSelect callbackContactsSelect), (const, override));
+        TTTextBoxCallbackContactSelect callbackContactsSelect,
+        TTTextBoxCallbackChatPage callbackChatPage), (const, override));
     MOCK_METHOD(std::unique_ptr<TTNeighborsStub>, createNeighborsStub, (), (const, override));
     MOCK_METHOD(std::unique_ptr<TTBroadcasterChat>, createBroadcasterChat, (
         TTContactsHandler& contactsHandler,
         TTChatHandler& chatHandler,
         TTNeighborsStub& neighborsStub,
-        TTNetworkInterface networkInterface), (const, override));
+        TTNeighborsLiveness& liveness,
+        TTNetworkInterface networkInterface,
+        const TTBroadcasterChatLimits& limits), (const, override));
     MOCK_METHOD(std::unique_ptr<TTBroadcasterDiscovery>, createBroadcasterDiscovery, (
         TTContactsHandler& contactsHandler,
         TTChatHandler& chatHandler,
         TTNeighborsStub& neighborsStub,
+        TTNeighborsLiveness& liveness,
         TTNetworkInterface networkInterface,
-        const std::deque<std::string>& neighbors), (const, override));
+        const std::deque<std::string>& neighbors,
+        const std::string& cachePath,
+        const TTNeighborsDetectorSettings& detectorSettings,
+        uint16_t heartbeatPort), (const, override));
     MOCK_METHOD(std::unique_ptr<TTNeighborsServiceChat>, createNeighborsServiceChat, (TTBroadcasterChat& chat), (const, override));
     MOCK_METHOD(std::unique_ptr<TTNeighborsServiceDiscovery>, createNeighborsServiceDiscovery, (TTBroadcasterDiscovery& discovery), (const, override));
     MOCK_METHOD(std::unique_ptr<TTServer>, createServer, (
         const std::string& ipAddressAndPort,
         TTNeighborsServiceChat& chat,
-        TTNeighborsServiceDiscovery& discovery), (const, override));
+        TTNeighborsServiceDiscovery& discovery,
+        size_t threads), (const, override));
+    MOCK_METHOD(std::unique_ptr<TTNeighborsBeacon>, createNeighborsBeacon, (
+        const std::string& groupAddress,
+        TTNetworkInterface networkInterface,
+        TTBroadcasterDiscovery& discovery), (const, override));
 private:
     TTContactsSettingsMock mContactsSettings;
     TTChatSettingsMock mChatSettings;
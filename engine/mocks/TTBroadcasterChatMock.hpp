@@ -7,7 +7,7 @@
 
 class TTBroadcasterChatMock : public TTBroadcasterChat {
 public:
-    TTBroadcasterChatMock() : TTBroadcasterChat(mContactsHandler, mChatHandler, mNeighborsStub, {}) {}
+    TTBroadcasterChatMock() : TTBroadcasterChat(mContactsHandler, mChatHandler, mNeighborsStub, mLiveness, {}) {}
     MOCK_METHOD(void, run, (), (override));
     MOCK_METHOD(void, stop, (), (override));
     MOCK_METHOD(bool, isStopped, (), (const, override));
@@ -19,4 +19,5 @@ private:
     TTContactsHandlerMock mContactsHandler;
     TTChatHandlerMock mChatHandler;
     TTNeighborsStubMock mNeighborsStub;
+    TTNeighborsLiveness mLiveness;
 };
@@ -7,12 +7,15 @@
 
 class TTBroadcasterDiscoveryMock : public TTBroadcasterDiscovery {
 public:
-    TTBroadcasterDiscoveryMock() : TTBroadcasterDiscovery(mContactsHandler, mChatHandler, mNeighborsStub, {}, {}) {}
+    TTBroadcasterDiscoveryMock() : TTBroadcasterDiscovery(mContactsHandler, mChatHandler, mNeighborsStub, mLiveness, {}, {}) {}
     MOCK_METHOD(void, run, (), (override));
     MOCK_METHOD(void, stop, (), (override));
     MOCK_METHOD(bool, isStopped, (), (const, override));
     MOCK_METHOD(bool, handleGreet, (const TTGreetRequest& request), (override));
     MOCK_METHOD(bool, handleHeartbeat, (const TTHeartbeatRequest& request), (override));
+    MOCK_METHOD(bool, handleBeacon, (const TTBeaconRequest& request), (override));
+    MOCK_METHOD(std::deque<TTMemberUpdate>, getMemberUpdates, (), (override));
+    MOCK_METHOD(std::deque<TTPeer>, getPeers, (), (override));
     MOCK_METHOD(std::string, getNickname, (), (override));
     MOCK_METHOD(std::string, getIdentity, (), (override));
     MOCK_METHOD(std::string, getIpAddressAndPort, (), (override));
@@ -20,4 +23,5 @@ private:
     TTContactsHandlerMock mContactsHandler;
     TTChatHandlerMock mChatHandler;
     TTNeighborsStubMock mNeighborsStub;
+    TTNeighborsLiveness mLiveness;
 };
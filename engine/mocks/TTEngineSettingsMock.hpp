@@ -8,5 +8,11 @@ public:
     MOCK_METHOD(const std::string&, getIdentity, (), (const, override));
     MOCK_METHOD(const TTNetworkInterface&, getNetworkInterface, (), (const, override));
     MOCK_METHOD(const std::deque<std::string>&, getNeighbors, (), (const, override));
+    MOCK_METHOD(size_t, getServerThreads, (), (const, override));
+    MOCK_METHOD(const std::string&, getBeaconAddress, (), (const, override));
+    MOCK_METHOD(const TTBroadcasterChatLimits&, getChatLimits, (), (const, override));
+    MOCK_METHOD(const std::string&, getNeighborsCache, (), (const, override));
+    MOCK_METHOD(const TTNeighborsDetectorSettings&, getDetectorSettings, (), (const, override));
+    MOCK_METHOD(uint16_t, getHeartbeatPort, (), (const, override));
     MOCK_METHOD(const TTAbstractFactory&, getAbstractFactory, (), (const, override));
 };
\ No newline at end of file
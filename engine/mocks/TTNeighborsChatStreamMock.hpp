@@ -0,0 +1,13 @@
+#pragma once
+#include <gmock/gmock.h>
+#include "TTNeighborsStub.hpp"
+
+class TTNeighborsChatStreamMock : public TTNeighborsChatStreamIf {
+public:
+    MOCK_METHOD(void, WaitForInitialMetadata, (), (override));
+    MOCK_METHOD(bool, WritesDone, (), (override));
+    MOCK_METHOD(::grpc::Status, Finish, (), (override));
+    MOCK_METHOD(bool, NextMessageSize, (uint32_t* sz), (override));
+    MOCK_METHOD(bool, Read, (::tt::ConverseReply* msg), (override));
+    MOCK_METHOD(bool, Write, (const ::tt::ConverseRequest& msg, ::grpc::WriteOptions options), (override));
+};
@@ -27,5 +27,14 @@ public:
     MOCK_METHOD(::grpc::ClientAsyncWriterInterface< ::tt::NarrateRequest>*,
         PrepareAsyncNarrateRaw,
         (::grpc::ClientContext* context, ::tt::NarrateReply* response, ::grpc::CompletionQueue* cq), (override));
+    MOCK_METHOD((::grpc::ClientReaderWriterInterface< ::tt::ConverseRequest, ::tt::ConverseReply>*),
+        ConverseRaw,
+        (::grpc::ClientContext* context), (override));
+    MOCK_METHOD((::grpc::ClientAsyncReaderWriterInterface< ::tt::ConverseRequest, ::tt::ConverseReply>*),
+        AsyncConverseRaw,
+        (::grpc::ClientContext* context, ::grpc::CompletionQueue* cq, void* tag), (override));
+    MOCK_METHOD((::grpc::ClientAsyncReaderWriterInterface< ::tt::ConverseRequest, ::tt::ConverseReply>*),
+        PrepareAsyncConverseRaw,
+        (::grpc::ClientContext* context, ::grpc::CompletionQueue* cq), (override));
     std::string ipAddressAndPort;
 };
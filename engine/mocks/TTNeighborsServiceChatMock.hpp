@@ -8,6 +8,9 @@ public:
     TTNeighborsServiceChatMock() : TTNeighborsServiceChat(mBroadcasterChat) {}
     MOCK_METHOD(grpc::Status, Tell, (grpc::ServerContext* context, const tt::TellRequest* request, tt::TellReply* reply), (override));
     MOCK_METHOD(grpc::Status, Narrate, (grpc::ServerContext* context, grpc::ServerReader<tt::NarrateRequest>* stream, tt::NarrateReply* reply), (override));
+    MOCK_METHOD(grpc::Status, Converse, (grpc::ServerContext* context, (grpc::ServerReaderWriter<tt::ConverseReply, tt::ConverseRequest>* stream)), (override));
+    MOCK_METHOD(grpc::Status, handleConverse, (grpc::ServerContext* context, const tt::ConverseRequest* request, std::string& identity, tt::ConverseReply* reply), (override));
+    MOCK_METHOD(grpc::Status, handleNarrate, (grpc::ServerContext* context, const TTNarrateRequest& message, tt::NarrateReply* reply), (override));
 private:
     TTBroadcasterChatMock mBroadcasterChat;
 };
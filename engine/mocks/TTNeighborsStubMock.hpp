@@ -6,8 +6,12 @@ class TTNeighborsStubMock : public TTNeighborsStub {
 public:
     MOCK_METHOD(TTUniqueChatStub, createChatStub, (const std::string& ipAddressAndPort), (const, override));
     MOCK_METHOD(TTUniqueDiscoveryStub, createDiscoveryStub, (const std::string& ipAddressAndPort), (const, override));
+    MOCK_METHOD(TTUniqueChatStream, createChatStream, (TTNeighborsChatStubIf& stub), (const, override));
     MOCK_METHOD(TTTellResponse, sendTell, (TTNeighborsChatStubIf& stub, const TTTellRequest& rhs), (const, override));
     MOCK_METHOD(TTNarrateResponse, sendNarrate, (TTNeighborsChatStubIf& stub, const TTNarrateRequest& rhs), (const, override));
+    MOCK_METHOD(TTConverseResponse, sendConverse, (TTNeighborsChatStream& stream, const TTConverseRequest& rhs), (const, override));
     MOCK_METHOD(TTGreetResponse, sendGreet, (TTNeighborsDiscoveryStubIf& stub, const TTGreetRequest& rhs), (const, override));
+    MOCK_METHOD(std::vector<TTGreetResponse>, sendGreets, (const std::vector<std::reference_wrapper<TTNeighborsDiscoveryStubIf>>& stubs, const TTGreetRequest& rhs), (const, override));
     MOCK_METHOD(TTHeartbeatResponse, sendHeartbeat, (TTNeighborsDiscoveryStubIf& stub, const TTHeartbeatRequest& rhs), (const, override));
+    MOCK_METHOD(std::vector<TTHeartbeatResponse>, sendHeartbeats, (const std::vector<std::reference_wrapper<TTNeighborsDiscoveryStubIf>>& stubs, const TTHeartbeatRequest& rhs), (const, override));
 };
@@ -7,6 +7,7 @@
 #include "TTChatHandler.hpp"
 #include "TTTextBoxHandler.hpp"
 #include "TTServer.hpp"
+#include "TTNeighborsBeacon.hpp"
 
 class TTAbstractFactory
 {
@@ -34,8 +35,9 @@ public:
 
     [[nodiscard]] virtual std::unique_ptr<TTTextBoxHandler> createTextBoxHandler(
             TTTextBoxCallbackMessageSent callbackMessageSent,
-            TTTextBoxCallbackContactSelect callbackContactsSelect) const {
-        return std::make_unique<TTTextBoxHandler>(mTextBoxSettings, callbackMessageSent, callbackContactsSelect);
+            TTTextBoxCallbackContactSelect callbackContactsSelect,
+            TTTextBoxCallbackChatPage callbackChatPage) const {
+        return std::make_unique<TTTextBoxHandler>(mTextBoxSettings, callbackMessageSent, callbackContactsSelect, callbackChatPage);
     }
 
     [[nodiscard]] virtual std::unique_ptr<TTNeighborsStub> createNeighborsStub() const {
@@ -46,17 +48,23 @@ public:
             TTContactsHandler& contactsHandler,
             TTChatHandler& chatHandler,
             TTNeighborsStub& neighborsStub,
-            TTNetworkInterface networkInterface) const {
-        return std::make_unique<TTBroadcasterChat>(contactsHandler, chatHandler, neighborsStub, networkInterface);
+            TTNeighborsLiveness& liveness,
+            TTNetworkInterface networkInterface,
+            const TTBroadcasterChatLimits& limits) const {
+        return std::make_unique<TTBroadcasterChat>(contactsHandler, chatHandler, neighborsStub, liveness, networkInterface, limits);
     }
 
     [[nodiscard]] virtual std::unique_ptr<TTBroadcasterDiscovery> createBroadcasterDiscovery(
             TTContactsHandler& contactsHandler,
             TTChatHandler& chatHandler,
             TTNeighborsStub& neighborsStub,
+            TTNeighborsLiveness& liveness,
             TTNetworkInterface networkInterface,
-            const std::deque<std::string>& neighbors) const {
-        return std::make_unique<TTBroadcasterDiscovery>(contactsHandler, chatHandler, neighborsStub, networkInterface, neighbors);
+            const std::deque<std::string>& neighbors,
+            const std::string& cachePath,
+            const TTNeighborsDetectorSettings& detectorSettings,
+            uint16_t heartbeatPort) const {
+        return std::make_unique<TTBroadcasterDiscovery>(contactsHandler, chatHandler, neighborsStub, liveness, networkInterface, neighbors, cachePath, detectorSettings, heartbeatPort);
     }
 
     [[nodiscard]] virtual std::unique_ptr<TTNeighborsServiceChat> createNeighborsServiceChat(
@@ -72,8 +80,16 @@ public:
     [[nodiscard]] virtual std::unique_ptr<TTServer> createServer(
             const std::string& ipAddressAndPort,
             TTNeighborsServiceChat& chat,
-            TTNeighborsServiceDiscovery& discovery) const {
-        return std::make_unique<TTServer>(ipAddressAndPort, chat, discovery);
+            TTNeighborsServiceDiscovery& discovery,
+            size_t threads) const {
+        return std::make_unique<TTServer>(ipAddressAndPort, chat, discovery, threads);
+    }
+
+    [[nodiscard]] virtual std::unique_ptr<TTNeighborsBeacon> createNeighborsBeacon(
+            const std::string& groupAddress,
+            TTNetworkInterface networkInterface,
+            TTBroadcasterDiscovery& discovery) const {
+        return std::make_unique<TTNeighborsBeacon>(groupAddress, networkInterface, discovery);
     }
 
 private:
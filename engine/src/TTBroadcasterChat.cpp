@@ -1,16 +1,37 @@
 #include "TTBroadcasterChat.hpp"
+#include "TTContactsKey.hpp"
 #include "TTDiagnosticsLogger.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include <random>
+#include <string_view>
+#include <vector>
+
+static uint64_t generateEpoch() {
+    std::random_device device;
+    return (static_cast<uint64_t>(device()) << 32) | device();
+}
 
 TTBroadcasterChat::TTBroadcasterChat(TTContactsHandler& contactsHandler,
                                      TTChatHandler& chatHandler,
                                      TTNeighborsStub& neighborsStub,
-                                     TTNetworkInterface networkInterface) :
+                                     TTNeighborsLiveness& liveness,
+                                     TTNetworkInterface networkInterface,
+                                     const TTBroadcasterChatLimits& limits) :
         mContactsHandler(contactsHandler),
         mChatHandler(chatHandler),
         mNeighborsStub(neighborsStub),
+        mLiveness(liveness),
         mNetworkInterface(networkInterface),
+        mInFlight{0},
+        mInFlightLimit{std::max<size_t>(limits.inFlight, 1)},
+        mLimits(limits),
+        mPendingBytes{0},
         mNeighborsFlag{false},
-        mInactivityTimerFactory(std::chrono::milliseconds(3000), std::chrono::milliseconds(6000)){
+        mEpoch(generateEpoch()),
+        mRetryTimerFactory(std::chrono::milliseconds(3000), std::chrono::milliseconds(6000)),
+        mExecutor(mInFlightLimit) {
     LOG_INFO("Successfully constructed!");
 }
 
@@ -23,44 +44,267 @@ TTBroadcasterChat::~TTBroadcasterChat() {
 void TTBroadcasterChat::run() {
     LOG_INFO("Started broadcasting chat");
     while (!isStopped()) {
-        mNeighborsFlag.store(false);
         std::unique_lock<std::mutex> lock(mNeighborsMutex);
-        const bool predicate = mNeighborsCondition.wait_for(lock, mInactivityTimerFactory.min(), [this]() {
-            return mNeighborsFlag.load() || isStopped();
-        });
-        for (auto &[id, neighbor] : mNeighbors) {
-            if (isStopped()) {
+        const auto predicate = [this]() {
+            return mNeighborsFlag.load() || !mOutgoing.empty() || isStopped();
+        };
+        // Sleep until the earliest flush deadline unless all workers are busy
+        auto wakeup = std::chrono::steady_clock::now() + std::chrono::milliseconds(NEIGHBORS_FLAG_TIMEOUT);
+        if (!mDeadlines.empty() && mInFlight < mInFlightLimit) {
+            wakeup = std::min(wakeup, mDeadlines.top().first);
+        }
+        mNeighborsCondition.wait_until(lock, wakeup, predicate);
+        mNeighborsFlag.store(false);
+        dispatch(mOutgoing.pop());
+        const auto now = std::chrono::steady_clock::now();
+        while (!isStopped() && !mDeadlines.empty() && mInFlight < mInFlightLimit) {
+            const auto [deadline, id] = mDeadlines.top();
+            if (deadline > now) {
                 break;
             }
-            if (!neighbor.timer.expired()) {
-                continue;
-            }
-            neighbor.timer.kick();
-            const auto neighborsEntry = mContactsHandler.get(id).value();
-            if (neighborsEntry.state.isInactive()) {
+            mDeadlines.pop();
+            auto& neighbor = mNeighbors.at(id);
+            neighbor.scheduled = false;
+            if (neighbor.pendingMessages.empty()) {
                 continue;
             }
-            if (!neighbor.stub) {
-                const auto ipAddressAndPort = neighborsEntry.ipAddressAndPort;
-                neighbor.stub = mNeighborsStub.createChatStub(ipAddressAndPort);
+            neighbor.inFlight = true;
+            neighbor.flushed = now;
+            ++mInFlight;
+            if (!mExecutor.submit(std::bind(&TTBroadcasterChat::deliver, this, id))) [[unlikely]] {
+                neighbor.inFlight = false;
+                --mInFlight;
+                break;
             }
-            if (!neighbor.stub) [[unlikely]] {
-                continue;
+        }
+    }
+    LOG_INFO("Stopped broadcasting chat");
+}
+
+void TTBroadcasterChat::onStop() {
+    mExecutor.stop();
+    {
+        std::scoped_lock lock(mNeighborsMutex);
+        // Unblocks workers waiting for acknowledgements
+        for (auto& [id, neighbor] : mNeighbors) {
+            if (neighbor.stream) {
+                neighbor.stream->cancel();
             }
-            if (neighbor.pendingMessages.size() > 1) {
-                const auto narrateRequest = TTNarrateRequest{getIdentity(), neighbor.pendingMessages};
-                if (mNeighborsStub.sendNarrate(*neighbor.stub, narrateRequest).status) {
-                    neighbor.pendingMessages.clear();
-                }
-            } else if (!neighbor.pendingMessages.empty()) {
-                const auto tellRequest = TTTellRequest{getIdentity(), neighbor.pendingMessages.back()};
-                if (mNeighborsStub.sendTell(*neighbor.stub, tellRequest).status) {
-                    neighbor.pendingMessages.clear();
-                }
+        }
+    }
+    mNeighborsCondition.notify_all();
+}
+
+void TTBroadcasterChat::dispatch(std::vector<Outgoing> outgoing) {
+    for (auto& [id, ipAddressAndPort, message] : outgoing) {
+        auto [it, inserted] = mNeighbors.try_emplace(id);
+        auto& neighbor = it->second;
+        if (inserted) {
+            // Creating stub does not connect, the worker retries if it failed
+            neighbor.stub = mNeighborsStub.createChatStub(ipAddressAndPort);
+            neighbor.timer = mRetryTimerFactory.create();
+        }
+        if (enqueue(id, neighbor, std::move(message))) {
+            schedule(id, neighbor);
+        }
+    }
+}
+
+bool TTBroadcasterChat::enqueue(size_t id, Neighbor& neighbor, std::string message) {
+    // Message over the global budget would never fit, nor could it be loaded back once spilled
+    if (message.size() > mLimits.globalBytes) {
+        LOG_WARNING("Message of neighbor id={} exceeds the global budget, message rejected!", id);
+        return false;
+    }
+    refill(neighbor);
+    // Spilled messages are older, order has to be kept
+    if (neighbor.spill && !neighbor.spill->empty()) {
+        return spill(id, neighbor, message);
+    }
+    while (!fits(neighbor, message.size())) {
+        if (mLimits.overflow == TTBroadcasterChatLimits::Overflow::SPILL) {
+            return spill(id, neighbor, message);
+        }
+        if (mLimits.overflow == TTBroadcasterChatLimits::Overflow::REJECT || !dropOldest(neighbor)) {
+            LOG_WARNING("Outgoing queue of neighbor id={} is full, message rejected!", id);
+            return false;
+        }
+        LOG_WARNING("Outgoing queue of neighbor id={} is full, oldest message dropped!", id);
+    }
+    neighbor.pendingBytes += message.size();
+    mPendingBytes += message.size();
+    neighbor.pendingMessages.push_back(Pending{++neighbor.sequence, std::move(message)});
+    return true;
+}
+
+bool TTBroadcasterChat::fits(const Neighbor& neighbor, size_t size) const {
+    if (mPendingBytes + size > mLimits.globalBytes) {
+        return false;
+    }
+    // Message larger than the neighbor budget is not stuck forever
+    return neighbor.pendingMessages.empty() || neighbor.pendingBytes + size <= mLimits.neighborBytes;
+}
+
+bool TTBroadcasterChat::dropOldest(Neighbor& neighbor) {
+    // Messages copied by the worker keep their place and sequence numbers
+    const auto position = neighbor.inFlight ? neighbor.sending : 0;
+    if (position >= neighbor.pendingMessages.size()) {
+        return false;
+    }
+    // Dropped message might have been sent already, following ones keep their numbers
+    const auto it = neighbor.pendingMessages.begin() + position;
+    neighbor.pendingBytes -= it->message.size();
+    mPendingBytes -= it->message.size();
+    neighbor.pendingMessages.erase(it);
+    return true;
+}
+
+bool TTBroadcasterChat::spill(size_t id, Neighbor& neighbor, const std::string& message) {
+    try {
+        if (!neighbor.spill) {
+            const auto directory = mLimits.spillDirectory.empty() ?
+                std::filesystem::temp_directory_path() : std::filesystem::path(mLimits.spillDirectory);
+            const auto filename = "tteams-spill-" + std::to_string(mEpoch) + "-" + std::to_string(id);
+            neighbor.spill = std::make_unique<TTUtilsSpillQueue>(directory / filename);
+        }
+        if (neighbor.spill->push(message)) [[likely]] {
+            return true;
+        }
+    } catch (...) {
+        LOG_ERROR("Exception occurred while creating spill file!");
+    }
+    LOG_WARNING("Failed to spill message of neighbor id={}, message rejected!", id);
+    return false;
+}
+
+void TTBroadcasterChat::refill(Neighbor& neighbor) {
+    while (neighbor.spill && !neighbor.spill->empty()) {
+        const auto size = neighbor.spill->peek();
+        if (!size || !fits(neighbor, size.value())) {
+            break;
+        }
+        auto message = neighbor.spill->pop();
+        if (!message) [[unlikely]] {
+            break;
+        }
+        neighbor.pendingBytes += message->size();
+        mPendingBytes += message->size();
+        neighbor.pendingMessages.push_back(Pending{++neighbor.sequence, std::move(message.value())});
+    }
+}
+
+void TTBroadcasterChat::schedule(size_t id, Neighbor& neighbor) {
+    if (neighbor.scheduled || neighbor.inFlight || neighbor.pendingMessages.empty()) {
+        return;
+    }
+    // Nagle-like, idle neighbor gets the message at once, follow-ups are held for the flush window
+    // (or until the previous delivery ends) and sent together, long interval is kept for retries
+    const auto now = std::chrono::steady_clock::now();
+    auto deadline = std::max(now, neighbor.flushed + mLimits.flushWindow);
+    if (neighbor.retrying) {
+        deadline = neighbor.timer.deadline();
+    } else if (neighbor.draining) {
+        deadline = now + DRAIN_INTERVAL;
+    }
+    mDeadlines.emplace(deadline, id);
+    neighbor.scheduled = true;
+}
+
+void TTBroadcasterChat::deliver(size_t id) {
+    Neighbor* neighbor = nullptr;
+    std::deque<std::string> messages;
+    uint64_t sequence = 0;
+    bool backlog = false;
+    {
+        std::scoped_lock lock(mNeighborsMutex);
+        neighbor = &mNeighbors.at(id);
+        // Backlog (e.g. after reactivation) is paced, it is not sent at once,
+        // batch ends at the gap left by dropped message as numbers of a request are consecutive
+        size_t bytes = 0;
+        sequence = neighbor->pendingMessages.empty() ? 0 : neighbor->pendingMessages.front().sequence;
+        for (const auto& [number, message] : neighbor->pendingMessages) {
+            if (!messages.empty() && (messages.size() == MAX_BATCH_MESSAGES || bytes + message.size() > MAX_BATCH_BYTES
+                    || number != sequence + messages.size())) {
+                break;
             }
+            bytes += message.size();
+            messages.push_back(message);
         }
+        neighbor->sending = messages.size();
+        backlog = (messages.size() < neighbor->pendingMessages.size()) || (neighbor->spill && !neighbor->spill->empty());
     }
-    LOG_INFO("Stopped broadcasting chat");
+    // New messages are only appended, delivered ones are always at the front,
+    // only unacknowledged suffix is sent again
+    const auto delivered = send(id, *neighbor, messages, sequence);
+    if (delivered) {
+        // Acknowledged messages prove liveness, discovery does not have to probe the neighbor
+        mLiveness.contact(id);
+    }
+    {
+        std::scoped_lock lock(mNeighborsMutex);
+        for (size_t i = 0; i < delivered; ++i) {
+            neighbor->pendingBytes -= neighbor->pendingMessages.front().message.size();
+            mPendingBytes -= neighbor->pendingMessages.front().message.size();
+            neighbor->pendingMessages.pop_front();
+        }
+        neighbor->sending = 0;
+        refill(*neighbor);
+        neighbor->retrying = (delivered < messages.size());
+        neighbor->draining = !neighbor->retrying && backlog && !neighbor->pendingMessages.empty();
+        if (neighbor->retrying) {
+            neighbor->timer.kick();
+        }
+        neighbor->inFlight = false;
+        --mInFlight;
+        schedule(id, *neighbor);
+        mNeighborsFlag.store(true);
+    }
+    mNeighborsCondition.notify_one();
+}
+
+size_t TTBroadcasterChat::send(size_t id, Neighbor& neighbor, const std::deque<std::string>& messages, uint64_t sequence) {
+    const auto contacts = mContactsHandler.snapshot();
+    const auto* neighborsEntry = contacts->get(id);
+    if (!neighborsEntry || neighborsEntry->state.isInactive()) {
+        return 0;
+    }
+    if (!neighbor.stub) {
+        neighbor.stub = mNeighborsStub.createChatStub(neighborsEntry->ipAddressAndPort);
+    }
+    if (!neighbor.stub) [[unlikely]] {
+        return 0;
+    }
+    // Prefer long-lived stream, fall back to tell or narrate if it cannot be used
+    size_t delivered = 0;
+    if (!neighbor.stream) {
+        auto stream = mNeighborsStub.createChatStream(*neighbor.stub);
+        std::scoped_lock lock(mNeighborsMutex);
+        neighbor.stream = std::move(stream);
+    }
+    if (neighbor.stream) {
+        const auto converseRequest = TTConverseRequest{getIdentity(), messages, mEpoch, sequence};
+        const auto converseResponse = mNeighborsStub.sendConverse(*neighbor.stream, converseRequest);
+        delivered = std::min(converseResponse.acknowledged, messages.size());
+        if (converseResponse.status) [[likely]] {
+            return delivered;
+        }
+        LOG_WARNING("Chat stream broken, falling back to tell/narrate!");
+        std::scoped_lock lock(mNeighborsMutex);
+        neighbor.stream.reset();
+    }
+    const auto remaining = std::deque<std::string>(messages.begin() + delivered, messages.end());
+    if (remaining.size() > 1) {
+        const auto narrateRequest = TTNarrateRequest{getIdentity(), remaining, mEpoch, sequence + delivered};
+        if (mNeighborsStub.sendNarrate(*neighbor.stub, narrateRequest).status) {
+            delivered = messages.size();
+        }
+    } else if (!remaining.empty()) {
+        const auto tellRequest = TTTellRequest{getIdentity(), remaining.back(), mEpoch, sequence + delivered};
+        if (mNeighborsStub.sendTell(*neighbor.stub, tellRequest).status) {
+            delivered = messages.size();
+        }
+    }
+    return delivered;
 }
 
 bool TTBroadcasterChat::handleSend(const std::string& message) {
@@ -104,46 +348,42 @@ bool TTBroadcasterChat::handleSend(const std::string& message) {
         LOG_INFO("Success, nothing to be send (host IP address match)!");
         return true;
     }
-    std::scoped_lock lock(mNeighborsMutex);
-    auto lb = mNeighbors.lower_bound(contactsCurrentId);
-    if(lb != mNeighbors.end() && !(mNeighbors.key_comp()(contactsCurrentId, lb->first)))
+    // Network I/O is done by the broadcaster, sender never waits for it, flag is set under the lock
+    // so that the wakeup is not lost between the predicate check and the wait of the loop
+    mOutgoing.push(Outgoing{contactsCurrentId, requestedIpAddress, message});
     {
-        lb->second.pendingMessages.push_back(message);
-        LOG_INFO("Success, neighbor already in the map, inserted new message!");
+        std::scoped_lock lock(mNeighborsMutex);
+        mNeighborsFlag.store(true);
     }
-    else
-    {
-        auto newNeighbor = std::pair{contactsCurrentId, Neighbor{}};
-        newNeighbor.second.stub = mNeighborsStub.createChatStub(requestedIpAddress);
-        newNeighbor.second.timer = mInactivityTimerFactory.create();
-        newNeighbor.second.timer.expire();
-        newNeighbor.second.pendingMessages.push_back(message);
-        mNeighbors.insert(lb, std::move(newNeighbor));
-        LOG_INFO("Success, inserted new neighbor to the map, inserted new message!");
-    }
-    mNeighborsFlag.store(true);
     mNeighborsCondition.notify_one();
+    LOG_INFO("Success, queued new message!");
     return true;
 }
 
 bool TTBroadcasterChat::handleReceive(const TTTellRequest& request) {
     LOG_INFO("Handing reception of tell request...");
-    const auto id = mContactsHandler.get(request.identity);
+    const auto contacts = mContactsHandler.snapshot();
+    const auto id = contacts->get(request.identity);
     if (!id) {
-        LOG_WARNING("Failed to handle reception, no such identity={}", request.identity);
+        LOG_WARNING("Failed to handle reception, no such identity={}", TTContactsKey::print(request.identity));
         return false;
     }
-    const auto contactsCurrentEntryOpt = mContactsHandler.get(id.value());
-    if (!contactsCurrentEntryOpt) [[unlikely]] {
+    const auto* contactsEntry = contacts->get(id.value());
+    if (!contactsEntry) [[unlikely]] {
         LOG_ERROR("Failed to handle send (contacts handler get failure)!");
         stop();
         return false;
     }
-    const auto requestedIpAddress = contactsCurrentEntryOpt.value().ipAddressAndPort;
+    const auto& requestedIpAddress = contactsEntry->ipAddressAndPort;
     if (requestedIpAddress == mNetworkInterface.getIpAddressAndPort()) {
         LOG_INFO("Success, nothing to be send (host IP address match)!");
         return true;
     }
+    mLiveness.contact(id.value());
+    if (!accept(id.value(), request.epoch, request.sequence)) {
+        LOG_INFO("Success, ignoring duplicate message sequence={}!", request.sequence);
+        return true;
+    }
     if (!mContactsHandler.receive(id.value())) [[unlikely]] {
         LOG_ERROR("Failed to handle reception on contacts receive");
         stop();
@@ -160,44 +400,86 @@ bool TTBroadcasterChat::handleReceive(const TTTellRequest& request) {
 
 bool TTBroadcasterChat::handleReceive(const TTNarrateRequest& request) {
     LOG_INFO("Handing reception of narrate request...");
-    const auto id = mContactsHandler.get(request.identity);
+    const auto contacts = mContactsHandler.snapshot();
+    const auto id = contacts->get(request.identity);
     if (!id) {
-        LOG_WARNING("Failed to handle reception, no such identity={}", request.identity);
+        LOG_WARNING("Failed to handle reception, no such identity={}", TTContactsKey::print(request.identity));
         return false;
     }
-    const auto contactsCurrentEntryOpt = mContactsHandler.get(id.value());
-    if (!contactsCurrentEntryOpt) [[unlikely]] {
+    const auto* contactsEntry = contacts->get(id.value());
+    if (!contactsEntry) [[unlikely]] {
         LOG_ERROR("Failed to handle send (contacts handler get failure)!");
         stop();
         return false;
     }
-    const auto requestedIpAddress = contactsCurrentEntryOpt.value().ipAddressAndPort;
+    const auto& requestedIpAddress = contactsEntry->ipAddressAndPort;
     if (requestedIpAddress == mNetworkInterface.getIpAddressAndPort()) {
         LOG_INFO("Success, nothing to be send (host IP address match)!");
         return true;
     }
-    if (!mContactsHandler.receive(id.value())) {
+    mLiveness.contact(id.value());
+    // Messages which arrived before the sender noticed failure are retransmitted
+    std::vector<std::string_view> messages;
+    messages.reserve(request.messages.size());
+    for (size_t i = 0; i < request.messages.size(); ++i) {
+        if (accept(id.value(), request.epoch, request.sequence ? request.sequence + i : 0)) {
+            messages.emplace_back(request.messages[i]);
+        }
+    }
+    if (messages.empty()) {
+        LOG_INFO("Success, ignoring duplicate messages sequence={}!", request.sequence);
+        return true;
+    }
+    // Whole batch is stored and forwarded at once
+    if (!mContactsHandler.receiveMany(id.value(), messages.size())) {
         LOG_ERROR("Failed to handle reception on contacts receive");
         stop();
         return false;
     }
-    for (const auto &message : request.messages) {
-        if (!mChatHandler.receive(id.value(), message, std::chrono::system_clock::now())) {
-            LOG_ERROR("Failed to handle reception on chat receive");
-            stop();
-            return false;
-        }
+    if (!mChatHandler.receiveMany(id.value(), messages, std::chrono::system_clock::now())) {
+        LOG_ERROR("Failed to handle reception on chat receive");
+        stop();
+        return false;
     }
     LOG_INFO("Successfully handled reception!");
     return true;
 }
 
+bool TTBroadcasterChat::accept(size_t id, uint64_t epoch, uint64_t sequence) {
+    if (!sequence) {
+        return true;
+    }
+    std::scoped_lock lock(mReceivedMutex);
+    auto& received = mReceived[id];
+    // Sender restarted, numbering starts over
+    if (received.epoch != epoch) {
+        received = Received{epoch, 0};
+    }
+    if (sequence <= received.sequence) {
+        return false;
+    }
+    received.sequence = sequence;
+    return true;
+}
+
 std::string TTBroadcasterChat::getIdentity() {
-    auto opt = mContactsHandler.get(0);
-    if (opt == std::nullopt) {
+    const auto hostEntry = getHostEntry();
+    if (!hostEntry) {
         LOG_ERROR("Failed to get identity!");
         stop();
         return {};
     }
-    return opt->identity;
+    return hostEntry->identity;
+}
+
+std::shared_ptr<const TTContactsHandlerEntry> TTBroadcasterChat::getHostEntry() {
+    // Nickname, identity and address of the host never change, so contacts are asked only once
+    auto hostEntry = mHostEntry.load();
+    if (!hostEntry) {
+        if (auto entryOpt = mContactsHandler.get(0); entryOpt) {
+            hostEntry = std::make_shared<const TTContactsHandlerEntry>(std::move(entryOpt.value()));
+            mHostEntry.store(hostEntry);
+        }
+    }
+    return hostEntry;
 }
@@ -3,15 +3,49 @@
 #include "TTChatHandler.hpp"
 #include "TTNetworkInterface.hpp"
 #include "TTNeighborsStub.hpp"
+#include "TTNeighborsLiveness.hpp"
 #include "TTUtilsTimerFactory.hpp"
 #include "TTUtilsStopable.hpp"
+#include "TTUtilsExecutor.hpp"
+#include "TTUtilsMpscQueue.hpp"
+#include "TTUtilsSpillQueue.hpp"
+#include <queue>
+
+// Budget and pacing of outgoing messages kept in memory until delivered
+struct TTBroadcasterChatLimits final {
+    enum class Overflow {
+        // New message is not queued
+        REJECT,
+        // Oldest message of the neighbor, which is not being delivered, is dropped
+        DROP_OLDEST,
+        // New message is written to the spill file and loaded back once there is room
+        SPILL
+    };
+    size_t neighborBytes = DEFAULT_NEIGHBOR_BYTES;
+    size_t globalBytes = DEFAULT_GLOBAL_BYTES;
+    Overflow overflow = Overflow::DROP_OLDEST;
+    // Directory of spill files, temporary directory if empty
+    std::string spillDirectory;
+    // Follow-ups sent shortly after a delivery are held for this long, so that they are coalesced
+    std::chrono::milliseconds flushWindow = DEFAULT_FLUSH_WINDOW;
+    // Neighbors delivered to concurrently, each delivery occupies one worker
+    size_t inFlight = DEFAULT_IN_FLIGHT;
+    static inline constexpr size_t DEFAULT_NEIGHBOR_BYTES = 1 << 20;
+    static inline constexpr size_t DEFAULT_GLOBAL_BYTES = 16 << 20;
+    static inline constexpr std::chrono::milliseconds DEFAULT_FLUSH_WINDOW{10};
+    static inline constexpr std::chrono::milliseconds MAX_FLUSH_WINDOW{1000};
+    static inline constexpr size_t DEFAULT_IN_FLIGHT = 4;
+    static inline constexpr size_t MAX_IN_FLIGHT = 64;
+};
 
 class TTBroadcasterChat : public TTUtilsStopable {
 public:
     TTBroadcasterChat(TTContactsHandler& contactsHandler,
                       TTChatHandler& chatHandler,
                       TTNeighborsStub& neighborsStub,
-                      TTNetworkInterface networkInterface);
+                      TTNeighborsLiveness& liveness,
+                      TTNetworkInterface networkInterface,
+                      const TTBroadcasterChatLimits& limits = TTBroadcasterChatLimits());
     virtual ~TTBroadcasterChat();
     TTBroadcasterChat(const TTBroadcasterChat&) = delete;
     TTBroadcasterChat(TTBroadcasterChat&&) = delete;
@@ -27,26 +61,107 @@ public:
     virtual bool handleReceive(const TTNarrateRequest& request);
     // Returns root nickname
     [[nodiscard]] virtual std::string getIdentity();
+protected:
+    virtual void onStop() override;
 private:
+    // Message numbered once queued, so that it keeps its number until delivered or dropped
+    struct Pending {
+        uint64_t sequence;
+        std::string message;
+    };
     struct Neighbor {
         Neighbor() = default;
         ~Neighbor() = default;
-        Neighbor(const Neighbor&) = default;
+        Neighbor(const Neighbor&) = delete;
         Neighbor(Neighbor&&) = default;
-        Neighbor& operator=(const Neighbor&) = default;
+        Neighbor& operator=(const Neighbor&) = delete;
         Neighbor& operator=(Neighbor&&) = default;
         TTUniqueChatStub stub;
+        // Stream has to be destroyed before the stub
+        TTUniqueChatStream stream;
+        // Retry interval after failed delivery
         TTUtilsTimer timer;
-        std::deque<std::string> pendingMessages;
+        // Start of the last delivery
+        std::chrono::steady_clock::time_point flushed;
+        std::deque<Pending> pendingMessages;
+        size_t pendingBytes = 0;
+        // Messages over the budget (spill policy), they always follow pending messages
+        std::unique_ptr<TTUtilsSpillQueue> spill;
+        // Sequence number of the last queued message, numbers of dropped messages are not reused
+        uint64_t sequence = 0;
+        // Number of pending messages copied by the worker
+        size_t sending = 0;
+        // Flush deadline is queued
+        bool scheduled = false;
+        // Delivery is executed by the worker
+        bool inFlight = false;
+        // Backlog is being sent in batches
+        bool draining = false;
+        // Last delivery failed
+        bool retrying = false;
+    };
+    // Message handed over by the send path
+    struct Outgoing {
+        size_t id;
+        std::string ipAddressAndPort;
+        std::string message;
+    };
+    // Last message received from the neighbor
+    struct Received {
+        uint64_t epoch = 0;
+        uint64_t sequence = 0;
     };
+    using Deadline = std::pair<std::chrono::steady_clock::time_point, size_t>;
+    // Moves outgoing messages to neighbors (thread-unsafe)
+    void dispatch(std::vector<Outgoing> outgoing);
+    // Queues message within the budget, applies overflow policy otherwise (thread-unsafe)
+    bool enqueue(size_t id, Neighbor& neighbor, std::string message);
+    // Returns true if message fits the budget, neighbor with empty queue accepts message over its own budget,
+    // but not over the global one (thread-unsafe)
+    [[nodiscard]] bool fits(const Neighbor& neighbor, size_t size) const;
+    // Drops oldest message which is not being delivered (thread-unsafe)
+    bool dropOldest(Neighbor& neighbor);
+    // Writes message to the spill file of the neighbor (thread-unsafe)
+    bool spill(size_t id, Neighbor& neighbor, const std::string& message);
+    // Loads spilled messages back while they fit the budget (thread-unsafe)
+    void refill(Neighbor& neighbor);
+    // Queues flush deadline of the neighbor (thread-unsafe)
+    void schedule(size_t id, Neighbor& neighbor);
+    // Delivers pending messages of the neighbor (executed by the worker)
+    void deliver(size_t id);
+    // Returns number of delivered messages
+    size_t send(size_t id, Neighbor& neighbor, const std::deque<std::string>& messages, uint64_t sequence);
+    // Returns false if the message was already received (retransmission), unsequenced messages are always accepted
+    bool accept(size_t id, uint64_t epoch, uint64_t sequence);
+    // Returns entry of the host, cached once known
+    std::shared_ptr<const TTContactsHandlerEntry> getHostEntry();
     TTContactsHandler& mContactsHandler;
     TTChatHandler& mChatHandler;
     TTNeighborsStub& mNeighborsStub;
+    TTNeighborsLiveness& mLiveness;
     TTNetworkInterface mNetworkInterface;
+    std::atomic<std::shared_ptr<const TTContactsHandlerEntry>> mHostEntry;
     std::mutex mNeighborsMutex;
     std::condition_variable mNeighborsCondition;
     std::map<size_t, Neighbor> mNeighbors;
+    TTUtilsMpscQueue<Outgoing> mOutgoing;
+    std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> mDeadlines;
+    size_t mInFlight;
+    const size_t mInFlightLimit;
+    const TTBroadcasterChatLimits mLimits;
+    // Bytes of pending messages of all neighbors
+    size_t mPendingBytes;
     std::atomic<bool> mNeighborsFlag;
+    // Identifies this session, so that receivers do not mistake restarted sequence numbers for duplicates
+    const uint64_t mEpoch;
+    std::mutex mReceivedMutex;
+    std::map<size_t, Received> mReceived;
     static inline const size_t NEIGHBORS_FLAG_TIMEOUT{500};
-    TTUtilsTimerFactory mInactivityTimerFactory;
+    // Backlog is sent in bounded batches, one batch per interval
+    static inline constexpr size_t MAX_BATCH_MESSAGES{64};
+    static inline constexpr size_t MAX_BATCH_BYTES{64 * 1024};
+    static inline constexpr std::chrono::milliseconds DRAIN_INTERVAL{100};
+    TTUtilsTimerFactory mRetryTimerFactory;
+    // Workers have to be joined before neighbors are destroyed
+    TTUtilsExecutor mExecutor;
 };
@@ -1,22 +1,55 @@
 #include "TTBroadcasterDiscovery.hpp"
+#include "TTContactsKey.hpp"
 #include "TTDiagnosticsLogger.hpp"
+#include <algorithm>
+#include <set>
 
 TTBroadcasterDiscovery::TTBroadcasterDiscovery(TTContactsHandler& contactsHandler,
                                                TTChatHandler& chatHandler,
                                                TTNeighborsStub& neighborsStub,
+                                               TTNeighborsLiveness& liveness,
                                                TTNetworkInterface networkInterface,
-                                               const std::deque<std::string>& neighbors) :
+                                               const std::deque<std::string>& neighbors,
+                                               const std::string& cachePath,
+                                               const TTNeighborsDetectorSettings& detectorSettings,
+                                               uint16_t heartbeatPort) :
         mContactsHandler(contactsHandler),
         mChatHandler(chatHandler),
         mNeighborsStub(neighborsStub),
+        mLiveness(liveness),
         mNetworkInterface(networkInterface),
-        mInactivityTimerFactory(std::chrono::milliseconds(5000), std::chrono::milliseconds(6000)),
-        mDiscoveryTimerFactory(std::chrono::milliseconds(100), std::chrono::milliseconds(1000)) {
+        mDetector(detectorSettings),
+        mDiscoveryTimerFactory(std::chrono::milliseconds(100), std::chrono::milliseconds(1000)),
+        mProbes(MAX_PROBES) {
+    std::deque<std::string> subnets;
     for (const auto &neighbor : neighbors) {
+        if (TTNeighborsSweep::isSubnet(neighbor)) {
+            subnets.push_back(neighbor);
+            continue;
+        }
         LOG_INFO("Creating static neighbor from IP address={}", neighbor);
         mStaticNeighbors.emplace_back(mDiscoveryTimerFactory.create(), neighbor + ":" + networkInterface.getPort());
         mStaticNeighbors.back().timer.expire();
     }
+    if (!subnets.empty()) {
+        mSweep = std::make_unique<TTNeighborsSweep>(subnets, networkInterface.getPort(), networkInterface.getIpAddress());
+    }
+    if (!cachePath.empty()) {
+        // Cache only speeds discovery up, so it is not fatal when it cannot be used
+        try {
+            mCache = std::make_unique<TTNeighborsCache>(cachePath);
+        } catch (const std::runtime_error& error) {
+            LOG_ERROR("Failed to create neighbors cache, reason={}", error.what());
+        }
+    }
+    if (heartbeatPort) {
+        // Heartbeats fall back to gRPC, so it is not fatal when UDP cannot be used
+        try {
+            mPulse = std::make_unique<TTNeighborsPulse>(networkInterface.getIpAddress(), heartbeatPort, getIdentity(), mLiveness);
+        } catch (const std::runtime_error& error) {
+            LOG_ERROR("Failed to create neighbors pulse, reason={}", error.what());
+        }
+    }
     LOG_INFO("Successfully constructed!");
 }
 
@@ -30,15 +63,41 @@ void TTBroadcasterDiscovery::run() {
     LOG_INFO("Started broadcasting discovery");
     auto staticNeighborsResult = std::async(std::launch::async, std::bind(&TTBroadcasterDiscovery::resolveStaticNeighbors, this));
     auto dynamicNeighborsResult = std::async(std::launch::async, std::bind(&TTBroadcasterDiscovery::resolveDynamicNeighbors, this));
+    std::future<void> subnetNeighborsResult;
+    if (mSweep) {
+        subnetNeighborsResult = std::async(std::launch::async, std::bind(&TTBroadcasterDiscovery::resolveSubnetNeighbors, this));
+    }
+    std::future<void> pulseResult;
+    if (mPulse) {
+        pulseResult = std::async(std::launch::async, std::bind(&TTNeighborsPulse::run, mPulse.get()));
+    }
     if (staticNeighborsResult.valid()) {
         staticNeighborsResult.wait();
     }
     if (dynamicNeighborsResult.valid()) {
         dynamicNeighborsResult.wait();
     }
+    if (subnetNeighborsResult.valid()) {
+        subnetNeighborsResult.wait();
+    }
+    if (pulseResult.valid()) {
+        pulseResult.wait();
+    }
     LOG_INFO("Stopped broadcasting discovery");
 }
 
+void TTBroadcasterDiscovery::onStop() {
+    {
+        // Resolvers check the stop flag under the lock, so the notification is not lost
+        std::scoped_lock lock(mStopMutex);
+    }
+    mStopCondition.notify_all();
+    mProbes.stop();
+    if (mPulse) {
+        mPulse->stop();
+    }
+}
+
 bool TTBroadcasterDiscovery::handleGreet(const TTGreetRequest& request) {
     LOG_INFO("Handling greet, new contact id={}", request.identity);
     return addNeighbor(request.nickname, request.identity, request.ipAddressAndPort, nullptr);
@@ -47,148 +106,494 @@ bool TTBroadcasterDiscovery::handleGreet(const TTGreetRequest& request) {
 bool TTBroadcasterDiscovery::handleHeartbeat(const TTHeartbeatRequest& request) {
     decltype(auto) id = mContactsHandler.get(request.identity);
     if (id == std::nullopt) {
-        LOG_WARNING("Handling heartbeat, ignoring not existing contact id={}", request.identity);
+        LOG_WARNING("Handling heartbeat, ignoring not existing contact id={}", TTContactsKey::print(request.identity));
         return false;
     }
-    LOG_INFO("Handling heartbeat, existing contact id={}", request.identity);
+    LOG_INFO("Handling heartbeat, existing contact id={}", TTContactsKey::print(request.identity));
     if (!mContactsHandler.activate(id.value())) [[unlikely]] {
         LOG_ERROR("Handle heartbeat error (failed to activate)...");
         stop();
         return false;
     }
-    return true;
+    {
+        // Heartbeat of the sender proves it is alive as well as its reply would
+        std::scoped_lock neighborLock(mNeighborMutex);
+        if (mDynamicNeighbors.contains(id.value())) {
+            heartbeat(id.value(), std::chrono::steady_clock::now());
+        }
+    }
+    if (!applyMemberUpdates(request.updates)) [[unlikely]] {
+        return false;
+    }
+    // Target is packed key if it was received from the network
+    if (request.target.empty() || TTContactsKey::same(request.target, getIdentity())) {
+        return true;
+    }
+    // Indirect probe, sender cannot reach the target itself
+    LOG_INFO("Handling heartbeat, probing target id={} on behalf of sender", TTContactsKey::print(request.target));
+    const auto targetId = mContactsHandler.get(request.target);
+    if (!targetId) {
+        LOG_WARNING("Handling heartbeat, no such target id={}", TTContactsKey::print(request.target));
+        return false;
+    }
+    TTNeighborsDiscoveryStubIf* stub = nullptr;
+    std::deque<TTMemberUpdate> updates;
+    {
+        std::scoped_lock neighborLock(mNeighborMutex);
+        stub = getDynamicNeighborStub(targetId.value());
+        updates = mMembership.updates();
+    }
+    if (!stub) {
+        return false;
+    }
+    const auto responses = mNeighborsStub.sendHeartbeats({*stub}, TTHeartbeatRequest{getIdentity(), updates});
+    return !responses.empty() && responses.front().status && !responses.front().identity.empty();
+}
+
+bool TTBroadcasterDiscovery::handleBeacon(const TTBeaconRequest& request) {
+    if (request.identity == getIdentity()) {
+        return true;
+    }
+    LOG_INFO("Handling beacon, contact id={}", request.identity);
+    return addNeighbor(request.nickname, request.identity, request.ipAddressAndPort, nullptr);
+}
+
+std::deque<TTMemberUpdate> TTBroadcasterDiscovery::getMemberUpdates() {
+    std::scoped_lock neighborLock(mNeighborMutex);
+    return mMembership.updates();
+}
+
+std::deque<TTPeer> TTBroadcasterDiscovery::getPeers() {
+    std::scoped_lock neighborLock(mNeighborMutex);
+    std::deque<TTPeer> peers;
+    const auto contacts = mContactsHandler.snapshot();
+    for (const auto id : mMembership.sample(MAX_PEERS)) {
+        if (const auto* entry = contacts->get(id); entry) {
+            peers.emplace_back(entry->nickname, entry->identity, entry->ipAddressAndPort);
+        }
+    }
+    return peers;
 }
 
 std::string TTBroadcasterDiscovery::getNickname() {
-    auto opt = mContactsHandler.get(0);
-    if (opt == std::nullopt) [[unlikely]] {
+    const auto hostEntry = getHostEntry();
+    if (!hostEntry) [[unlikely]] {
         LOG_ERROR("Failed to get nickname!");
         stop();
         return {};
     }
-    return opt->nickname;
+    return hostEntry->nickname;
 }
 
 std::string TTBroadcasterDiscovery::getIdentity() {
-    auto opt = mContactsHandler.get(0);
-    if (opt == std::nullopt) [[unlikely]] {
+    const auto hostEntry = getHostEntry();
+    if (!hostEntry) [[unlikely]] {
         LOG_ERROR("Failed to get identity!");
         stop();
         return {};
     }
-    return opt->identity;
+    return hostEntry->identity;
 }
 
 std::string TTBroadcasterDiscovery::getIpAddressAndPort() {
-    auto opt = mContactsHandler.get(0);
-    if (opt == std::nullopt) [[unlikely]] {
+    const auto hostEntry = getHostEntry();
+    if (!hostEntry) [[unlikely]] {
         LOG_ERROR("Failed to get IP address and port!");
         stop();
         return {};
     }
-    return opt->ipAddressAndPort;
+    return hostEntry->ipAddressAndPort;
+}
+
+std::shared_ptr<const TTContactsHandlerEntry> TTBroadcasterDiscovery::getHostEntry() {
+    // Nickname, identity and address of the host never change, so contacts are asked only once
+    auto hostEntry = mHostEntry.load();
+    if (!hostEntry) {
+        if (auto entryOpt = mContactsHandler.get(0); entryOpt) {
+            hostEntry = std::make_shared<const TTContactsHandlerEntry>(std::move(entryOpt.value()));
+            mHostEntry.store(hostEntry);
+        }
+    }
+    return hostEntry;
+}
+
+std::vector<std::string> TTBroadcasterDiscovery::resolveCachedNeighbors() {
+    std::vector<std::string> ipAddressesAndPorts;
+    {
+        std::scoped_lock neighborLock(mNeighborMutex);
+        if (!mCache) {
+            return {};
+        }
+        for (const auto& entry : mCache->load()) {
+            if (entry.ipAddressAndPort != mNetworkInterface.getIpAddressAndPort()) {
+                ipAddressesAndPorts.push_back(entry.ipAddressAndPort);
+            }
+        }
+    }
+    if (ipAddressesAndPorts.empty()) {
+        return {};
+    }
+    LOG_INFO("Started resolving cached neighbors={}", ipAddressesAndPorts.size());
+    // Chunks are greeted in order, so the most recently seen neighbors are greeted first
+    const auto added = greetNeighbors(ipAddressesAndPorts);
+    std::vector<std::string> resolved;
+    for (size_t i = 0; i < ipAddressesAndPorts.size(); ++i) {
+        if (added[i]) {
+            resolved.push_back(ipAddressesAndPorts[i]);
+        }
+    }
+    LOG_INFO("Stopped resolving cached neighbors, resolved={}", resolved.size());
+    return resolved;
 }
 
 void TTBroadcasterDiscovery::resolveStaticNeighbors() {
+    // Static neighbors already resolved from cache are not greeted again
+    const auto resolved = resolveCachedNeighbors();
+    for (auto& neighbor : mStaticNeighbors) {
+        if (std::find(resolved.begin(), resolved.end(), neighbor.ipAddressAndPort) != resolved.end()) {
+            neighbor.trials = 0;
+        }
+    }
     LOG_INFO("Started resolving static neighbors");
-    do {
-        auto smallest = mDiscoveryTimerFactory.max();
-        bool resolved = true;
+    while (!isStopped()) {
+        const auto now = std::chrono::steady_clock::now();
+        auto wakeup = std::chrono::steady_clock::time_point::max();
+        std::vector<std::reference_wrapper<StaticNeighbor>> due;
+        std::vector<std::string> ipAddressesAndPorts;
         for (auto& neighbor : mStaticNeighbors) {
-            if (isStopped()) {
-                break;
+            if (neighbor.trials == 0) {
+                continue;
             }
-            if (neighbor.trials > 0) {
-                resolved = false;
-                if (neighbor.timer.expired()) {
-                    --neighbor.trials;
-                    auto stub = mNeighborsStub.createDiscoveryStub(neighbor.ipAddressAndPort);
-                    if (stub) {
-                        auto greetRequest = TTGreetRequest{getNickname(), getIdentity(), getIpAddressAndPort()};
-                        auto greetResponse = mNeighborsStub.sendGreet(*stub, greetRequest);
-                        if (greetResponse.status) {
-                            if (addNeighbor(greetResponse.nickname, greetResponse.identity, greetResponse.ipAddressAndPort, std::move(stub))) {
-                                neighbor.trials = 0;
-                            }
-                        }
-                    }
-                    neighbor.timer.kick();
-                } else {
-                    const auto remaining = neighbor.timer.remaining();
-                    if (remaining < smallest) {
-                        smallest = remaining;
-                    }
-                }
+            if (neighbor.timer.deadline() <= now) {
+                due.emplace_back(neighbor);
+                ipAddressesAndPorts.push_back(neighbor.ipAddressAndPort);
+            } else {
+                wakeup = std::min(wakeup, neighbor.timer.deadline());
             }
         }
-        if (resolved) {
+        if (due.empty() && wakeup == std::chrono::steady_clock::time_point::max()) {
             break;
         }
-    } while (!isStopped());
+        if (due.empty()) {
+            std::unique_lock<std::mutex> lock(mStopMutex);
+            mStopCondition.wait_until(lock, wakeup, [this]() { return isStopped(); });
+            continue;
+        }
+        const auto added = greetNeighbors(ipAddressesAndPorts);
+        for (size_t i = 0; i < due.size(); ++i) {
+            auto& neighbor = due[i].get();
+            // Next attempt is counted from the end of this round
+            neighbor.trials = added[i] ? 0 : neighbor.trials - 1;
+            neighbor.timer.kick();
+        }
+    }
     LOG_INFO("Stopped resolving static neighbors");
 }
 
+void TTBroadcasterDiscovery::resolveSubnetNeighbors() {
+    LOG_INFO("Started resolving subnet neighbors");
+    while (!isStopped() && mSweep->size()) {
+        const auto reachable = mSweep->sweep([this]() { return isStopped(); });
+        const auto added = greetNeighbors(reachable);
+        for (size_t i = 0; i < reachable.size(); ++i) {
+            if (added[i]) {
+                mSweep->resolve(reachable[i]);
+            } else {
+                mSweep->backoff(reachable[i]);
+            }
+        }
+        std::unique_lock<std::mutex> lock(mStopMutex);
+        mStopCondition.wait_until(lock, mSweep->deadline(), [this]() { return isStopped(); });
+    }
+    LOG_INFO("Stopped resolving subnet neighbors");
+}
+
+std::vector<bool> TTBroadcasterDiscovery::greetNeighbors(const std::vector<std::string>& ipAddressesAndPorts) {
+    const auto added = greetRound(ipAddressesAndPorts);
+    // Each round greets peers known to neighbors greeted in the previous one, so the mesh converges in O(log N) rounds,
+    // each address is greeted once, so unreachable peers advertised again and again are not looped over
+    std::set<std::string> greeted(ipAddressesAndPorts.begin(), ipAddressesAndPorts.end());
+    while (!isStopped()) {
+        std::vector<std::string> exchanged;
+        {
+            std::scoped_lock neighborLock(mNeighborMutex);
+            for (const auto& ipAddressAndPort : mExchangedNeighbors) {
+                if (greeted.insert(ipAddressAndPort).second) {
+                    exchanged.push_back(ipAddressAndPort);
+                }
+            }
+            mExchangedNeighbors.clear();
+        }
+        if (exchanged.empty()) {
+            break;
+        }
+        LOG_INFO("Greeting peers learned from greet replies={}", exchanged.size());
+        greetRound(exchanged);
+    }
+    return added;
+}
+
+std::vector<bool> TTBroadcasterDiscovery::greetRound(const std::vector<std::string>& ipAddressesAndPorts) {
+    std::vector<bool> added(ipAddressesAndPorts.size(), false);
+    for (size_t offset = 0; offset < ipAddressesAndPorts.size() && !isStopped(); offset += MAX_GREET_FAN_OUT) {
+        const auto end = std::min(offset + MAX_GREET_FAN_OUT, ipAddressesAndPorts.size());
+        std::vector<size_t> greeted;
+        std::vector<TTUniqueDiscoveryStub> stubs;
+        std::vector<std::reference_wrapper<TTNeighborsDiscoveryStubIf>> stubReferences;
+        for (size_t i = offset; i < end; ++i) {
+            auto stub = mNeighborsStub.createDiscoveryStub(ipAddressesAndPorts[i]);
+            if (!stub) {
+                continue;
+            }
+            stubReferences.emplace_back(*stub);
+            stubs.push_back(std::move(stub));
+            greeted.push_back(i);
+        }
+        if (greeted.empty()) {
+            continue;
+        }
+        const auto greetRequest = TTGreetRequest{getNickname(), getIdentity(), getIpAddressAndPort()};
+        const auto greetResponses = mNeighborsStub.sendGreets(stubReferences, greetRequest);
+        for (size_t i = 0; i < greeted.size() && i < greetResponses.size(); ++i) {
+            const auto& greetResponse = greetResponses[i];
+            if (greetResponse.status) {
+                added[greeted[i]] = addNeighbor(greetResponse.nickname, greetResponse.identity, greetResponse.ipAddressAndPort,
+                    std::move(stubs[i]), greetResponse.peers);
+            }
+        }
+    }
+    return added;
+}
+
 void TTBroadcasterDiscovery::resolveDynamicNeighbors() {
     LOG_INFO("Started resolving dynamic neighbors");
     while (!isStopped()) {
-        auto smallest = mInactivityTimerFactory.max();
+        const auto start = std::chrono::steady_clock::now();
+        observeDynamicNeighbors();
+        probeDynamicNeighbor();
+        suspectDynamicNeighbors();
+        auto wakeup = std::chrono::steady_clock::now() + SUSPECT_INTERVAL;
+        {
+            // Next probe is not sent before the next period
+            std::shared_lock neighborLock(mNeighborMutex);
+            wakeup = std::min(wakeup, std::max(mDetector.deadline(), start + PROBE_PERIOD));
+        }
+        std::unique_lock<std::mutex> lock(mStopMutex);
+        mStopCondition.wait_until(lock, wakeup, [this]() { return isStopped(); });
+    }
+    // Probes in flight are completed, so the run does not return while they still use the neighbors
+    mProbes.join();
+    LOG_INFO("Stopped resolving dynamic neighbors");
+}
+
+void TTBroadcasterDiscovery::observeDynamicNeighbors() {
+    std::scoped_lock neighborLock(mNeighborMutex);
+    for (auto& [id, neighbor] : mDynamicNeighbors) {
+        // Chat traffic proves liveness as well as answered probe, so heartbeat is not due yet
+        const auto contact = mLiveness.last(id);
+        if (!contact || contact.value() <= neighbor.contact) {
+            continue;
+        }
+        neighbor.contact = contact.value();
+        neighbor.pinged = false;
+        mDetector.heartbeat(id, contact.value());
+        if (mMembership.observe(id, true) && !mContactsHandler.activate(id)) [[unlikely]] {
+            LOG_ERROR("Failed to activate using contacts handler!");
+            stop();
+            return;
+        }
+    }
+}
+
+void TTBroadcasterDiscovery::probeDynamicNeighbor() {
+    std::scoped_lock neighborLock(mNeighborMutex);
+    if (mProbesInFlight >= MAX_PROBES) {
+        return;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    // Member overdue for too long is probed first, so the detection time does not grow with the number of members
+    std::optional<size_t> next;
+    for (const auto& [member, neighbor] : mDynamicNeighbors) {
+        if (!neighbor.probing && now - mDetector.due(member) > MAX_PROBE_DELAY
+                && (!next || mDetector.due(member) < mDetector.due(next.value()))) {
+            next = member;
+        }
+    }
+    // Detector only spaces the probes of each member, due members are taken in random round order
+    if (!next) {
+        next = mMembership.next([&](size_t member) {
+            const auto neighbor = mDynamicNeighbors.find(member);
+            return neighbor != mDynamicNeighbors.end() && !neighbor->second.probing && mDetector.due(member) <= now;
+        });
+    }
+    if (!next) {
+        return;
+    }
+    const auto id = next.value();
+    auto& neighbor = mDynamicNeighbors.at(id);
+    // Ping carries no gossip, pong is counted as heartbeat by observing liveness
+    if (mPulse && !mMembership.pending() && !neighbor.pinged && mPulse->ping(id)) {
+        neighbor.pinged = true;
+        mDetector.postpone(id, now + PULSE_TIMEOUT);
+        return;
+    }
+    neighbor.pinged = false;
+    auto* stub = getDynamicNeighborStub(id);
+    if (!stub) {
+        if (!isStopped()) {
+            mDetector.failure(id, now);
+        }
+        return;
+    }
+    // Heartbeats are sent without holding the lock and without blocking the protocol period
+    neighbor.probing = true;
+    ++mProbesInFlight;
+    if (!mProbes.submit(std::bind(&TTBroadcasterDiscovery::sendProbe, this, id, mMembership.identity(id), std::ref(*stub),
+            mMembership.updates()))) [[unlikely]] {
+        neighbor.probing = false;
+        --mProbesInFlight;
+    }
+}
+
+void TTBroadcasterDiscovery::sendProbe(size_t id, const std::string& identity, TTNeighborsDiscoveryStubIf& stub,
+        const std::deque<TTMemberUpdate>& updates) {
+    const auto hostIdentity = getIdentity();
+    const auto isAlive = [](const TTHeartbeatResponse& response) {
+        return response.status && !response.identity.empty();
+    };
+    bool alive = false;
+    for (const auto& response : mNeighborsStub.sendHeartbeats({stub}, TTHeartbeatRequest{hostIdentity, updates})) {
+        alive |= isAlive(response);
+        if (isAlive(response)) {
+            applyMemberUpdates(response.updates);
+        }
+    }
+    if (!alive && !isStopped()) {
+        LOG_INFO("Direct probe failed, probing indirectly id={}", identity);
+        std::vector<std::reference_wrapper<TTNeighborsDiscoveryStubIf>> helpers;
         {
             std::scoped_lock neighborLock(mNeighborMutex);
-            for (auto &[id, neighbor] : mDynamicNeighbors) {
-                if (isStopped()) {
-                    break;
-                }
-                if (!neighbor.timer.expired()) {
-                    const auto remaining = neighbor.timer.remaining();
-                    if (remaining < smallest) {
-                        smallest = remaining;
-                    }
-                    continue;
+            for (const auto helper : mMembership.helpers(id)) {
+                if (auto* helperStub = getDynamicNeighborStub(helper); helperStub) {
+                    helpers.emplace_back(*helperStub);
                 }
-                if (neighbor.trials) {
-                    if (!neighbor.stub) {
-                        const auto entryOpt = mContactsHandler.get(id);
-                        if (!entryOpt) [[unlikely]] {
-                            LOG_ERROR("Failed to get entry using contacts handler!");
-                            stop();
-                            break;
-                        }
-                        const auto entry = entryOpt.value();
-                        neighbor.stub = mNeighborsStub.createDiscoveryStub(entry.ipAddressAndPort);
-                    }
-                    if (neighbor.stub) {
-                        const auto heartbeatRequest = TTHeartbeatRequest{getIdentity()};
-                        const auto heartbeatResponse = mNeighborsStub.sendHeartbeat(*neighbor.stub, heartbeatRequest);
-                        if (heartbeatResponse.status && !heartbeatResponse.identity.empty()) {
-                            neighbor.trials = DynamicNeighbor::inactivityTrials + 1;
-                            if (!mContactsHandler.activate(id)) [[unlikely]] {
-                                LOG_ERROR("Failed to activate using contacts handler!");
-                                stop();
-                                break;
-                            }
-                        } else {
-                            if (!mContactsHandler.deactivate(id)) [[unlikely]] {
-                                LOG_ERROR("Failed to deactivate using contacts handler!");
-                                stop();
-                                break;
-                            }
-                        }
-                    }
-                    --neighbor.trials;
-                    neighbor.timer.kick();
+            }
+        }
+        if (!helpers.empty()) {
+            for (const auto& response : mNeighborsStub.sendHeartbeats(helpers, TTHeartbeatRequest{hostIdentity, updates, identity})) {
+                alive |= isAlive(response);
+                if (isAlive(response)) {
+                    applyMemberUpdates(response.updates);
                 }
             }
         }
-        LOG_INFO("Inactivity count={}ms", smallest.count());
-        std::this_thread::sleep_for(smallest);
     }
-    LOG_INFO("Stopped resolving dynamic neighbors");
+    std::scoped_lock neighborLock(mNeighborMutex);
+    mDynamicNeighbors.at(id).probing = false;
+    --mProbesInFlight;
+    if (isStopped()) {
+        return;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    // Failed probe alone does not deactivate the member, suspicion level does
+    if (!alive) {
+        mDetector.failure(id, now);
+        return;
+    }
+    heartbeat(id, now);
+    mMembership.observe(id, true);
+    if (mCache) {
+        mCache->touch(identity);
+    }
+    if (!mContactsHandler.activate(id)) [[unlikely]] {
+        LOG_ERROR("Failed to activate using contacts handler!");
+        stop();
+    }
+}
+
+void TTBroadcasterDiscovery::suspectDynamicNeighbors() {
+    std::scoped_lock neighborLock(mNeighborMutex);
+    const auto now = std::chrono::steady_clock::now();
+    for (const auto& [id, neighbor] : mDynamicNeighbors) {
+        // Member being probed is judged by the probe, overdue heartbeat of member still waiting for its probe period
+        // is not its fault, but only for a while
+        const auto due = mDetector.due(id);
+        if (neighbor.probing || (due <= now && now - due <= MAX_PROBE_DELAY)) {
+            continue;
+        }
+        // Member is deactivated once, when it becomes suspected
+        if (!mDetector.suspected(id, now) || !mMembership.observe(id, false)) {
+            continue;
+        }
+        LOG_INFO("Suspecting neighbor id={}, phi={}", mMembership.identity(id), mDetector.phi(id, now));
+        if (!mContactsHandler.deactivate(id)) [[unlikely]] {
+            LOG_ERROR("Failed to deactivate using contacts handler!");
+            stop();
+            return;
+        }
+    }
+}
+
+TTNeighborsDiscoveryStubIf* TTBroadcasterDiscovery::getDynamicNeighborStub(size_t id) {
+    auto& neighbor = mDynamicNeighbors.at(id);
+    if (!neighbor.stub) {
+        const auto contacts = mContactsHandler.snapshot();
+        const auto* entry = contacts->get(id);
+        if (!entry) [[unlikely]] {
+            LOG_ERROR("Failed to get entry using contacts handler!");
+            stop();
+            return nullptr;
+        }
+        neighbor.stub = mNeighborsStub.createDiscoveryStub(entry->ipAddressAndPort);
+    }
+    return neighbor.stub.get();
+}
+
+void TTBroadcasterDiscovery::heartbeat(size_t id, std::chrono::steady_clock::time_point now) {
+    // Own contact is shared with chat broadcaster, but not counted twice
+    mDetector.heartbeat(id, now);
+    mLiveness.contact(id, now);
+    auto& neighbor = mDynamicNeighbors.at(id);
+    neighbor.contact = now;
+    neighbor.pinged = false;
+}
+
+bool TTBroadcasterDiscovery::applyMemberUpdates(const std::deque<TTMemberUpdate>& updates) {
+    if (updates.empty()) {
+        return true;
+    }
+    const auto hostIdentity = getIdentity();
+    std::scoped_lock neighborLock(mNeighborMutex);
+    for (const auto& update : updates) {
+        const auto changed = mMembership.apply(update, hostIdentity);
+        if (!changed) {
+            continue;
+        }
+        const auto [id, alive] = changed.value();
+        // Identity of the update might be packed key, the one known by membership is used instead
+        const auto identity = mMembership.identity(id);
+        LOG_INFO("Applying gossip, id={} alive={}", identity, alive);
+        if (alive) {
+            // Refuted failure counts as heartbeat, so the member is not suspected again at once
+            mDetector.heartbeat(id, std::chrono::steady_clock::now());
+            if (mCache) {
+                mCache->touch(identity);
+            }
+        }
+        if (!(alive ? mContactsHandler.activate(id) : mContactsHandler.deactivate(id))) [[unlikely]] {
+            LOG_ERROR("Failed to apply gossip using contacts handler!");
+            stop();
+            return false;
+        }
+    }
+    return true;
 }
 
 bool TTBroadcasterDiscovery::addNeighbor(const std::string& nickname,
     const std::string& identity,
     const std::string& ipAddressAndPort,
-    TTUniqueDiscoveryStub stub) {
+    TTUniqueDiscoveryStub stub,
+    const std::deque<TTPeer>& peers) {
     LOG_INFO("Adding neighbor...");
     if (nickname.empty() || identity.empty() || ipAddressAndPort.empty()) {
         LOG_WARNING("Rejecting neighbor (incomplete data)...");
@@ -202,6 +607,17 @@ bool TTBroadcasterDiscovery::addNeighbor(const std::string& nickname,
             stop();
             return false;
         }
+        if (mDynamicNeighbors.contains(id.value())) {
+            heartbeat(id.value(), std::chrono::steady_clock::now());
+            mMembership.observe(id.value(), true);
+            if (mPulse) {
+                mPulse->add(id.value(), identity, ipAddressAndPort.substr(0, ipAddressAndPort.find(':')));
+            }
+        }
+        if (mCache) {
+            mCache->store(nickname, identity, ipAddressAndPort);
+        }
+        exchangeNeighbors(peers);
         LOG_WARNING("Rejecting neighbor (already present)...");
         return true;
     }
@@ -220,11 +636,35 @@ bool TTBroadcasterDiscovery::addNeighbor(const std::string& nickname,
         stop();
         return false;
     }
-    auto timer = mInactivityTimerFactory.create();
-    timer.expire();
     mDynamicNeighbors.emplace(std::piecewise_construct,
         std::forward_as_tuple(id.value()),
-        std::forward_as_tuple(timer, std::move(stub)));
+        std::forward_as_tuple(std::move(stub)));
+    mMembership.add(id.value(), identity);
+    heartbeat(id.value(), std::chrono::steady_clock::now());
+    if (mPulse) {
+        mPulse->add(id.value(), identity, ipAddressAndPort.substr(0, ipAddressAndPort.find(':')));
+    }
+    if (mCache) {
+        mCache->store(nickname, identity, ipAddressAndPort);
+    }
+    exchangeNeighbors(peers);
     LOG_INFO("Successfully added new neighbor!");
     return true;
 }
+
+void TTBroadcasterDiscovery::exchangeNeighbors(const std::deque<TTPeer>& peers) {
+    for (const auto& peer : peers) {
+        if (mExchangedNeighbors.size() >= MAX_EXCHANGED_NEIGHBORS) {
+            LOG_WARNING("Ignoring peers, too many waiting to be greeted");
+            return;
+        }
+        if (peer.identity.empty() || peer.ipAddressAndPort.empty() || peer.ipAddressAndPort == mNetworkInterface.getIpAddressAndPort()) {
+            continue;
+        }
+        if (mContactsHandler.get(peer.identity)) {
+            continue;
+        }
+        LOG_INFO("Queueing peer learned from greet reply id={}", peer.identity);
+        mExchangedNeighbors.push_back(peer.ipAddressAndPort);
+    }
+}
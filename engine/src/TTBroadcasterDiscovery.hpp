@@ -4,15 +4,28 @@
 #include "TTNetworkInterface.hpp"
 #include "TTUtilsTimerFactory.hpp"
 #include "TTNeighborsStub.hpp"
+#include "TTNeighborsMembership.hpp"
+#include "TTNeighborsSweep.hpp"
+#include "TTNeighborsCache.hpp"
+#include "TTNeighborsDetector.hpp"
+#include "TTNeighborsLiveness.hpp"
+#include "TTNeighborsPulse.hpp"
 #include "TTUtilsStopable.hpp"
+#include "TTUtilsExecutor.hpp"
 
 class TTBroadcasterDiscovery : public TTUtilsStopable {
 public:
+    // Neighbors are IPv4 addresses or CIDR ranges (e.g. 10.0.0.0/22), which are swept,
+    // neighbors seen before are kept in cache file, empty path means no cache
     TTBroadcasterDiscovery(TTContactsHandler& contactsHandler,
                            TTChatHandler& chatHandler,
                            TTNeighborsStub& neighborsStub,
+                           TTNeighborsLiveness& liveness,
                            TTNetworkInterface networkInterface,
-                           const std::deque<std::string>& neighbors);
+                           const std::deque<std::string>& neighbors,
+                           const std::string& cachePath = {},
+                           const TTNeighborsDetectorSettings& detectorSettings = {},
+                           uint16_t heartbeatPort = 0);
     virtual ~TTBroadcasterDiscovery();
     TTBroadcasterDiscovery(const TTBroadcasterDiscovery&) = delete;
     TTBroadcasterDiscovery(TTBroadcasterDiscovery&&) = delete;
@@ -24,19 +37,52 @@ public:
     virtual bool handleGreet(const TTGreetRequest& request);
     // Heartbeat request handler
     virtual bool handleHeartbeat(const TTHeartbeatRequest& request);
+    // Beacon request handler
+    virtual bool handleBeacon(const TTBeaconRequest& request);
+    // Returns membership updates to be piggybacked on heartbeat reply
+    [[nodiscard]] virtual std::deque<TTMemberUpdate> getMemberUpdates();
+    // Returns random live members to be sent on greet reply (peer exchange)
+    [[nodiscard]] virtual std::deque<TTPeer> getPeers();
     // Returns root nickname
     [[nodiscard]] virtual std::string getNickname();
     // Returns root identity
     [[nodiscard]] virtual std::string getIdentity();
     // Returns root IP address and port
     [[nodiscard]] virtual std::string getIpAddressAndPort();
+protected:
+    virtual void onStop() override;
 private:
+    // Greets cached neighbors, most recently seen first, returns IP addresses and ports of neighbors added
+    std::vector<std::string> resolveCachedNeighbors();
+    // Greets due static neighbors concurrently, sleeps until the earliest retry otherwise
     void resolveStaticNeighbors();
+    // Greets hosts found by subnet sweep, addresses which did not answer are retried with backoff
+    void resolveSubnetNeighbors();
     void resolveDynamicNeighbors();
+    // Counts contacts made by chat broadcaster as heartbeats, so those members are not probed
+    void observeDynamicNeighbors();
+    // Starts probe of one due member per protocol period, member overdue for too long goes first, random one otherwise,
+    // if heartbeat port is set and there is no gossip to be piggybacked the member is pinged over UDP first
+    void probeDynamicNeighbor();
+    // Probes member directly, then indirectly through helpers if it does not respond (runs on probe executor)
+    void sendProbe(size_t id, const std::string& identity, TTNeighborsDiscoveryStubIf& stub, const std::deque<TTMemberUpdate>& updates);
+    // Deactivates members whose suspicion level reached the threshold, members being probed or waiting for their probe
+    // are not suspected, unless they have been overdue for too long
+    void suspectDynamicNeighbors();
+    // Returns stub of the dynamic neighbor, created if needed (thread-unsafe)
+    TTNeighborsDiscoveryStubIf* getDynamicNeighborStub(size_t id);
+    // Member proved liveness to discovery itself (thread-unsafe)
+    void heartbeat(size_t id, std::chrono::steady_clock::time_point now);
+    // Applies piggybacked membership updates
+    bool applyMemberUpdates(const std::deque<TTMemberUpdate>& updates);
+    // Adds neighbor, peers it knows about which are unknown to the host are queued to be greeted
     bool addNeighbor(const std::string& nickname,
         const std::string& identity,
         const std::string& ipAddressAndPort,
-        TTUniqueDiscoveryStub stub);
+        TTUniqueDiscoveryStub stub,
+        const std::deque<TTPeer>& peers = {});
+    // Queues unknown peers learned from greet reply (thread-unsafe)
+    void exchangeNeighbors(const std::deque<TTPeer>& peers);
     struct StaticNeighbor {
         StaticNeighbor(TTUtilsTimer timer, std::string ipAddressAndPort) :
             timer(timer), trials(discoveryTrials), ipAddressAndPort(ipAddressAndPort) {}
@@ -51,25 +97,68 @@ private:
         const static inline size_t discoveryTrials = 3;
     };
     struct DynamicNeighbor {
-        DynamicNeighbor(TTUtilsTimer timer, TTUniqueDiscoveryStub stub) :
-            timer(timer), trials(inactivityTrials), stub(std::move(stub)) {}
+        DynamicNeighbor(TTUniqueDiscoveryStub stub) :
+            stub(std::move(stub)) {}
         ~DynamicNeighbor() = default;
         DynamicNeighbor(const DynamicNeighbor&) = default;
         DynamicNeighbor(DynamicNeighbor&&) = default;
         DynamicNeighbor& operator=(const DynamicNeighbor&) = default;
         DynamicNeighbor& operator=(DynamicNeighbor&&) = default;
-        TTUtilsTimer timer;
-        size_t trials;
         TTUniqueDiscoveryStub stub;
-        const static inline size_t inactivityTrials = 5;
+        // Last contact already counted as heartbeat
+        std::chrono::steady_clock::time_point contact;
+        // Pinged over UDP since the last heartbeat, gRPC probe follows if pong does not arrive
+        bool pinged = false;
+        // gRPC probe is in flight
+        bool probing = false;
     };
+    // Greets neighbors concurrently (bounded fan-out), returns true for each neighbor added,
+    // peers learned from greet replies are greeted in following rounds until no unknown peer is left
+    std::vector<bool> greetNeighbors(const std::vector<std::string>& ipAddressesAndPorts);
+    std::vector<bool> greetRound(const std::vector<std::string>& ipAddressesAndPorts);
+    // Returns entry of the host, cached once known
+    std::shared_ptr<const TTContactsHandlerEntry> getHostEntry();
     TTContactsHandler& mContactsHandler;
     TTChatHandler& mChatHandler;
     TTNeighborsStub& mNeighborsStub;
+    TTNeighborsLiveness& mLiveness;
     TTNetworkInterface mNetworkInterface;
+    std::atomic<std::shared_ptr<const TTContactsHandlerEntry>> mHostEntry;
     std::deque<StaticNeighbor> mStaticNeighbors;
+    std::unique_ptr<TTNeighborsSweep> mSweep;
+    // Optional, present only if heartbeat port is set
+    std::unique_ptr<TTNeighborsPulse> mPulse;
+    // Guarded by neighbor mutex
+    std::unique_ptr<TTNeighborsCache> mCache;
     std::map<size_t, DynamicNeighbor> mDynamicNeighbors;
+    // IP addresses and ports of peers learned from greet replies, to be greeted
+    std::deque<std::string> mExchangedNeighbors;
     mutable std::shared_mutex mNeighborMutex;
-    TTUtilsTimerFactory mInactivityTimerFactory;
+    // Wakes resolvers up on stop
+    std::mutex mStopMutex;
+    std::condition_variable mStopCondition;
+    TTNeighborsMembership mMembership;
+    // Guarded by neighbor mutex
+    TTNeighborsDetector mDetector;
     TTUtilsTimerFactory mDiscoveryTimerFactory;
+    // Guarded by neighbor mutex
+    size_t mProbesInFlight = 0;
+    // Workers have to be joined before neighbors are destroyed
+    TTUtilsExecutor mProbes;
+    // Suspicion is checked at least this often
+    static inline constexpr std::chrono::milliseconds SUSPECT_INTERVAL{100};
+    // Protocol period, at most one member is probed per period whatever the number of due members
+    static inline constexpr std::chrono::milliseconds PROBE_PERIOD{100};
+    // Member overdue for longer is probed before the others, or suspected if it cannot be probed in time
+    static inline constexpr std::chrono::milliseconds MAX_PROBE_DELAY{2000};
+    // Number of probes in flight, each one takes up to direct and indirect heartbeat deadlines
+    static inline constexpr size_t MAX_PROBES{8};
+    // Time to wait for pong before member is probed with gRPC heartbeat
+    static inline constexpr std::chrono::milliseconds PULSE_TIMEOUT{500};
+    // Number of static neighbors greeted at once
+    static inline constexpr size_t MAX_GREET_FAN_OUT{32};
+    // Number of peers sent on greet reply
+    static inline constexpr size_t MAX_PEERS{16};
+    // Number of learned peers waiting to be greeted
+    static inline constexpr size_t MAX_EXCHANGED_NEIGHBORS{256};
 };
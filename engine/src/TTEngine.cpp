@@ -7,7 +7,7 @@ TTEngine::TTEngine(const TTEngineSettings& settings) {
     LOG_INFO("Creating handlers...");
     mContacts = abstractFactory.createContactsHandler();
     mChat = abstractFactory.createChatHandler();
-    mTextBox = abstractFactory.createTextBoxHandler(std::bind(&TTEngine::mailbox, this, _1), std::bind(&TTEngine::selection, this, _1));
+    mTextBox = abstractFactory.createTextBoxHandler(std::bind(&TTEngine::mailbox, this, _1), std::bind(&TTEngine::selection, this, _1), std::bind(&TTEngine::paging, this, _1));
     if (!mContacts || !mChat || !mTextBox) {
         throw std::runtime_error("TTEngine: Failed to create handlers!");
     }
@@ -26,8 +26,8 @@ TTEngine::TTEngine(const TTEngineSettings& settings) {
         if (!mNeighborsStub) {
             throw std::runtime_error("TTEngine: Failed to create neighbors stub!");
         }
-        mBroadcasterChat = abstractFactory.createBroadcasterChat(*mContacts, *mChat, *mNeighborsStub, networkInterface);
-        mBroadcasterDiscovery = abstractFactory.createBroadcasterDiscovery(*mContacts, *mChat, *mNeighborsStub, networkInterface, settings.getNeighbors());
+        mBroadcasterChat = abstractFactory.createBroadcasterChat(*mContacts, *mChat, *mNeighborsStub, mNeighborsLiveness, networkInterface, settings.getChatLimits());
+        mBroadcasterDiscovery = abstractFactory.createBroadcasterDiscovery(*mContacts, *mChat, *mNeighborsStub, mNeighborsLiveness, networkInterface, settings.getNeighbors(), settings.getNeighborsCache(), settings.getDetectorSettings(), settings.getHeartbeatPort());
         if (!mBroadcasterChat || !mBroadcasterDiscovery) {
             throw std::runtime_error("TTEngine: Failed to create broadcasters!");
         }
@@ -40,11 +40,18 @@ TTEngine::TTEngine(const TTEngineSettings& settings) {
         if (!mServiceChat || !mServiceDiscovery) {
             throw std::runtime_error("TTEngine: Failed to create services!");
         }
-        mServer = abstractFactory.createServer(networkInterface.getIpAddressAndPort(), *mServiceChat, *mServiceDiscovery);
+        mServer = abstractFactory.createServer(networkInterface.getIpAddressAndPort(), *mServiceChat, *mServiceDiscovery, settings.getServerThreads());
         if (!mServer) {
             throw std::runtime_error("TTEngine: Failed to create gRPC server!");
         }
     }
+    if (const auto& beaconAddress = settings.getBeaconAddress(); !beaconAddress.empty()) {
+        LOG_INFO("Creating beacon...");
+        mBeacon = abstractFactory.createNeighborsBeacon(beaconAddress, settings.getNetworkInterface(), *mBroadcasterDiscovery);
+        if (!mBeacon) {
+            throw std::runtime_error("TTEngine: Failed to create beacon!");
+        }
+    }
     LOG_INFO("Setting server thread...");
     {
         std::promise<void> serverPromise;
@@ -66,6 +73,13 @@ TTEngine::TTEngine(const TTEngineSettings& settings) {
         mThreads.push_back(std::thread(&TTEngine::discovery, this, std::move(broadcasterPromise)));
         mThreads.back().detach();
     }
+    if (mBeacon) {
+        LOG_INFO("Setting beacon thread...");
+        std::promise<void> beaconPromise;
+        mBlockers.push_back(beaconPromise.get_future());
+        mThreads.push_back(std::thread(&TTEngine::beacon, this, std::move(beaconPromise)));
+        mThreads.back().detach();
+    }
     LOG_INFO("Successfully constructed!");
 }
 
@@ -88,6 +102,7 @@ void TTEngine::run() {
         stopped |= (!mTextBox || mTextBox->isStopped());
         stopped |= (!mBroadcasterChat || mBroadcasterChat->isStopped());
         stopped |= (!mBroadcasterDiscovery || mBroadcasterDiscovery->isStopped());
+        stopped |= (mBeacon && mBeacon->isStopped());
         if (stopped) {
             break;
         }
@@ -121,6 +136,14 @@ void TTEngine::discovery(std::promise<void> promise) {
     LOG_INFO("Completed discovery loop");
 }
 
+void TTEngine::beacon(std::promise<void> promise) {
+    LOG_INFO("Started beacon loop");
+    mBeacon->run();
+    stop();
+    promise.set_value();
+    LOG_INFO("Completed beacon loop");
+}
+
 void TTEngine::mailbox(const std::string& message) {
     LOG_INFO("Received callback - message sent");
     std::scoped_lock lock(mExternalCallsMutex);
@@ -145,6 +168,19 @@ void TTEngine::selection(size_t message) {
     }
 }
 
+void TTEngine::paging(size_t message) {
+    LOG_INFO("Received callback - chat paging");
+    std::scoped_lock lock(mExternalCallsMutex);
+    if (mChat->current()) {
+        if (!mChat->page(message)) [[unlikely]] {
+            LOG_ERROR("Received callback - failed to show chat page!");
+            stop();
+        }
+    } else {
+        LOG_WARNING("Received callback - attempt to page chat with no selected contact!");
+    }
+}
+
 void TTEngine::onStop() {
     LOG_WARNING("Forced internal stop...");
     if (mServer) {
@@ -165,4 +201,7 @@ void TTEngine::onStop() {
     if (mBroadcasterDiscovery) {
         mBroadcasterDiscovery->stop();
     }
+    if (mBeacon) {
+        mBeacon->stop();
+    }
 }
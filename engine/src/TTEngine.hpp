@@ -19,10 +19,14 @@ private:
     void chat(std::promise<void> promise);
     // Broadcaster discovery thread
     void discovery(std::promise<void> promise);
+    // Beacon thread
+    void beacon(std::promise<void> promise);
     // Callback mailbox function
     void mailbox(const std::string& message);
     // Callback selection function (contacts selection)
     void selection(size_t message);
+    // Callback paging function (older chat messages)
+    void paging(size_t message);
     // Stops application (internal function)
     virtual void onStop() override;
     // Concurrent communication
@@ -38,6 +42,10 @@ private:
     std::unique_ptr<TTNeighborsServiceDiscovery> mServiceDiscovery;
     std::unique_ptr<TTServer> mServer;
     std::unique_ptr<TTNeighborsStub> mNeighborsStub;
+    // Shared by broadcasters, outlives them
+    TTNeighborsLiveness mNeighborsLiveness;
     std::unique_ptr<TTBroadcasterChat> mBroadcasterChat;
     std::unique_ptr<TTBroadcasterDiscovery> mBroadcasterDiscovery;
+    // Optional, present only if beacon address is set
+    std::unique_ptr<TTNeighborsBeacon> mBeacon;
 };
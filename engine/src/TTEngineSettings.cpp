@@ -1,8 +1,10 @@
 #include "TTEngineSettings.hpp"
+#include "TTNeighborsSweep.hpp"
 #include <string>
 #include <limits>
 #include <charconv>
 #include <iostream>
+#include <cstdlib>
 #include <arpa/inet.h>
 
 TTEngineSettings::TTEngineSettings(int argc, const char* const* argv) {
@@ -68,10 +70,132 @@ TTEngineSettings::TTEngineSettings(int argc, const char* const* argv) {
 
     for (int i = MIN_ARGC; i < argc; ++i) {
         const std::string neighbor = argv[i];
+        // Subnet (CIDR range) is swept by discovery
+        if (neighbor.find('/') != std::string::npos) {
+            if (!TTNeighborsSweep::isSubnet(neighbor)) {
+                throw std::runtime_error(std::string("TTEngineSettings: Invalid neighbor subnet=") + neighbor);
+            }
+            mNeighbors.emplace_back(neighbor);
+            continue;
+        }
         sockaddr_in sa;
         if (inet_pton(AF_INET, neighbor.c_str(), &(sa.sin_addr)) == 0) {
             throw std::runtime_error(std::string("TTEngineSettings: Invalid neighbor IPv4 address=") + neighbor);
         }
         mNeighbors.emplace_back(neighbor);
     }
+
+    if (const char* threads = std::getenv("TT_SERVER_THREADS"); threads) {
+        size_t value = 0;
+        auto [ptr, ec] = std::from_chars(threads, threads + strlen(threads), value);
+        if (ec != std::errc() || ptr != threads + strlen(threads)) {
+            throw std::runtime_error(std::string("TTEngineSettings: Invalid number of server threads=") + threads);
+        }
+        if (value > MAX_SERVER_THREADS) {
+            throw std::runtime_error(std::string("TTEngineSettings: Invalid (out of range) number of server threads=") + threads);
+        }
+        mServerThreads = value;
+    }
+
+    if (const char* beaconAddress = std::getenv("TT_BEACON_ADDRESS"); beaconAddress && strlen(beaconAddress)) {
+        sockaddr_in sa;
+        if (inet_pton(AF_INET, beaconAddress, &(sa.sin_addr)) == 0) {
+            throw std::runtime_error(std::string("TTEngineSettings: Invalid beacon IPv4 address=") + beaconAddress);
+        }
+        mBeaconAddress = beaconAddress;
+    }
+
+    const auto getBytes = [](const char* name, const std::string& description, size_t& bytes) {
+        if (const char* value = std::getenv(name); value) {
+            auto [ptr, ec] = std::from_chars(value, value + strlen(value), bytes);
+            if (ec != std::errc() || ptr != value + strlen(value) || bytes == 0) {
+                throw std::runtime_error("TTEngineSettings: Invalid " + description + "=" + value);
+            }
+        }
+    };
+    getBytes("TT_CHAT_NEIGHBOR_BYTES", "chat neighbor budget", mChatLimits.neighborBytes);
+    getBytes("TT_CHAT_GLOBAL_BYTES", "chat global budget", mChatLimits.globalBytes);
+
+    if (const char* overflow = std::getenv("TT_CHAT_OVERFLOW"); overflow) {
+        const std::string policy = overflow;
+        if (policy == "reject") {
+            mChatLimits.overflow = TTBroadcasterChatLimits::Overflow::REJECT;
+        } else if (policy == "drop-oldest") {
+            mChatLimits.overflow = TTBroadcasterChatLimits::Overflow::DROP_OLDEST;
+        } else if (policy == "spill") {
+            mChatLimits.overflow = TTBroadcasterChatLimits::Overflow::SPILL;
+        } else {
+            throw std::runtime_error("TTEngineSettings: Invalid chat overflow policy=" + policy);
+        }
+    }
+
+    if (const char* spillDirectory = std::getenv("TT_CHAT_SPILL_DIRECTORY"); spillDirectory) {
+        mChatLimits.spillDirectory = spillDirectory;
+    }
+
+    if (const char* flushWindow = std::getenv("TT_CHAT_FLUSH_WINDOW"); flushWindow) {
+        size_t value = 0;
+        auto [ptr, ec] = std::from_chars(flushWindow, flushWindow + strlen(flushWindow), value);
+        if (ec != std::errc() || ptr != flushWindow + strlen(flushWindow)) {
+            throw std::runtime_error(std::string("TTEngineSettings: Invalid chat flush window=") + flushWindow);
+        }
+        if (value > static_cast<size_t>(TTBroadcasterChatLimits::MAX_FLUSH_WINDOW.count())) {
+            throw std::runtime_error(std::string("TTEngineSettings: Invalid (out of range) chat flush window=") + flushWindow);
+        }
+        mChatLimits.flushWindow = std::chrono::milliseconds(value);
+    }
+
+    if (const char* inFlight = std::getenv("TT_CHAT_IN_FLIGHT"); inFlight) {
+        size_t value = 0;
+        auto [ptr, ec] = std::from_chars(inFlight, inFlight + strlen(inFlight), value);
+        if (ec != std::errc() || ptr != inFlight + strlen(inFlight)) {
+            throw std::runtime_error(std::string("TTEngineSettings: Invalid chat in-flight limit=") + inFlight);
+        }
+        if (value == 0 || value > TTBroadcasterChatLimits::MAX_IN_FLIGHT) {
+            throw std::runtime_error(std::string("TTEngineSettings: Invalid (out of range) chat in-flight limit=") + inFlight);
+        }
+        mChatLimits.inFlight = value;
+    }
+
+    if (const char* neighborsCache = std::getenv("TT_NEIGHBORS_CACHE"); neighborsCache) {
+        mNeighborsCache = neighborsCache;
+    }
+
+    if (const char* threshold = std::getenv("TT_PHI_THRESHOLD"); threshold) {
+        double value = 0.0;
+        auto [ptr, ec] = std::from_chars(threshold, threshold + strlen(threshold), value);
+        if (ec != std::errc() || ptr != threshold + strlen(threshold)) {
+            throw std::runtime_error(std::string("TTEngineSettings: Invalid phi threshold=") + threshold);
+        }
+        if (!(value > 0.0) || value > TTNeighborsDetectorSettings::MAX_THRESHOLD) {
+            throw std::runtime_error(std::string("TTEngineSettings: Invalid (out of range) phi threshold=") + threshold);
+        }
+        mDetectorSettings.threshold = value;
+    }
+
+    const auto getInterval = [](const char* name, const std::string& description, std::chrono::milliseconds& interval) {
+        if (const char* value = std::getenv(name); value) {
+            size_t milliseconds = 0;
+            auto [ptr, ec] = std::from_chars(value, value + strlen(value), milliseconds);
+            if (ec != std::errc() || ptr != value + strlen(value)) {
+                throw std::runtime_error("TTEngineSettings: Invalid " + description + "=" + value);
+            }
+            if (milliseconds == 0 || milliseconds > static_cast<size_t>(TTNeighborsDetectorSettings::MAX_INTERVAL.count())) {
+                throw std::runtime_error("TTEngineSettings: Invalid (out of range) " + description + "=" + value);
+            }
+            interval = std::chrono::milliseconds(milliseconds);
+        }
+    };
+    getInterval("TT_HEARTBEAT_MIN_INTERVAL", "heartbeat min interval", mDetectorSettings.minInterval);
+    getInterval("TT_HEARTBEAT_MAX_INTERVAL", "heartbeat max interval", mDetectorSettings.maxInterval);
+    if (mDetectorSettings.minInterval > mDetectorSettings.maxInterval) {
+        throw std::runtime_error("TTEngineSettings: Invalid heartbeat min interval greater than max interval");
+    }
+
+    if (const char* heartbeatPort = std::getenv("TT_HEARTBEAT_PORT"); heartbeatPort && strlen(heartbeatPort)) {
+        auto [ptr, ec] = std::from_chars(heartbeatPort, heartbeatPort + strlen(heartbeatPort), mHeartbeatPort);
+        if (ec != std::errc() || ptr != heartbeatPort + strlen(heartbeatPort) || mHeartbeatPort == 0) {
+            throw std::runtime_error(std::string("TTEngineSettings: Invalid heartbeat port=") + heartbeatPort);
+        }
+    }
 }
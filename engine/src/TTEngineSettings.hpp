@@ -17,6 +17,12 @@ public:
     [[nodiscard]] virtual const std::string& getIdentity() const { return mIdentity; }
     [[nodiscard]] virtual const TTNetworkInterface& getNetworkInterface() const { return mNetworkInterface; }
     [[nodiscard]] virtual const std::deque<std::string>& getNeighbors() const { return mNeighbors; }
+    [[nodiscard]] virtual size_t getServerThreads() const { return mServerThreads; }
+    [[nodiscard]] virtual const std::string& getBeaconAddress() const { return mBeaconAddress; }
+    [[nodiscard]] virtual const TTBroadcasterChatLimits& getChatLimits() const { return mChatLimits; }
+    [[nodiscard]] virtual const std::string& getNeighborsCache() const { return mNeighborsCache; }
+    [[nodiscard]] virtual const TTNeighborsDetectorSettings& getDetectorSettings() const { return mDetectorSettings; }
+    [[nodiscard]] virtual uint16_t getHeartbeatPort() const { return mHeartbeatPort; }
     [[nodiscard]] virtual const TTAbstractFactory& getAbstractFactory() const { return *mAbstractFactory; }
 protected:
     TTEngineSettings() = default;
@@ -32,5 +38,21 @@ private:
     std::string mIdentity;
     TTNetworkInterface mNetworkInterface;
     std::deque<std::string> mNeighbors;
+    size_t mServerThreads = DEFAULT_SERVER_THREADS;
+    // Multicast group or broadcast address of presence beacons set with TT_BEACON_ADDRESS, empty means disabled
+    std::string mBeaconAddress;
+    // Outgoing messages budget set with TT_CHAT_NEIGHBOR_BYTES, TT_CHAT_GLOBAL_BYTES,
+    // TT_CHAT_OVERFLOW (reject, drop-oldest, spill) and TT_CHAT_SPILL_DIRECTORY,
+    // concurrent deliveries set with TT_CHAT_IN_FLIGHT
+    TTBroadcasterChatLimits mChatLimits;
+    // Known neighbors cache file set with TT_NEIGHBORS_CACHE, empty means disabled
+    std::string mNeighborsCache;
+    // Failure detector set with TT_PHI_THRESHOLD, TT_HEARTBEAT_MIN_INTERVAL and TT_HEARTBEAT_MAX_INTERVAL
+    TTNeighborsDetectorSettings mDetectorSettings;
+    // UDP heartbeat port set with TT_HEARTBEAT_PORT (same on all hosts), 0 means gRPC heartbeats only
+    uint16_t mHeartbeatPort = 0;
     static inline constexpr int MIN_ARGC = 9;
+    // Number of server polling threads can be overriden with TT_SERVER_THREADS, 0 means synchronous server
+    static inline constexpr size_t DEFAULT_SERVER_THREADS = 2;
+    static inline constexpr size_t MAX_SERVER_THREADS = 64;
 };
@@ -0,0 +1,126 @@
+#include "TTNeighborsBeacon.hpp"
+#include "TTDiagnosticsLogger.hpp"
+#include "TerminalTeams.pb.h"
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+TTNeighborsBeacon::TTNeighborsBeacon(const std::string& groupAddress,
+                                     TTNetworkInterface networkInterface,
+                                     TTBroadcasterDiscovery& discovery,
+                                     std::chrono::milliseconds interval) :
+        mDiscovery(&discovery),
+        mGroupAddress(groupAddress),
+        mTimer(interval) {
+    LOG_INFO("Constructing...");
+    const auto port = networkInterface.getPort();
+    auto [ptr, ec] = std::from_chars(port.data(), port.data() + port.size(), mPort);
+    if (ec != std::errc()) {
+        throw std::runtime_error("TTNeighborsBeacon: Invalid port=" + port);
+    }
+    in_addr group{};
+    if (inet_pton(AF_INET, groupAddress.c_str(), &group) != 1) {
+        throw std::runtime_error("TTNeighborsBeacon: Invalid group address=" + groupAddress);
+    }
+    mSocket = socket(AF_INET, SOCK_DGRAM, 0);
+    if (mSocket < 0) {
+        throw std::runtime_error("TTNeighborsBeacon: Failed to create socket");
+    }
+    // Several engines on one host can listen on the same port
+    const int enable = 1;
+    setsockopt(mSocket, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    setsockopt(mSocket, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(mPort);
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(mSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        close(mSocket);
+        throw std::runtime_error("TTNeighborsBeacon: Failed to bind socket");
+    }
+    if (IN_MULTICAST(ntohl(group.s_addr))) {
+        ip_mreq membership{};
+        membership.imr_multiaddr = group;
+        inet_pton(AF_INET, networkInterface.getIpAddress().c_str(), &membership.imr_interface);
+        if (setsockopt(mSocket, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) < 0) {
+            close(mSocket);
+            throw std::runtime_error("TTNeighborsBeacon: Failed to join multicast group=" + groupAddress);
+        }
+        setsockopt(mSocket, IPPROTO_IP, IP_MULTICAST_IF, &membership.imr_interface, sizeof(membership.imr_interface));
+        // Beacons stay within the local network
+        const unsigned char ttl = 1;
+        setsockopt(mSocket, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+    } else {
+        setsockopt(mSocket, SOL_SOCKET, SO_BROADCAST, &enable, sizeof(enable));
+    }
+    mTimer.expire();
+    LOG_INFO("Successfully constructed!");
+}
+
+TTNeighborsBeacon::~TTNeighborsBeacon() {
+    LOG_INFO("Destructing...");
+    stop();
+    if (mSocket >= 0) {
+        close(mSocket);
+    }
+    LOG_INFO("Successfully destructed!");
+}
+
+void TTNeighborsBeacon::run() {
+    LOG_INFO("Started beacon loop");
+    while (!isStopped()) {
+        if (mTimer.expired()) {
+            if (!send()) {
+                LOG_WARNING("Failed to send beacon!");
+            }
+            mTimer.kick();
+        }
+        pollfd descriptor{mSocket, POLLIN, 0};
+        const auto result = poll(&descriptor, 1, POLL_TIMEOUT.count());
+        if (result < 0 && errno != EINTR) [[unlikely]] {
+            LOG_ERROR("Failed to poll beacon socket!");
+            stop();
+            break;
+        }
+        if (result > 0 && (descriptor.revents & POLLIN)) {
+            receive();
+        }
+    }
+    LOG_INFO("Stopped beacon loop");
+}
+
+bool TTNeighborsBeacon::send() {
+    tt::BeaconRequest request;
+    request.set_nickname(mDiscovery->getNickname());
+    request.set_identity(mDiscovery->getIdentity());
+    request.set_ipaddressandport(mDiscovery->getIpAddressAndPort());
+    std::string payload;
+    if (!request.SerializeToString(&payload)) [[unlikely]] {
+        return false;
+    }
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(mPort);
+    inet_pton(AF_INET, mGroupAddress.c_str(), &address.sin_addr);
+    const auto sent = sendto(mSocket, payload.data(), payload.size(), 0, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    return sent == static_cast<ssize_t>(payload.size());
+}
+
+bool TTNeighborsBeacon::receive() {
+    std::array<char, MAX_BEACON_SIZE> buffer;
+    const auto received = recv(mSocket, buffer.data(), buffer.size(), MSG_DONTWAIT);
+    if (received <= 0) {
+        return false;
+    }
+    tt::BeaconRequest request;
+    if (!request.ParseFromArray(buffer.data(), received)) {
+        LOG_WARNING("Ignoring malformed beacon!");
+        return false;
+    }
+    return mDiscovery->handleBeacon(TTBeaconRequest(request.nickname(), request.identity(), request.ipaddressandport()));
+}
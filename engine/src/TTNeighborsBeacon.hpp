@@ -0,0 +1,37 @@
+#pragma once
+#include "TTBroadcasterDiscovery.hpp"
+#include "TTNetworkInterface.hpp"
+#include "TTUtilsStopable.hpp"
+#include "TTUtilsTimer.hpp"
+#include <chrono>
+#include <string>
+
+// Periodically announces presence over UDP multicast (or broadcast) and passes received beacons to discovery
+class TTNeighborsBeacon : public TTUtilsStopable {
+public:
+    TTNeighborsBeacon(const std::string& groupAddress,
+                      TTNetworkInterface networkInterface,
+                      TTBroadcasterDiscovery& discovery,
+                      std::chrono::milliseconds interval = BEACON_INTERVAL);
+    virtual ~TTNeighborsBeacon();
+    TTNeighborsBeacon(const TTNeighborsBeacon&) = delete;
+    TTNeighborsBeacon(TTNeighborsBeacon&&) = delete;
+    TTNeighborsBeacon& operator=(const TTNeighborsBeacon&) = delete;
+    TTNeighborsBeacon& operator=(TTNeighborsBeacon&&) = delete;
+    // Main loop
+    virtual void run();
+protected:
+    TTNeighborsBeacon() = default;
+private:
+    bool send();
+    bool receive();
+    TTBroadcasterDiscovery* mDiscovery = nullptr;
+    int mSocket = -1;
+    std::string mGroupAddress;
+    uint16_t mPort = 0;
+    TTUtilsTimer mTimer;
+    static inline constexpr std::chrono::milliseconds BEACON_INTERVAL{2000};
+    // Upper bound of the time needed to notice stop
+    static inline constexpr std::chrono::milliseconds POLL_TIMEOUT{100};
+    static inline constexpr size_t MAX_BEACON_SIZE = 512;
+};
@@ -0,0 +1,159 @@
+#include "TTNeighborsCache.hpp"
+#include "TTDiagnosticsLogger.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static bool copyField(char* destination, size_t size, const std::string& value) {
+    if (value.empty() || value.size() >= size) {
+        return false;
+    }
+    std::memset(destination, 0, size);
+    std::memcpy(destination, value.data(), value.size());
+    return true;
+}
+
+static bool isTerminated(const char* field, size_t size) {
+    return field[0] != '\0' && std::memchr(field, '\0', size) != nullptr;
+}
+
+TTNeighborsCache::TTNeighborsCache(const std::filesystem::path& path, size_t capacity) :
+        mPath(path),
+        mCapacity(std::max<size_t>(capacity, 1)),
+        mBytes(sizeof(Header) + mCapacity * sizeof(Record)) {
+    LOG_INFO("Constructing...");
+    if (mPath.has_parent_path()) {
+        std::error_code error;
+        std::filesystem::create_directories(mPath.parent_path(), error);
+    }
+    mFileDescriptor = open(mPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (mFileDescriptor < 0) {
+        throw std::runtime_error("TTNeighborsCache: Failed to open file=" + mPath.string());
+    }
+    struct stat status{};
+    bool valid = fstat(mFileDescriptor, &status) == 0 && static_cast<size_t>(status.st_size) == mBytes;
+    // File of different size is discarded, zero filled file is valid but empty
+    if (!valid && (ftruncate(mFileDescriptor, 0) != 0 || ftruncate(mFileDescriptor, mBytes) != 0)) {
+        close(mFileDescriptor);
+        throw std::runtime_error("TTNeighborsCache: Failed to resize file=" + mPath.string());
+    }
+    mMapping = mmap(nullptr, mBytes, PROT_READ | PROT_WRITE, MAP_SHARED, mFileDescriptor, 0);
+    if (mMapping == MAP_FAILED) {
+        close(mFileDescriptor);
+        throw std::runtime_error("TTNeighborsCache: Failed to map file=" + mPath.string());
+    }
+    auto& header = *static_cast<Header*>(mMapping);
+    if (header.magic != MAGIC || header.version != VERSION || header.capacity != mCapacity) {
+        if (valid) {
+            LOG_WARNING("Discarding incompatible cache file={}", mPath.string());
+        }
+        std::memset(mMapping, 0, mBytes);
+        header = Header{MAGIC, VERSION, mCapacity};
+    }
+    for (size_t slot = 0; slot < mCapacity; ++slot) {
+        auto& entry = record(slot);
+        if (entry.lastSeen == 0) {
+            continue;
+        }
+        if (!isTerminated(entry.nickname, FIELD_SIZE) ||
+            !isTerminated(entry.identity, FIELD_SIZE) ||
+            !isTerminated(entry.ipAddressAndPort, ADDRESS_SIZE)) [[unlikely]] {
+            entry.lastSeen = 0;
+            continue;
+        }
+        mClock = std::max(mClock, entry.lastSeen);
+        // Duplicate identity keeps the most recent record
+        auto [it, inserted] = mSlots.try_emplace(entry.identity, slot);
+        if (!inserted) {
+            auto& other = record(it->second);
+            if (other.lastSeen < entry.lastSeen) {
+                other.lastSeen = 0;
+                it->second = slot;
+            } else {
+                entry.lastSeen = 0;
+            }
+        }
+    }
+    LOG_INFO("Loaded cached neighbors={} from file={}", mSlots.size(), mPath.string());
+    LOG_INFO("Successfully constructed!");
+}
+
+TTNeighborsCache::~TTNeighborsCache() {
+    LOG_INFO("Destructing...");
+    munmap(mMapping, mBytes);
+    close(mFileDescriptor);
+    LOG_INFO("Successfully destructed!");
+}
+
+bool TTNeighborsCache::store(const std::string& nickname, const std::string& identity, const std::string& ipAddressAndPort) {
+    if (nickname.empty() || nickname.size() >= FIELD_SIZE ||
+        identity.empty() || identity.size() >= FIELD_SIZE ||
+        ipAddressAndPort.empty() || ipAddressAndPort.size() >= ADDRESS_SIZE) {
+        LOG_WARNING("Not caching neighbor (data does not fit), id={}", identity);
+        return false;
+    }
+    size_t slot = 0;
+    if (auto it = mSlots.find(identity); it != mSlots.end()) {
+        slot = it->second;
+    } else {
+        // Free record if any, least recently seen one otherwise
+        for (size_t i = 1; i < mCapacity && record(slot).lastSeen != 0; ++i) {
+            if (record(i).lastSeen < record(slot).lastSeen) {
+                slot = i;
+            }
+        }
+        if (record(slot).lastSeen != 0) {
+            mSlots.erase(record(slot).identity);
+        }
+        mSlots.emplace(identity, slot);
+    }
+    auto& entry = record(slot);
+    entry.lastSeen = 0;
+    std::atomic_signal_fence(std::memory_order_release);
+    copyField(entry.nickname, FIELD_SIZE, nickname);
+    copyField(entry.identity, FIELD_SIZE, identity);
+    copyField(entry.ipAddressAndPort, ADDRESS_SIZE, ipAddressAndPort);
+    std::atomic_signal_fence(std::memory_order_release);
+    entry.lastSeen = tick();
+    return true;
+}
+
+bool TTNeighborsCache::touch(const std::string& identity) {
+    auto it = mSlots.find(identity);
+    if (it == mSlots.end()) {
+        return false;
+    }
+    record(it->second).lastSeen = tick();
+    return true;
+}
+
+std::vector<TTNeighborsCacheEntry> TTNeighborsCache::load() const {
+    std::vector<TTNeighborsCacheEntry> entries;
+    entries.reserve(mSlots.size());
+    for (const auto& [identity, slot] : mSlots) {
+        const auto& entry = record(slot);
+        entries.push_back(TTNeighborsCacheEntry{entry.nickname, entry.identity, entry.ipAddressAndPort,
+            std::chrono::system_clock::time_point(std::chrono::milliseconds(entry.lastSeen))});
+    }
+    std::sort(entries.begin(), entries.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.lastSeen > rhs.lastSeen;
+    });
+    return entries;
+}
+
+TTNeighborsCache::Record& TTNeighborsCache::record(size_t slot) const {
+    auto* records = reinterpret_cast<Record*>(static_cast<char*>(mMapping) + sizeof(Header));
+    return records[slot];
+}
+
+int64_t TTNeighborsCache::tick() {
+    const auto now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch());
+    // Strictly increasing, so updates within the same millisecond keep their order, zero is reserved for free record
+    mClock = std::max<int64_t>(now.count(), mClock + 1);
+    return mClock;
+}
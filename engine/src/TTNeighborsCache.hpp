@@ -0,0 +1,64 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct TTNeighborsCacheEntry {
+    std::string nickname;
+    std::string identity;
+    std::string ipAddressAndPort;
+    std::chrono::system_clock::time_point lastSeen;
+};
+
+// Known neighbors kept in memory-mapped file of fixed size records, every update touches single record in place,
+// so neighbors seen before restart are greeted first (thread-unsafe)
+class TTNeighborsCache {
+public:
+    explicit TTNeighborsCache(const std::filesystem::path& path, size_t capacity = DEFAULT_CAPACITY);
+    virtual ~TTNeighborsCache();
+    TTNeighborsCache(const TTNeighborsCache&) = delete;
+    TTNeighborsCache(TTNeighborsCache&&) = delete;
+    TTNeighborsCache& operator=(const TTNeighborsCache&) = delete;
+    TTNeighborsCache& operator=(TTNeighborsCache&&) = delete;
+    // Inserts or updates neighbor seen now, least recently seen neighbor is evicted if cache is full
+    bool store(const std::string& nickname, const std::string& identity, const std::string& ipAddressAndPort);
+    // Updates last-seen time of cached neighbor, returns false if neighbor is not cached
+    bool touch(const std::string& identity);
+    // Returns cached neighbors, most recently seen first
+    [[nodiscard]] std::vector<TTNeighborsCacheEntry> load() const;
+    [[nodiscard]] size_t size() const { return mSlots.size(); }
+    [[nodiscard]] size_t capacity() const { return mCapacity; }
+private:
+    static inline constexpr size_t FIELD_SIZE = 64;
+    static inline constexpr size_t ADDRESS_SIZE = 32;
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t capacity;
+    };
+    // Zero last-seen marks free record, it is written last, so torn record is never loaded
+    struct Record {
+        int64_t lastSeen;
+        char nickname[FIELD_SIZE];
+        char identity[FIELD_SIZE];
+        char ipAddressAndPort[ADDRESS_SIZE];
+    };
+    [[nodiscard]] Record& record(size_t slot) const;
+    // Returns last-seen time of an update
+    int64_t tick();
+    std::filesystem::path mPath;
+    size_t mCapacity;
+    size_t mBytes = 0;
+    int mFileDescriptor = -1;
+    void* mMapping = nullptr;
+    // Last-seen time of the most recent update, milliseconds since epoch
+    int64_t mClock = 0;
+    // Identity to record index
+    std::unordered_map<std::string, size_t> mSlots;
+    static inline constexpr size_t DEFAULT_CAPACITY = 256;
+    static inline constexpr uint32_t MAGIC = 0x4e435454;
+    static inline constexpr uint32_t VERSION = 1;
+};
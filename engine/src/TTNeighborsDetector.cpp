@@ -0,0 +1,88 @@
+#include "TTNeighborsDetector.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+TTNeighborsDetector::TTNeighborsDetector(const TTNeighborsDetectorSettings& settings) :
+        mSettings(settings) {
+    mSettings.minInterval = std::max(mSettings.minInterval, std::chrono::milliseconds{1});
+    mSettings.maxInterval = std::max(mSettings.maxInterval, mSettings.minInterval);
+    mSettings.window = std::max<size_t>(mSettings.window, 1);
+}
+
+void TTNeighborsDetector::heartbeat(size_t id, Clock::time_point now) {
+    auto [it, inserted] = mNeighbors.try_emplace(id, Neighbor{now, now, mSettings.minInterval, {}});
+    auto& neighbor = it->second;
+    if (!inserted && phi(id, now) >= mSettings.threshold) {
+        // Outage is not learned as a delay, interval is learned again from the start
+        neighbor.interval = mSettings.minInterval;
+    } else if (!inserted) {
+        // Early heartbeat (e.g. neighbor probed the host) is not a negative delay
+        const double delay = std::max(std::chrono::duration<double, std::milli>(now - neighbor.expected).count(), 0.0);
+        neighbor.samples.push_back(delay);
+        neighbor.sum += delay;
+        neighbor.squares += delay * delay;
+        if (neighbor.samples.size() > mSettings.window) {
+            const auto oldest = neighbor.samples.front();
+            neighbor.samples.pop_front();
+            neighbor.sum -= oldest;
+            neighbor.squares -= oldest * oldest;
+        }
+        // Healthy neighbor is probed less often
+        neighbor.interval = std::min(neighbor.interval * 2, mSettings.maxInterval);
+    }
+    neighbor.expected = now + neighbor.interval;
+    neighbor.due = neighbor.expected;
+}
+
+void TTNeighborsDetector::failure(size_t id, Clock::time_point now) {
+    auto it = mNeighbors.find(id);
+    if (it == mNeighbors.end()) {
+        return;
+    }
+    auto& neighbor = it->second;
+    // Missed heartbeat is retried soon, while neighbor already considered failed is probed less and less often
+    neighbor.interval = suspected(id, now) ?
+        std::min(neighbor.interval * 2, mSettings.maxInterval) : mSettings.minInterval;
+    neighbor.due = now + neighbor.interval;
+}
+
+void TTNeighborsDetector::postpone(size_t id, Clock::time_point due) {
+    if (auto it = mNeighbors.find(id); it != mNeighbors.end()) {
+        it->second.due = due;
+    }
+}
+
+double TTNeighborsDetector::phi(size_t id, Clock::time_point now) const {
+    const auto it = mNeighbors.find(id);
+    if (it == mNeighbors.end() || now <= it->second.expected) {
+        return 0.0;
+    }
+    const auto& neighbor = it->second;
+    const auto count = static_cast<double>(neighbor.samples.size());
+    const double mean = count ? neighbor.sum / count : 0.0;
+    const double variance = count ? std::max(neighbor.squares / count - mean * mean, 0.0) : 0.0;
+    const double deviation = std::max(std::sqrt(variance), static_cast<double>(mSettings.minDeviation.count()));
+    const double delay = std::chrono::duration<double, std::milli>(now - neighbor.expected).count();
+    // Probability that the heartbeat is still to come, assuming normal distribution of delays
+    const double probability = 0.5 * std::erfc((delay - mean) / (deviation * std::sqrt(2.0)));
+    return probability > 0.0 ? -std::log10(probability) : std::numeric_limits<double>::infinity();
+}
+
+TTNeighborsDetector::Clock::time_point TTNeighborsDetector::due(size_t id) const {
+    const auto it = mNeighbors.find(id);
+    return it != mNeighbors.end() ? it->second.due : Clock::time_point::max();
+}
+
+TTNeighborsDetector::Clock::time_point TTNeighborsDetector::deadline() const {
+    auto deadline = Clock::time_point::max();
+    for (const auto& [id, neighbor] : mNeighbors) {
+        deadline = std::min(deadline, neighbor.due);
+    }
+    return deadline;
+}
+
+std::chrono::milliseconds TTNeighborsDetector::interval(size_t id) const {
+    const auto it = mNeighbors.find(id);
+    return it != mNeighbors.end() ? it->second.interval : mSettings.minInterval;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <map>
+
+struct TTNeighborsDetectorSettings {
+    // Suspicion level (phi) at which neighbor is considered failed, phi 8 means 1e-8 chance the heartbeat is only late
+    double threshold = DEFAULT_THRESHOLD;
+    // Probe interval of healthy neighbor doubles from min to max, failed probe is retried after min interval
+    std::chrono::milliseconds minInterval = DEFAULT_MIN_INTERVAL;
+    std::chrono::milliseconds maxInterval = DEFAULT_MAX_INTERVAL;
+    // Lower bound of learned deviation, so perfectly regular neighbor is not suspected on first hiccup
+    std::chrono::milliseconds minDeviation = DEFAULT_MIN_DEVIATION;
+    // Number of samples the distribution is learned from
+    size_t window = DEFAULT_WINDOW;
+    static inline constexpr double DEFAULT_THRESHOLD = 8.0;
+    static inline constexpr double MAX_THRESHOLD = 32.0;
+    static inline constexpr std::chrono::milliseconds DEFAULT_MIN_INTERVAL{1000};
+    static inline constexpr std::chrono::milliseconds DEFAULT_MAX_INTERVAL{8000};
+    static inline constexpr std::chrono::milliseconds MAX_INTERVAL{600000};
+    static inline constexpr std::chrono::milliseconds DEFAULT_MIN_DEVIATION{200};
+    static inline constexpr size_t DEFAULT_WINDOW = 100;
+};
+
+// Phi-accrual failure detector, learns per neighbor distribution of heartbeat delays (arrival relative to the time
+// it was expected by the probe schedule) and adapts the probe interval of each neighbor (thread-unsafe)
+class TTNeighborsDetector {
+public:
+    using Clock = std::chrono::steady_clock;
+    explicit TTNeighborsDetector(const TTNeighborsDetectorSettings& settings = {});
+    virtual ~TTNeighborsDetector() = default;
+    TTNeighborsDetector(const TTNeighborsDetector&) = delete;
+    TTNeighborsDetector(TTNeighborsDetector&&) = delete;
+    TTNeighborsDetector& operator=(const TTNeighborsDetector&) = delete;
+    TTNeighborsDetector& operator=(TTNeighborsDetector&&) = delete;
+    // Neighbor is alive (answered probe or sent heartbeat itself), it is tracked from the first heartbeat
+    void heartbeat(size_t id, Clock::time_point now);
+    // Probe failed, neighbor is probed again soon, suspected neighbor is probed with backoff
+    void failure(size_t id, Clock::time_point now);
+    // Probe is in flight, neighbor is not due until then, suspicion level is not affected
+    void postpone(size_t id, Clock::time_point due);
+    // Suspicion level, 0 until the heartbeat is expected, then grows according to learned distribution
+    [[nodiscard]] double phi(size_t id, Clock::time_point now) const;
+    [[nodiscard]] bool suspected(size_t id, Clock::time_point now) const { return phi(id, now) >= mSettings.threshold; }
+    // Point in time when neighbor is to be probed, max if it is not tracked
+    [[nodiscard]] Clock::time_point due(size_t id) const;
+    // Earliest point in time when any neighbor is to be probed, max if there is nothing to probe
+    [[nodiscard]] Clock::time_point deadline() const;
+    [[nodiscard]] std::chrono::milliseconds interval(size_t id) const;
+    [[nodiscard]] size_t size() const { return mNeighbors.size(); }
+private:
+    struct Neighbor {
+        Clock::time_point expected;
+        Clock::time_point due;
+        std::chrono::milliseconds interval;
+        // Delays in milliseconds, with running sums for mean and deviation
+        std::deque<double> samples;
+        double sum = 0.0;
+        double squares = 0.0;
+    };
+    TTNeighborsDetectorSettings mSettings;
+    std::map<size_t, Neighbor> mNeighbors;
+};
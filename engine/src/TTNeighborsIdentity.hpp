@@ -0,0 +1,48 @@
+#pragma once
+#include "TTContactsKey.hpp"
+#include <optional>
+#include <string>
+
+// Identity on the wire, SHA-1 hex string (as made by tteams.sh) is sent as 20 raw bytes in the key field,
+// identity of any other format is sent as it is in the identity field, receiver resolves the key without unpacking
+class TTNeighborsIdentity {
+public:
+    // Returns 20 bytes key, nullopt if identity is not lowercase SHA-1 hex string
+    [[nodiscard]] static std::optional<std::string> pack(const std::string& identity) {
+        return TTContactsKey::pack(identity);
+    }
+    [[nodiscard]] static std::string unpack(const std::string& key) {
+        return TTContactsKey::unpack(key);
+    }
+    template <typename Message>
+    static void set(Message& message, const std::string& identity) {
+        if (auto key = pack(identity)) {
+            message.set_key(std::move(key.value()));
+        } else {
+            message.set_identity(identity);
+        }
+    }
+    // Returns key (or identity of other format) carried by the message, empty if it carries none
+    // (following requests of the stream)
+    template <typename Message>
+    [[nodiscard]] static std::string get(const Message& message) {
+        return message.key().empty() ? message.identity() : message.key();
+    }
+    template <typename Message>
+    [[nodiscard]] static bool has(const Message& message) {
+        return !message.key().empty() || !message.identity().empty();
+    }
+    // Target of the indirect probe
+    template <typename Request>
+    static void setTarget(Request& request, const std::string& identity) {
+        if (auto key = pack(identity)) {
+            request.set_targetkey(std::move(key.value()));
+        } else {
+            request.set_target(identity);
+        }
+    }
+    template <typename Request>
+    [[nodiscard]] static std::string getTarget(const Request& request) {
+        return request.targetkey().empty() ? request.target() : request.targetkey();
+    }
+};
@@ -0,0 +1,33 @@
+#pragma once
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <optional>
+
+// Last successful contact with each neighbor, updated by both broadcasters (delivered or received chat messages,
+// answered heartbeats), so that discovery does not probe neighbors which have just proven liveness (thread-safe)
+class TTNeighborsLiveness {
+public:
+    using Clock = std::chrono::steady_clock;
+    TTNeighborsLiveness() = default;
+    virtual ~TTNeighborsLiveness() = default;
+    TTNeighborsLiveness(const TTNeighborsLiveness&) = delete;
+    TTNeighborsLiveness(TTNeighborsLiveness&&) = delete;
+    TTNeighborsLiveness& operator=(const TTNeighborsLiveness&) = delete;
+    TTNeighborsLiveness& operator=(TTNeighborsLiveness&&) = delete;
+    // Neighbor responded or sent something itself
+    void contact(size_t id, Clock::time_point now = Clock::now()) {
+        std::scoped_lock lock(mMutex);
+        auto& last = mContacts[id];
+        last = std::max(last, now);
+    }
+    // Returns point in time of the last successful contact, if there was any
+    [[nodiscard]] std::optional<Clock::time_point> last(size_t id) const {
+        std::scoped_lock lock(mMutex);
+        const auto it = mContacts.find(id);
+        return it != mContacts.end() ? std::optional(it->second) : std::nullopt;
+    }
+private:
+    mutable std::mutex mMutex;
+    std::map<size_t, Clock::time_point> mContacts;
+};
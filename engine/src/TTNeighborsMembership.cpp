@@ -0,0 +1,143 @@
+#include "TTNeighborsMembership.hpp"
+#include "TTContactsKey.hpp"
+#include "TTDiagnosticsLogger.hpp"
+#include <algorithm>
+#include <bit>
+
+TTNeighborsMembership::TTNeighborsMembership(size_t indirectProbes, size_t maxPiggyback) :
+        mIncarnation{0},
+        mIndirectProbes(indirectProbes),
+        mMaxPiggyback(maxPiggyback),
+        mRandomNumberGenerator(std::random_device{}()) {}
+
+bool TTNeighborsMembership::add(size_t id, const std::string& identity) {
+    auto [it, inserted] = mMembers.try_emplace(id, Member{identity, 0, true});
+    if (!inserted) {
+        return false;
+    }
+    mIds[TTContactsKey::make(identity)] = id;
+    disseminate(TTMemberUpdate(identity, 0, true));
+    return true;
+}
+
+std::optional<size_t> TTNeighborsMembership::next(const std::function<bool(size_t)>& eligible) {
+    // Round is refilled at most once, so members never eligible are not looped over
+    for (size_t pass = 0; pass < 2; ++pass) {
+        while (!mRound.empty()) {
+            const auto id = mRound.back();
+            mRound.pop_back();
+            if (mMembers.contains(id) && eligible(id)) {
+                return id;
+            }
+        }
+        for (const auto& [id, member] : mMembers) {
+            mRound.push_back(id);
+        }
+        std::shuffle(mRound.begin(), mRound.end(), mRandomNumberGenerator);
+    }
+    return std::nullopt;
+}
+
+std::vector<size_t> TTNeighborsMembership::helpers(size_t target) {
+    std::vector<size_t> candidates;
+    for (const auto& [id, member] : mMembers) {
+        if (id != target && member.alive) {
+            candidates.push_back(id);
+        }
+    }
+    std::shuffle(candidates.begin(), candidates.end(), mRandomNumberGenerator);
+    candidates.resize(std::min(candidates.size(), mIndirectProbes));
+    return candidates;
+}
+
+std::vector<size_t> TTNeighborsMembership::sample(size_t k) {
+    std::vector<size_t> candidates;
+    for (const auto& [id, member] : mMembers) {
+        if (member.alive) {
+            candidates.push_back(id);
+        }
+    }
+    std::shuffle(candidates.begin(), candidates.end(), mRandomNumberGenerator);
+    candidates.resize(std::min(candidates.size(), k));
+    return candidates;
+}
+
+bool TTNeighborsMembership::observe(size_t id, bool alive) {
+    auto it = mMembers.find(id);
+    if (it == mMembers.end() || it->second.alive == alive) {
+        return false;
+    }
+    auto& member = it->second;
+    member.alive = alive;
+    // Only the member itself refutes its failure (with higher incarnation), so only failures are gossiped
+    if (!alive) {
+        disseminate(TTMemberUpdate(member.identity, member.incarnation, false));
+    }
+    return true;
+}
+
+std::optional<std::pair<size_t, bool>> TTNeighborsMembership::apply(const TTMemberUpdate& update, const std::string& identity) {
+    if (TTContactsKey::same(update.identity, identity)) {
+        if (!update.alive && update.incarnation >= mIncarnation) {
+            LOG_WARNING("Refuting failure of itself, incarnation={}", update.incarnation);
+            mIncarnation = update.incarnation + 1;
+            disseminate(TTMemberUpdate(identity, mIncarnation, true));
+        }
+        return std::nullopt;
+    }
+    const auto packed = TTContactsKey::pack(update.identity);
+    const auto idIt = mIds.find(packed ? std::string_view(packed.value()) : std::string_view(update.identity));
+    if (idIt == mIds.end()) {
+        return std::nullopt;
+    }
+    auto& member = mMembers.at(idIt->second);
+    // Newer incarnation wins, failure wins within the same incarnation
+    const bool newer = update.incarnation > member.incarnation;
+    const bool overrides = (update.incarnation == member.incarnation) && !update.alive && member.alive;
+    if (!newer && !overrides) {
+        return std::nullopt;
+    }
+    member.incarnation = update.incarnation;
+    // Gossip is kept with identity as it is, even if update carried packed key
+    disseminate(TTMemberUpdate(member.identity, update.incarnation, update.alive));
+    if (member.alive == update.alive) {
+        return std::nullopt;
+    }
+    member.alive = update.alive;
+    return std::pair{idIt->second, update.alive};
+}
+
+std::deque<TTMemberUpdate> TTNeighborsMembership::updates() {
+    std::deque<TTMemberUpdate> result;
+    std::deque<Gossip> sent;
+    while (!mGossips.empty() && result.size() < mMaxPiggyback) {
+        auto gossip = std::move(mGossips.front());
+        mGossips.pop_front();
+        result.push_back(gossip.update);
+        if (--gossip.transmissions) {
+            sent.push_back(std::move(gossip));
+        }
+    }
+    // Sent updates go to the back, so others get their turn
+    std::move(sent.begin(), sent.end(), std::back_inserter(mGossips));
+    return result;
+}
+
+bool TTNeighborsMembership::alive(size_t id) const {
+    const auto it = mMembers.find(id);
+    return it != mMembers.end() && it->second.alive;
+}
+
+std::string TTNeighborsMembership::identity(size_t id) const {
+    const auto it = mMembers.find(id);
+    return it != mMembers.end() ? it->second.identity : std::string{};
+}
+
+void TTNeighborsMembership::disseminate(const TTMemberUpdate& update) {
+    std::erase_if(mGossips, [&](const auto& gossip) { return gossip.update.identity == update.identity; });
+    mGossips.push_back(Gossip{update, transmissions()});
+}
+
+size_t TTNeighborsMembership::transmissions() const {
+    return RETRANSMIT_MULTIPLIER * std::bit_width(mMembers.size() + 1);
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "TTNeighborsMessage.hpp"
+#include <deque>
+#include <functional>
+#include <map>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+// SWIM membership state: probe order, indirect probe helpers and gossip dissemination (thread-unsafe)
+class TTNeighborsMembership {
+public:
+    explicit TTNeighborsMembership(size_t indirectProbes = INDIRECT_PROBES, size_t maxPiggyback = MAX_PIGGYBACK);
+    virtual ~TTNeighborsMembership() = default;
+    TTNeighborsMembership(const TTNeighborsMembership&) = delete;
+    TTNeighborsMembership(TTNeighborsMembership&&) = delete;
+    TTNeighborsMembership& operator=(const TTNeighborsMembership&) = delete;
+    TTNeighborsMembership& operator=(TTNeighborsMembership&&) = delete;
+    // Adds alive member, returns false if already present
+    bool add(size_t id, const std::string& identity);
+    // Returns next member to be probed, each member is probed once per round in random order
+    [[nodiscard]] std::optional<size_t> next(const std::function<bool(size_t)>& eligible);
+    // Returns up to k random alive members, except the target, used for indirect probe
+    [[nodiscard]] std::vector<size_t> helpers(size_t target);
+    // Returns up to k random alive members, used for peer exchange
+    [[nodiscard]] std::vector<size_t> sample(size_t k);
+    // Local observation, returns true if state changed
+    bool observe(size_t id, bool alive);
+    // Applies received update, returns member and its new state if state changed,
+    // failure of the host itself (identity) is refuted
+    std::optional<std::pair<size_t, bool>> apply(const TTMemberUpdate& update, const std::string& identity);
+    // Returns updates to be piggybacked, each update is sent limited number of times
+    [[nodiscard]] std::deque<TTMemberUpdate> updates();
+    // Returns true if there are updates to be piggybacked
+    [[nodiscard]] bool pending() const { return !mGossips.empty(); }
+    [[nodiscard]] bool alive(size_t id) const;
+    [[nodiscard]] std::string identity(size_t id) const;
+    [[nodiscard]] size_t size() const { return mMembers.size(); }
+private:
+    struct Member {
+        std::string identity;
+        uint64_t incarnation = 0;
+        bool alive = true;
+    };
+    struct Gossip {
+        TTMemberUpdate update;
+        size_t transmissions;
+    };
+    void disseminate(const TTMemberUpdate& update);
+    [[nodiscard]] size_t transmissions() const;
+    uint64_t mIncarnation;
+    const size_t mIndirectProbes;
+    const size_t mMaxPiggyback;
+    std::map<size_t, Member> mMembers;
+    // Members by key (packed identity), so updates received from the network are resolved without unpacking
+    std::map<std::string, size_t, std::less<>> mIds;
+    std::deque<Gossip> mGossips;
+    std::vector<size_t> mRound;
+    std::mt19937 mRandomNumberGenerator;
+    static inline constexpr size_t INDIRECT_PROBES = 3;
+    static inline constexpr size_t MAX_PIGGYBACK = 8;
+    // Each update is retransmitted multiplier * log2(N) times
+    static inline constexpr size_t RETRANSMIT_MULTIPLIER = 3;
+};
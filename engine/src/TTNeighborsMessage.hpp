@@ -1,9 +1,11 @@
 #pragma once
 #include <string>
 #include <deque>
+#include <cstdint>
 
 struct TTTellRequest final {
-    TTTellRequest(const std::string& identity, const std::string& message) : identity(identity), message(message) {}
+    TTTellRequest(const std::string& identity, const std::string& message, uint64_t epoch = 0, uint64_t sequence = 0) :
+        identity(identity), message(message), epoch(epoch), sequence(sequence) {}
     TTTellRequest() = default;
     ~TTTellRequest() = default;
     TTTellRequest(const TTTellRequest&) = default;
@@ -11,10 +13,13 @@ struct TTTellRequest final {
     TTTellRequest& operator=(const TTTellRequest&) = default;
     TTTellRequest& operator=(TTTellRequest&&) = default;
     bool operator==(const TTTellRequest& rhs) const {
-        return identity == rhs.identity && message == rhs.message;
+        return identity == rhs.identity && message == rhs.message && epoch == rhs.epoch && sequence == rhs.sequence;
     }
     std::string identity;
     std::string message;
+    // Sender session and per-neighbor sequence number (0 if unsequenced)
+    uint64_t epoch = 0;
+    uint64_t sequence = 0;
 };
 
 struct TTTellResponse final {
@@ -29,8 +34,8 @@ struct TTTellResponse final {
 };
 
 struct TTNarrateRequest final {
-    TTNarrateRequest(const std::string& identity, const std::deque<std::string>& messages) :
-        identity(identity), messages(messages) {}
+    TTNarrateRequest(const std::string& identity, const std::deque<std::string>& messages, uint64_t epoch = 0, uint64_t sequence = 0) :
+        identity(identity), messages(messages), epoch(epoch), sequence(sequence) {}
     TTNarrateRequest() = default;
     ~TTNarrateRequest() = default;
     TTNarrateRequest(const TTNarrateRequest&) = default;
@@ -38,10 +43,13 @@ struct TTNarrateRequest final {
     TTNarrateRequest& operator=(const TTNarrateRequest&) = default;
     TTNarrateRequest& operator=(TTNarrateRequest&&) = default;
     bool operator==(const TTNarrateRequest& rhs) const {
-        return identity == rhs.identity && messages == rhs.messages;
+        return identity == rhs.identity && messages == rhs.messages && epoch == rhs.epoch && sequence == rhs.sequence;
     }
     std::string identity;
     std::deque<std::string> messages;
+    // Sender session and sequence number of the first message, following messages are numbered consecutively
+    uint64_t epoch = 0;
+    uint64_t sequence = 0;
 };
 
 struct TTNarrateResponse final {
@@ -55,6 +63,37 @@ struct TTNarrateResponse final {
     bool status;
 };
 
+struct TTConverseRequest final {
+    TTConverseRequest(const std::string& identity, const std::deque<std::string>& messages, uint64_t epoch = 0, uint64_t sequence = 0) :
+        identity(identity), messages(messages), epoch(epoch), sequence(sequence) {}
+    TTConverseRequest() = default;
+    ~TTConverseRequest() = default;
+    TTConverseRequest(const TTConverseRequest&) = default;
+    TTConverseRequest(TTConverseRequest&&) = default;
+    TTConverseRequest& operator=(const TTConverseRequest&) = default;
+    TTConverseRequest& operator=(TTConverseRequest&&) = default;
+    bool operator==(const TTConverseRequest& rhs) const {
+        return identity == rhs.identity && messages == rhs.messages && epoch == rhs.epoch && sequence == rhs.sequence;
+    }
+    std::string identity;
+    std::deque<std::string> messages;
+    // Sender session and sequence number of the first message, following messages are numbered consecutively
+    uint64_t epoch = 0;
+    uint64_t sequence = 0;
+};
+
+struct TTConverseResponse final {
+    TTConverseResponse(bool status, size_t acknowledged) : status(status), acknowledged(acknowledged) {}
+    TTConverseResponse() = default;
+    ~TTConverseResponse() = default;
+    TTConverseResponse(const TTConverseResponse&) = default;
+    TTConverseResponse(TTConverseResponse&&) = default;
+    TTConverseResponse& operator=(const TTConverseResponse&) = default;
+    TTConverseResponse& operator=(TTConverseResponse&&) = default;
+    bool status;
+    size_t acknowledged;
+};
+
 struct TTGreetRequest final {
     TTGreetRequest(const std::string& nickname, const std::string& identity, const std::string& ipAddressAndPort) :
         nickname(nickname), identity(identity), ipAddressAndPort(ipAddressAndPort) {}
@@ -72,9 +111,46 @@ struct TTGreetRequest final {
     std::string ipAddressAndPort;
 };
 
+struct TTBeaconRequest final {
+    TTBeaconRequest(const std::string& nickname, const std::string& identity, const std::string& ipAddressAndPort) :
+        nickname(nickname), identity(identity), ipAddressAndPort(ipAddressAndPort) {}
+    TTBeaconRequest() = default;
+    ~TTBeaconRequest() = default;
+    TTBeaconRequest(const TTBeaconRequest&) = default;
+    TTBeaconRequest(TTBeaconRequest&&) = default;
+    TTBeaconRequest& operator=(const TTBeaconRequest&) = default;
+    TTBeaconRequest& operator=(TTBeaconRequest&&) = default;
+    bool operator==(const TTBeaconRequest& rhs) const {
+        return nickname == rhs.nickname && identity == rhs.identity && ipAddressAndPort == rhs.ipAddressAndPort;
+    }
+    std::string nickname;
+    std::string identity;
+    std::string ipAddressAndPort;
+};
+
+struct TTPeer final {
+    TTPeer(const std::string& nickname, const std::string& identity, const std::string& ipAddressAndPort) :
+        nickname(nickname), identity(identity), ipAddressAndPort(ipAddressAndPort) {}
+    TTPeer() = default;
+    ~TTPeer() = default;
+    TTPeer(const TTPeer&) = default;
+    TTPeer(TTPeer&&) = default;
+    TTPeer& operator=(const TTPeer&) = default;
+    TTPeer& operator=(TTPeer&&) = default;
+    bool operator==(const TTPeer& rhs) const {
+        return nickname == rhs.nickname && identity == rhs.identity && ipAddressAndPort == rhs.ipAddressAndPort;
+    }
+    std::string nickname;
+    std::string identity;
+    std::string ipAddressAndPort;
+};
+
 struct TTGreetResponse final {
     TTGreetResponse(bool status, const std::string& nickname, const std::string& identity, const std::string& ipAddressAndPort) :
         status(status), nickname(nickname), identity(identity), ipAddressAndPort(ipAddressAndPort) {}
+    TTGreetResponse(bool status, const std::string& nickname, const std::string& identity, const std::string& ipAddressAndPort,
+        const std::deque<TTPeer>& peers) :
+        status(status), nickname(nickname), identity(identity), ipAddressAndPort(ipAddressAndPort), peers(peers) {}
     TTGreetResponse() = default;
     ~TTGreetResponse() = default;
     TTGreetResponse(const TTGreetResponse&) = default;
@@ -85,10 +161,31 @@ struct TTGreetResponse final {
     std::string nickname;
     std::string identity;
     std::string ipAddressAndPort;
+    // Live peers known to the responder
+    std::deque<TTPeer> peers;
+};
+
+struct TTMemberUpdate final {
+    TTMemberUpdate(const std::string& identity, uint64_t incarnation, bool alive) :
+        identity(identity), incarnation(incarnation), alive(alive) {}
+    TTMemberUpdate() = default;
+    ~TTMemberUpdate() = default;
+    TTMemberUpdate(const TTMemberUpdate&) = default;
+    TTMemberUpdate(TTMemberUpdate&&) = default;
+    TTMemberUpdate& operator=(const TTMemberUpdate&) = default;
+    TTMemberUpdate& operator=(TTMemberUpdate&&) = default;
+    bool operator==(const TTMemberUpdate& rhs) const {
+        return identity == rhs.identity && incarnation == rhs.incarnation && alive == rhs.alive;
+    }
+    std::string identity;
+    uint64_t incarnation = 0;
+    bool alive = false;
 };
 
 struct TTHeartbeatRequest final {
     TTHeartbeatRequest(const std::string& identity) : identity(identity) {}
+    TTHeartbeatRequest(const std::string& identity, const std::deque<TTMemberUpdate>& updates, const std::string& target = {}) :
+        identity(identity), updates(updates), target(target) {}
     TTHeartbeatRequest() = default;
     ~TTHeartbeatRequest() = default;
     TTHeartbeatRequest(const TTHeartbeatRequest&) = default;
@@ -96,13 +193,17 @@ struct TTHeartbeatRequest final {
     TTHeartbeatRequest& operator=(const TTHeartbeatRequest&) = default;
     TTHeartbeatRequest& operator=(TTHeartbeatRequest&&) = default;
     bool operator==(const TTHeartbeatRequest& rhs) const {
-        return identity == rhs.identity;
+        return identity == rhs.identity && updates == rhs.updates && target == rhs.target;
     }
     std::string identity;
+    std::deque<TTMemberUpdate> updates;
+    std::string target;
 };
 
 struct TTHeartbeatResponse final {
     TTHeartbeatResponse(bool status, const std::string& identity) : status(status), identity(identity) {}
+    TTHeartbeatResponse(bool status, const std::string& identity, const std::deque<TTMemberUpdate>& updates) :
+        status(status), identity(identity), updates(updates) {}
     TTHeartbeatResponse() = default;
     ~TTHeartbeatResponse() = default;
     TTHeartbeatResponse(const TTHeartbeatResponse&) = default;
@@ -111,4 +212,5 @@ struct TTHeartbeatResponse final {
     TTHeartbeatResponse& operator=(TTHeartbeatResponse&&) = default;
     bool status;
     std::string identity;
+    std::deque<TTMemberUpdate> updates;
 };
@@ -0,0 +1,142 @@
+#include "TTNeighborsPulse.hpp"
+#include "TTDiagnosticsLogger.hpp"
+#include <cstring>
+#include <optional>
+#include <endian.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+TTNeighborsPulse::TTNeighborsPulse(const std::string& ipAddress,
+                                   uint16_t port,
+                                   const std::string& identity,
+                                   TTNeighborsLiveness& liveness) :
+        mLiveness(liveness),
+        mPort(port),
+        mHash(hash(identity)) {
+    LOG_INFO("Constructing...");
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(mPort);
+    if (inet_pton(AF_INET, ipAddress.c_str(), &address.sin_addr) != 1) {
+        throw std::runtime_error("TTNeighborsPulse: Invalid IP address=" + ipAddress);
+    }
+    mSocket = socket(AF_INET, SOCK_DGRAM, 0);
+    if (mSocket < 0) {
+        throw std::runtime_error("TTNeighborsPulse: Failed to create socket");
+    }
+    if (bind(mSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        close(mSocket);
+        throw std::runtime_error("TTNeighborsPulse: Failed to bind socket=" + ipAddress + ":" + std::to_string(mPort));
+    }
+    LOG_INFO("Successfully constructed!");
+}
+
+TTNeighborsPulse::~TTNeighborsPulse() {
+    LOG_INFO("Destructing...");
+    stop();
+    if (mSocket >= 0) {
+        close(mSocket);
+    }
+    LOG_INFO("Successfully destructed!");
+}
+
+void TTNeighborsPulse::run() {
+    LOG_INFO("Started pulse loop");
+    while (!isStopped()) {
+        pollfd descriptor{mSocket, POLLIN, 0};
+        const auto result = poll(&descriptor, 1, POLL_TIMEOUT.count());
+        if (result < 0 && errno != EINTR) [[unlikely]] {
+            LOG_ERROR("Failed to poll pulse socket!");
+            stop();
+            break;
+        }
+        if (result > 0 && (descriptor.revents & POLLIN)) {
+            // Socket is drained at once, so burst of pongs is handled in single wakeup
+            while (receive()) {}
+        }
+    }
+    LOG_INFO("Stopped pulse loop");
+}
+
+bool TTNeighborsPulse::add(size_t id, const std::string& identity, const std::string& ipAddress) {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(mPort);
+    if (inet_pton(AF_INET, ipAddress.c_str(), &address.sin_addr) != 1) {
+        LOG_WARNING("Failed to add pulse neighbor, invalid IP address={}", ipAddress);
+        return false;
+    }
+    std::scoped_lock lock(mPeersMutex);
+    auto& peer = mPeers[id];
+    mIds.erase(peer.hash);
+    peer.hash = hash(identity);
+    peer.address = address;
+    mIds[peer.hash] = id;
+    return true;
+}
+
+bool TTNeighborsPulse::ping(size_t id) {
+    Peer peer;
+    {
+        std::scoped_lock lock(mPeersMutex);
+        const auto it = mPeers.find(id);
+        if (it == mPeers.end()) {
+            return false;
+        }
+        peer = it->second;
+        peer.sequence = ++it->second.sequence;
+    }
+    return send(Type::PING, peer.sequence, peer.hash, peer.address);
+}
+
+uint64_t TTNeighborsPulse::hash(const std::string& identity) {
+    uint64_t result = 14695981039346656037ULL;
+    for (const auto character : identity) {
+        result ^= static_cast<uint8_t>(character);
+        result *= 1099511628211ULL;
+    }
+    return result;
+}
+
+bool TTNeighborsPulse::send(Type type, uint32_t sequence, uint64_t target, const sockaddr_in& address) {
+    const Datagram datagram{htons(MAGIC), VERSION, type, htonl(sequence), htobe64(mHash), htobe64(target)};
+    const auto sent = sendto(mSocket, &datagram, sizeof(datagram), 0, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+    return sent == static_cast<ssize_t>(sizeof(datagram));
+}
+
+bool TTNeighborsPulse::receive() {
+    Datagram datagram;
+    sockaddr_in address{};
+    socklen_t length = sizeof(address);
+    const auto received = recvfrom(mSocket, &datagram, sizeof(datagram), MSG_DONTWAIT, reinterpret_cast<sockaddr*>(&address), &length);
+    if (received < 0) {
+        return false;
+    }
+    // Datagrams of other protocols or addressed to previous identity of the host are ignored
+    if (received != sizeof(datagram) || ntohs(datagram.magic) != MAGIC || datagram.version != VERSION ||
+        be64toh(datagram.target) != mHash) {
+        return true;
+    }
+    const auto sender = be64toh(datagram.sender);
+    if (datagram.type == Type::PING) {
+        if (!send(Type::PONG, ntohl(datagram.sequence), sender, address)) {
+            LOG_WARNING("Failed to send pong!");
+        }
+    } else if (datagram.type != Type::PONG) {
+        return true;
+    }
+    // Ping of the neighbor proves it is alive as well as its pong would
+    std::optional<size_t> id;
+    {
+        std::scoped_lock lock(mPeersMutex);
+        if (const auto it = mIds.find(sender); it != mIds.end()) {
+            id = it->second;
+        }
+    }
+    if (id) {
+        mLiveness.contact(id.value());
+    }
+    return true;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include "TTNeighborsLiveness.hpp"
+#include "TTUtilsStopable.hpp"
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <netinet/in.h>
+
+// Lightweight heartbeat channel, fixed size UDP datagrams (identity hashes and sequence number) instead of gRPC
+// calls, single socket serves all neighbors, answered pings are recorded as contacts (thread-safe)
+class TTNeighborsPulse : public TTUtilsStopable {
+public:
+    TTNeighborsPulse(const std::string& ipAddress, uint16_t port, const std::string& identity, TTNeighborsLiveness& liveness);
+    virtual ~TTNeighborsPulse();
+    TTNeighborsPulse(const TTNeighborsPulse&) = delete;
+    TTNeighborsPulse(TTNeighborsPulse&&) = delete;
+    TTNeighborsPulse& operator=(const TTNeighborsPulse&) = delete;
+    TTNeighborsPulse& operator=(TTNeighborsPulse&&) = delete;
+    // Receiver loop, answers pings and records pongs
+    virtual void run();
+    // Registers (or updates) neighbor listening on the same port, returns false on invalid address
+    bool add(size_t id, const std::string& identity, const std::string& ipAddress);
+    // Sends ping to registered neighbor, answer is recorded as contact by the receiver loop
+    bool ping(size_t id);
+    // Compact identity carried by datagrams (FNV-1a)
+    [[nodiscard]] static uint64_t hash(const std::string& identity);
+private:
+    enum class Type : uint8_t {
+        PING = 1,
+        PONG = 2,
+    };
+    // Fields in network byte order
+    struct Datagram {
+        uint16_t magic;
+        uint8_t version;
+        Type type;
+        uint32_t sequence;
+        uint64_t sender;
+        uint64_t target;
+    };
+    static_assert(sizeof(Datagram) == 24);
+    struct Peer {
+        uint64_t hash = 0;
+        sockaddr_in address{};
+        uint32_t sequence = 0;
+    };
+    bool send(Type type, uint32_t sequence, uint64_t target, const sockaddr_in& address);
+    bool receive();
+    TTNeighborsLiveness& mLiveness;
+    int mSocket = -1;
+    uint16_t mPort;
+    const uint64_t mHash;
+    std::mutex mPeersMutex;
+    std::map<size_t, Peer> mPeers;
+    std::map<uint64_t, size_t> mIds;
+    static inline constexpr uint16_t MAGIC = 0x5454;
+    static inline constexpr uint8_t VERSION = 1;
+    // Upper bound of the time needed to notice stop
+    static inline constexpr std::chrono::milliseconds POLL_TIMEOUT{100};
+};
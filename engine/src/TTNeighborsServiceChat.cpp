@@ -1,4 +1,5 @@
 #include "TTNeighborsServiceChat.hpp"
+#include "TTNeighborsIdentity.hpp"
 #include "TTDiagnosticsLogger.hpp"
 
 TTNeighborsServiceChat::TTNeighborsServiceChat(TTBroadcasterChat& handler) : mHandler(handler) {
@@ -19,9 +20,10 @@ grpc::Status TTNeighborsServiceChat::Tell(grpc::ServerContext* context, const tt
         LOG_ERROR("Reply is null!");
         return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Reply is null!");
     }
-    const TTTellRequest message(request->identity(), request->message());
+    const TTTellRequest message(TTNeighborsIdentity::get(*request), request->message(), request->epoch(), request->sequence());
     if (mHandler.handleReceive(message)) [[likely]] {
-        reply->set_identity(mHandler.getIdentity());
+        TTNeighborsIdentity::set(*reply, mHandler.getIdentity());
+        reply->set_sequence(request->sequence());
         LOG_INFO("Successfully handled request!");
         return grpc::Status::OK;
     }
@@ -43,24 +45,117 @@ grpc::Status TTNeighborsServiceChat::Narrate(grpc::ServerContext* context, grpc:
         LOG_ERROR("Reply is null!");
         return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Reply is null!");
     }
+    // Single arena-allocated request is parsed over and over, its strings are moved out
+    google::protobuf::Arena arena;
+    auto* request = google::protobuf::Arena::CreateMessage<tt::NarrateRequest>(&arena);
     TTNarrateRequest message;
-    tt::NarrateRequest request;
-    std::set<size_t> uniqueIds;
-    std::hash<std::string> hasher;
+    bool unique = true;
     grpc::ServerReaderInterface<tt::NarrateRequest>* istream = stream;
-    while (istream->Read(&request)) {
-        message.identity = request.identity();
-        message.messages.push_back(request.message());
-        uniqueIds.insert(hasher(message.identity));
+    while (istream->Read(request)) {
+        // Stream is drained even if identity does not match
+        unique = unique && appendNarrate(message, *request);
     }
-    if (uniqueIds.size() != 1) {
+    if (!unique) {
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Wrong number of unique ids!");
+    }
+    return handleNarrate(context, message, reply);
+}
+
+bool TTNeighborsServiceChat::appendNarrate(TTNarrateRequest& message, tt::NarrateRequest& request) {
+    if (message.messages.empty()) {
+        // Key is resolved by the contacts as it is, so it is not unpacked
+        if (request.key().empty()) {
+            message.identity.swap(*request.mutable_identity());
+        } else {
+            message.identity.swap(*request.mutable_key());
+        }
+        message.epoch = request.epoch();
+        message.sequence = request.sequence();
+    } else if (TTNeighborsIdentity::has(request) && TTNeighborsIdentity::get(request) != message.identity) {
+        return false;
+    }
+    message.messages.emplace_back().swap(*request.mutable_message());
+    return true;
+}
+
+grpc::Status TTNeighborsServiceChat::handleNarrate(grpc::ServerContext* context, const TTNarrateRequest& message, tt::NarrateReply* reply) {
+    if (!context) {
+        LOG_ERROR("Context is null!");
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Context is null!");
+    }
+    if (!reply) {
+        LOG_ERROR("Reply is null!");
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Reply is null!");
+    }
+    if (message.messages.empty()) {
         return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Wrong number of unique ids!");
     }
     if (mHandler.handleReceive(message)) [[likely]] {
-        reply->set_identity(mHandler.getIdentity());
+        TTNeighborsIdentity::set(*reply, mHandler.getIdentity());
+        // Messages are numbered consecutively by the sender
+        reply->set_sequence(message.sequence ? message.sequence + message.messages.size() - 1 : 0);
         LOG_INFO("Successfully handled request!");
         return grpc::Status::OK;
     }
     LOG_ERROR("Failed to handle request!");
     return grpc::Status(grpc::StatusCode::UNKNOWN, "Failed to handle request!");
 }
+
+grpc::Status TTNeighborsServiceChat::Converse(grpc::ServerContext* context, grpc::ServerReaderWriter<tt::ConverseReply, tt::ConverseRequest>* stream) {
+    LOG_INFO("Handling converse...");
+    if (!context) {
+        LOG_ERROR("Context is null!");
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Context is null!");
+    }
+    if (!stream) {
+        LOG_ERROR("Stream is null!");
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Stream is null!");
+    }
+    tt::ConverseRequest request;
+    std::string identity;
+    grpc::ServerReaderWriterInterface<tt::ConverseReply, tt::ConverseRequest>* iostream = stream;
+    while (iostream->Read(&request)) {
+        tt::ConverseReply reply;
+        const auto status = handleConverse(context, &request, identity, &reply);
+        if (!status.ok()) [[unlikely]] {
+            return status;
+        }
+        if (!iostream->Write(reply)) [[unlikely]] {
+            LOG_WARNING("Converse stream closed while acknowledging!");
+            break;
+        }
+    }
+    LOG_INFO("Successfully handled converse!");
+    return grpc::Status::OK;
+}
+
+grpc::Status TTNeighborsServiceChat::handleConverse(grpc::ServerContext* context, const tt::ConverseRequest* request, std::string& identity, tt::ConverseReply* reply) {
+    if (!context) {
+        LOG_ERROR("Context is null!");
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Context is null!");
+    }
+    if (!request) {
+        LOG_ERROR("Request is null!");
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Request is null!");
+    }
+    if (!reply) {
+        LOG_ERROR("Reply is null!");
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Reply is null!");
+    }
+    // Identity is carried by the first request of the stream only
+    if (TTNeighborsIdentity::has(*request)) {
+        identity = TTNeighborsIdentity::get(*request);
+    }
+    if (identity.empty()) {
+        LOG_ERROR("Identity is missing!");
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Identity is missing!");
+    }
+    const TTTellRequest message(identity, request->message(), request->epoch(), request->sequence());
+    if (mHandler.handleReceive(message)) [[likely]] {
+        TTNeighborsIdentity::set(*reply, mHandler.getIdentity());
+        reply->set_sequence(request->sequence());
+        return grpc::Status::OK;
+    }
+    LOG_ERROR("Failed to handle request!");
+    return grpc::Status(grpc::StatusCode::UNKNOWN, "Failed to handle request!");
+}
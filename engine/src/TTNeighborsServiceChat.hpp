@@ -13,6 +13,16 @@ public:
     TTNeighborsServiceChat& operator=(TTNeighborsServiceChat&&) = delete;
     [[nodiscard]] grpc::Status Tell(grpc::ServerContext* context, const tt::TellRequest* request, tt::TellReply* reply) override;
     [[nodiscard]] grpc::Status Narrate(grpc::ServerContext* context, grpc::ServerReader<tt::NarrateRequest>* stream, tt::NarrateReply* reply) override;
+    [[nodiscard]] grpc::Status Converse(grpc::ServerContext* context, grpc::ServerReaderWriter<tt::ConverseReply, tt::ConverseRequest>* stream) override;
+    // Handles single converse request read from the stream, identity of the stream is taken from its first request
+    // (shared by sync and async server)
+    [[nodiscard]] virtual grpc::Status handleConverse(grpc::ServerContext* context, const tt::ConverseRequest* request, std::string& identity,
+        tt::ConverseReply* reply);
+    // Handles narrate already read from the stream (shared by sync and async server)
+    [[nodiscard]] virtual grpc::Status handleNarrate(grpc::ServerContext* context, const TTNarrateRequest& message, tt::NarrateReply* reply);
+    // Moves strings of the request read from the stream into the narrate (no copy), returns false if identity
+    // differs from the first request of the stream (shared by sync and async server)
+    [[nodiscard]] static bool appendNarrate(TTNarrateRequest& message, tt::NarrateRequest& request);
 private:
     TTBroadcasterChat& mHandler;
 };
@@ -1,4 +1,5 @@
 #include "TTNeighborsServiceDiscovery.hpp"
+#include "TTNeighborsIdentity.hpp"
 #include "TTDiagnosticsLogger.hpp"
 
 TTNeighborsServiceDiscovery::TTNeighborsServiceDiscovery(TTBroadcasterDiscovery& handler) : mHandler(handler) {
@@ -24,6 +25,12 @@ grpc::Status TTNeighborsServiceDiscovery::Greet(grpc::ServerContext* context, co
         reply->set_nickname(mHandler.getNickname());
         reply->set_identity(mHandler.getIdentity());
         reply->set_ipaddressandport(mHandler.getIpAddressAndPort());
+        for (const auto& peer : mHandler.getPeers()) {
+            auto* entry = reply->add_peers();
+            entry->set_nickname(peer.nickname);
+            entry->set_identity(peer.identity);
+            entry->set_ipaddressandport(peer.ipAddressAndPort);
+        }
         LOG_INFO("Successfully handled request!");
         return grpc::Status::OK;
     }
@@ -45,9 +52,19 @@ grpc::Status TTNeighborsServiceDiscovery::Heartbeat(grpc::ServerContext* context
         LOG_ERROR("Reply is null!");
         return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Reply is null!");
     }
-    const TTHeartbeatRequest message(request->identity());
+    std::deque<TTMemberUpdate> updates;
+    for (const auto& update : request->updates()) {
+        updates.emplace_back(TTNeighborsIdentity::get(update), update.incarnation(), update.alive());
+    }
+    const TTHeartbeatRequest message(TTNeighborsIdentity::get(*request), updates, TTNeighborsIdentity::getTarget(*request));
     if (mHandler.handleHeartbeat(message)) [[likely]] {
-        reply->set_identity(mHandler.getIdentity());
+        TTNeighborsIdentity::set(*reply, mHandler.getIdentity());
+        for (const auto& update : mHandler.getMemberUpdates()) {
+            auto* member = reply->add_updates();
+            TTNeighborsIdentity::set(*member, update.identity);
+            member->set_incarnation(update.incarnation);
+            member->set_alive(update.alive);
+        }
         LOG_INFO("Successfully handled request!");
         return grpc::Status::OK;
     }
@@ -1,11 +1,161 @@
 #include "TTNeighborsStub.hpp"
+#include "TTNeighborsIdentity.hpp"
 #include "TTDiagnosticsLogger.hpp"
+#include <algorithm>
+#include <string_view>
+
+TTNeighborsChatStreamWatchdog::~TTNeighborsChatStreamWatchdog() {
+    {
+        std::scoped_lock lock(mMutex);
+        mStopped = true;
+    }
+    mCondition.notify_one();
+    if (mThread.joinable()) {
+        mThread.join();
+    }
+}
+
+uint64_t TTNeighborsChatStreamWatchdog::arm(TTNeighborsChatStream& stream, std::chrono::milliseconds timeout) {
+    std::scoped_lock lock(mMutex);
+    if (!mThread.joinable()) {
+        mThread = std::thread(&TTNeighborsChatStreamWatchdog::watch, this);
+    }
+    const auto token = mNextToken++;
+    mArmed.emplace(token, Armed{std::chrono::steady_clock::now() + timeout, &stream});
+    mCondition.notify_one();
+    return token;
+}
+
+void TTNeighborsChatStreamWatchdog::disarm(uint64_t token) {
+    std::scoped_lock lock(mMutex);
+    mArmed.erase(token);
+}
+
+void TTNeighborsChatStreamWatchdog::watch() {
+    std::unique_lock lock(mMutex);
+    while (!mStopped) {
+        if (mArmed.empty()) {
+            mCondition.wait(lock, [this]() { return mStopped || !mArmed.empty(); });
+            continue;
+        }
+        auto earliest = std::min_element(mArmed.begin(), mArmed.end(),
+            [](const auto& lhs, const auto& rhs) { return lhs.second.deadline < rhs.second.deadline; });
+        if (earliest->second.deadline <= std::chrono::steady_clock::now()) {
+            // Cancelled under the lock, so disarmed stream is never touched
+            earliest->second.stream->cancel();
+            mArmed.erase(earliest);
+            continue;
+        }
+        mCondition.wait_until(lock, earliest->second.deadline);
+    }
+}
+
+// Arms the stub watchdog for the scope of one exchange
+class TTNeighborsChatStreamGuard {
+public:
+    TTNeighborsChatStreamGuard(TTNeighborsChatStreamWatchdog& watchdog, TTNeighborsChatStream& stream, std::chrono::milliseconds timeout) :
+        mWatchdog(watchdog), mToken(watchdog.arm(stream, timeout)) {}
+    ~TTNeighborsChatStreamGuard() { mWatchdog.disarm(mToken); }
+    TTNeighborsChatStreamGuard(const TTNeighborsChatStreamGuard&) = delete;
+    TTNeighborsChatStreamGuard(TTNeighborsChatStreamGuard&&) = delete;
+    TTNeighborsChatStreamGuard& operator=(const TTNeighborsChatStreamGuard&) = delete;
+    TTNeighborsChatStreamGuard& operator=(TTNeighborsChatStreamGuard&&) = delete;
+private:
+    TTNeighborsChatStreamWatchdog& mWatchdog;
+    const uint64_t mToken;
+};
+
+static tt::HeartbeatRequest toHeartbeatRequest(const TTHeartbeatRequest& rhs) {
+    tt::HeartbeatRequest request;
+    TTNeighborsIdentity::set(request, rhs.identity);
+    TTNeighborsIdentity::setTarget(request, rhs.target);
+    for (const auto& update : rhs.updates) {
+        auto* member = request.add_updates();
+        TTNeighborsIdentity::set(*member, update.identity);
+        member->set_incarnation(update.incarnation);
+        member->set_alive(update.alive);
+    }
+    return request;
+}
+
+static TTHeartbeatResponse fromHeartbeatReply(const tt::HeartbeatReply& reply) {
+    std::deque<TTMemberUpdate> updates;
+    for (const auto& member : reply.updates()) {
+        updates.emplace_back(TTNeighborsIdentity::get(member), member.incarnation(), member.alive());
+    }
+    return TTHeartbeatResponse(true, TTNeighborsIdentity::get(reply), updates);
+}
+
+static TTGreetResponse fromGreetReply(const tt::GreetReply& reply) {
+    std::deque<TTPeer> peers;
+    for (const auto& peer : reply.peers()) {
+        peers.emplace_back(peer.nickname(), peer.identity(), peer.ipaddressandport());
+    }
+    return TTGreetResponse(true, reply.nickname(), reply.identity(), reply.ipaddressandport(), peers);
+}
+
+static bool isCompressible(const std::string& message) {
+    return message.size() >= TT_COMPRESSION_THRESHOLD;
+}
+
+// Starts unary calls to all stubs at once on one completion queue and collects the replies in the order of stubs,
+// failed call leaves its response as given
+template <typename Reply, typename Response, typename MakeRequest, typename Start, typename Convert>
+static std::vector<Response> sendConcurrently(const std::vector<std::reference_wrapper<TTNeighborsDiscoveryStubIf>>& stubs,
+    std::string_view name,
+    std::chrono::system_clock::time_point deadline,
+    const Response& failed,
+    MakeRequest makeRequest,
+    Start start,
+    Convert convert) {
+    struct Call {
+        grpc::ClientContext context;
+        Reply reply;
+        grpc::Status status;
+        std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<Reply>> reader;
+    };
+    std::vector<Response> responses(stubs.size(), failed);
+    std::vector<Call> calls(stubs.size());
+    grpc::CompletionQueue queue;
+    size_t pending = 0;
+    try {
+        LOG_INFO("Sending {}s to {} neighbors...", name, stubs.size());
+        const auto request = makeRequest();
+        for (size_t i = 0; i < stubs.size(); ++i) {
+            auto& call = calls[i];
+            call.context.set_deadline(deadline);
+            call.reader = start(stubs[i].get(), &call.context, request, &queue);
+            if (!call.reader) [[unlikely]] {
+                LOG_ERROR("Failed to start {}!", name);
+                continue;
+            }
+            call.reader->Finish(&call.reply, &call.status, reinterpret_cast<void*>(i));
+            ++pending;
+        }
+    } catch (...) {
+        LOG_ERROR("Exception occurred while sending {}s!", name);
+    }
+    void* tag = nullptr;
+    bool ok = false;
+    while (pending && queue.Next(&tag, &ok)) {
+        --pending;
+        const auto i = reinterpret_cast<size_t>(tag);
+        auto& call = calls[i];
+        if (ok && call.status.ok()) [[likely]] {
+            responses[i] = convert(call.reply);
+        } else {
+            LOG_ERROR("Error status received on send {}!", name);
+        }
+    }
+    queue.Shutdown();
+    while (queue.Next(&tag, &ok));
+    return responses;
+}
 
 TTUniqueChatStub TTNeighborsStub::createChatStub(const std::string& ipAddressAndPort) const {
     try {
         LOG_INFO("Creating chat stub to {}!", ipAddressAndPort);
-        auto channel = grpc::CreateChannel(ipAddressAndPort, grpc::InsecureChannelCredentials());
-        return tt::NeighborsChat::NewStub(channel);
+        return tt::NeighborsChat::NewStub(getChannel(ipAddressAndPort));
     } catch (...) {
         LOG_WARNING("Failed to create chat stub to {}!", ipAddressAndPort);
         return {};
@@ -15,22 +165,41 @@ TTUniqueChatStub TTNeighborsStub::createChatStub(const std::string& ipAddressAnd
 TTUniqueDiscoveryStub TTNeighborsStub::createDiscoveryStub(const std::string& ipAddressAndPort) const {
     try {
         LOG_INFO("Creating discovery stub to {}!", ipAddressAndPort);
-        auto channel = grpc::CreateChannel(ipAddressAndPort, grpc::InsecureChannelCredentials());
-        return tt::NeighborsDiscovery::NewStub(channel);
+        return tt::NeighborsDiscovery::NewStub(getChannel(ipAddressAndPort));
     } catch (...) {
         LOG_WARNING("Failed to create discovery stub to {}!", ipAddressAndPort);
         return {};
     }
 }
 
+TTUniqueChatStream TTNeighborsStub::createChatStream(TTNeighborsChatStubIf& stub) const {
+    try {
+        LOG_INFO("Creating chat stream!");
+        auto stream = std::make_unique<TTNeighborsChatStream>(stub);
+        if (stream->get()) [[likely]] {
+            return stream;
+        }
+        LOG_WARNING("Failed to open chat stream!");
+    } catch (...) {
+        LOG_WARNING("Exception occurred while creating chat stream!");
+    }
+    return {};
+}
+
 TTTellResponse TTNeighborsStub::sendTell(TTNeighborsChatStubIf& stub, const TTTellRequest& rhs) const {
     try {
         LOG_INFO("Sending tell...");
         tt::TellRequest request;
-        request.set_identity(rhs.identity);
+        TTNeighborsIdentity::set(request, rhs.identity);
         request.set_message(rhs.message);
+        request.set_epoch(rhs.epoch);
+        request.set_sequence(rhs.sequence);
         tt::TellReply reply;
         grpc::ClientContext context;
+        context.set_deadline(std::chrono::system_clock::now() + TELL_DEADLINE);
+        if (isCompressible(rhs.message)) {
+            context.set_compression_algorithm(TT_COMPRESSION_ALGORITHM);
+        }
         grpc::Status status = stub.Tell(&context, request, &reply);
         if (status.ok()) [[likely]] {
             return {true};
@@ -46,20 +215,35 @@ TTNarrateResponse TTNeighborsStub::sendNarrate(TTNeighborsChatStubIf& stub, cons
     try {
         LOG_INFO("Sending narrate...");
         grpc::ClientContext context;
+        context.set_deadline(std::chrono::system_clock::now() + NARRATE_DEADLINE);
+        if (std::any_of(rhs.messages.begin(), rhs.messages.end(), isCompressible)) {
+            context.set_compression_algorithm(TT_COMPRESSION_ALGORITHM);
+        }
         tt::NarrateReply reply;
         std::unique_ptr<grpc::ClientWriterInterface<tt::NarrateRequest>> writer(stub.Narrate(&context, &reply));
         if (!writer) {
             LOG_ERROR("Failed to create writer on send narrate!");
             return {false};
         }
-        for (const auto &message : rhs.messages) {
-            tt::NarrateRequest request;
-            request.set_identity(rhs.identity);
-            request.set_message(message);
-            if (!writer->Write(request)) {
+        // Single arena-allocated request is reused for all messages, identity is sent with the first one only
+        google::protobuf::Arena arena;
+        auto* request = google::protobuf::Arena::CreateMessage<tt::NarrateRequest>(&arena);
+        TTNeighborsIdentity::set(*request, rhs.identity);
+        request->set_epoch(rhs.epoch);
+        for (size_t i = 0; i < rhs.messages.size(); ++i) {
+            const auto& message = rhs.messages[i];
+            request->set_message(message);
+            request->set_sequence(rhs.sequence ? rhs.sequence + i : 0);
+            grpc::WriteOptions options;
+            if (!isCompressible(message)) {
+                options.set_no_compression();
+            }
+            if (!writer->Write(*request, options)) {
                 LOG_ERROR("Error occurred while sending narrate (broken stream)!");
                 return {false};
             }
+            request->clear_identity();
+            request->clear_key();
         }
         writer->WritesDone();
         grpc::Status status = writer->Finish();
@@ -73,6 +257,61 @@ TTNarrateResponse TTNeighborsStub::sendNarrate(TTNeighborsChatStubIf& stub, cons
     return {false};
 }
 
+TTConverseResponse TTNeighborsStub::sendConverse(TTNeighborsChatStream& stream, const TTConverseRequest& rhs) const {
+    size_t acknowledged = 0;
+    try {
+        LOG_INFO("Sending converse...");
+        auto* writer = stream.get();
+        if (!writer) [[unlikely]] {
+            LOG_ERROR("Stream is null on send converse!");
+            return {false, acknowledged};
+        }
+        // Silent neighbor does not hold the worker, whole exchange is bounded
+        TTNeighborsChatStreamGuard guard(mWatchdog, stream, CONVERSE_DEADLINE);
+        // Messages are written back to back, acknowledgements are collected afterwards
+        const auto first = rhs.sequence;
+        for (size_t i = 0; i < rhs.messages.size(); ++i) {
+            tt::ConverseRequest request;
+            if (stream.identify()) {
+                TTNeighborsIdentity::set(request, rhs.identity);
+            }
+            request.set_message(rhs.messages[i]);
+            request.set_epoch(rhs.epoch);
+            request.set_sequence(first + i);
+            grpc::WriteOptions options;
+            if (i + 1 < rhs.messages.size()) {
+                options.set_buffer_hint();
+            }
+            if (!isCompressible(rhs.messages[i])) {
+                options.set_no_compression();
+            }
+            if (!writer->Write(request, options)) {
+                LOG_ERROR("Error occurred while sending converse (broken stream)!");
+                return {false, acknowledged};
+            }
+        }
+        tt::ConverseReply reply;
+        while (acknowledged < rhs.messages.size()) {
+            if (!writer->Read(&reply)) {
+                if (stream.cancelled()) {
+                    LOG_ERROR("Converse acknowledgement timed out!");
+                    return {false, acknowledged};
+                }
+                LOG_ERROR("Error occurred while receiving converse acknowledgement (broken stream)!");
+                return {false, acknowledged};
+            }
+            // Acknowledgements are cumulative
+            if (reply.sequence() >= first) {
+                acknowledged = std::max<size_t>(acknowledged, reply.sequence() - first + 1);
+            }
+        }
+        return {true, std::min(acknowledged, rhs.messages.size())};
+    } catch (...) {
+        LOG_ERROR("Exception occurred while sending converse!");
+    }
+    return {false, acknowledged};
+}
+
 TTGreetResponse TTNeighborsStub::sendGreet(TTNeighborsDiscoveryStubIf& stub, const TTGreetRequest& rhs) const {
     try {
         LOG_INFO("Sending greet...");
@@ -82,9 +321,10 @@ TTGreetResponse TTNeighborsStub::sendGreet(TTNeighborsDiscoveryStubIf& stub, con
         request.set_ipaddressandport(rhs.ipAddressAndPort);
         tt::GreetReply reply;
         grpc::ClientContext context;
+        context.set_deadline(std::chrono::system_clock::now() + GREET_DEADLINE);
         grpc::Status status = stub.Greet(&context, request, &reply);
         if (status.ok()) [[likely]] {
-            return TTGreetResponse(true, reply.nickname(), reply.identity(), reply.ipaddressandport());
+            return fromGreetReply(reply);
         }
         LOG_ERROR("Error status received on send greet!");
     } catch (...) {
@@ -93,20 +333,72 @@ TTGreetResponse TTNeighborsStub::sendGreet(TTNeighborsDiscoveryStubIf& stub, con
     return {{}, {}, {}, {}};
 }
 
+std::vector<TTGreetResponse> TTNeighborsStub::sendGreets(const std::vector<std::reference_wrapper<TTNeighborsDiscoveryStubIf>>& stubs,
+    const TTGreetRequest& rhs) const {
+    // All calls share one deadline, so round takes single timeout at most
+    const auto deadline = std::chrono::system_clock::now() + GREET_DEADLINE;
+    return sendConcurrently<tt::GreetReply>(stubs, "greet", deadline, TTGreetResponse{{}, {}, {}, {}},
+        [&rhs]() {
+            tt::GreetRequest request;
+            request.set_nickname(rhs.nickname);
+            request.set_identity(rhs.identity);
+            request.set_ipaddressandport(rhs.ipAddressAndPort);
+            return request;
+        },
+        [](TTNeighborsDiscoveryStubIf& stub, grpc::ClientContext* context, const tt::GreetRequest& request, grpc::CompletionQueue* queue) {
+            return stub.AsyncGreet(context, request, queue);
+        },
+        fromGreetReply);
+}
+
 TTHeartbeatResponse TTNeighborsStub::sendHeartbeat(TTNeighborsDiscoveryStubIf& stub, const TTHeartbeatRequest& rhs) const {
     try {
         LOG_INFO("Sending heartbeat...");
-        tt::HeartbeatRequest request;
-        request.set_identity(rhs.identity);
+        const auto request = toHeartbeatRequest(rhs);
         tt::HeartbeatReply reply;
         grpc::ClientContext context;
+        context.set_deadline(std::chrono::system_clock::now() + HEARTBEAT_DEADLINE);
         grpc::Status status = stub.Heartbeat(&context, request, &reply);
         if (status.ok()) [[likely]] {
-            return TTHeartbeatResponse(true, reply.identity());
+            return fromHeartbeatReply(reply);
         }
         LOG_ERROR("Error status received on send heartbeat!");
     } catch (...) {
-        LOG_ERROR("Exception occurred while sending greet!");
+        LOG_ERROR("Exception occurred while sending heartbeat!");
     }
     return {{}, {}};
 }
+
+std::vector<TTHeartbeatResponse> TTNeighborsStub::sendHeartbeats(const std::vector<std::reference_wrapper<TTNeighborsDiscoveryStubIf>>& stubs,
+    const TTHeartbeatRequest& rhs) const {
+    // All calls share one deadline, so round takes single timeout at most,
+    // indirect probe gives the helper time to probe the target itself
+    const auto deadline = std::chrono::system_clock::now() + (rhs.target.empty() ? HEARTBEAT_DEADLINE : 2 * HEARTBEAT_DEADLINE);
+    return sendConcurrently<tt::HeartbeatReply>(stubs, "heartbeat", deadline, TTHeartbeatResponse{{}, {}},
+        [&rhs]() { return toHeartbeatRequest(rhs); },
+        [](TTNeighborsDiscoveryStubIf& stub, grpc::ClientContext* context, const tt::HeartbeatRequest& request, grpc::CompletionQueue* queue) {
+            return stub.AsyncHeartbeat(context, request, queue);
+        },
+        fromHeartbeatReply);
+}
+
+std::shared_ptr<grpc::Channel> TTNeighborsStub::getChannel(const std::string& ipAddressAndPort) const {
+    std::scoped_lock lock(mChannelsMutex);
+    const auto now = std::chrono::steady_clock::now();
+    std::erase_if(mChannels, [&](const auto& entry) {
+        const auto& [address, cached] = entry;
+        return (cached.channel.use_count() == 1) && (now - cached.lastUsed > mIdleTimeout);
+    });
+    auto& cached = mChannels[ipAddressAndPort];
+    if (!cached.channel) {
+        LOG_INFO("Creating channel to {}!", ipAddressAndPort);
+        grpc::ChannelArguments arguments;
+        arguments.SetInt(GRPC_ARG_KEEPALIVE_TIME_MS, CHANNEL_KEEPALIVE_TIME_MS);
+        arguments.SetInt(GRPC_ARG_KEEPALIVE_TIMEOUT_MS, CHANNEL_KEEPALIVE_TIMEOUT_MS);
+        arguments.SetInt(GRPC_ARG_KEEPALIVE_PERMIT_WITHOUT_CALLS, 1);
+        arguments.SetInt(GRPC_ARG_HTTP2_MAX_PINGS_WITHOUT_DATA, 0);
+        cached.channel = grpc::CreateCustomChannel(ipAddressAndPort, grpc::InsecureChannelCredentials(), arguments);
+    }
+    cached.lastUsed = now;
+    return cached.channel;
+}
@@ -2,15 +2,96 @@
 #include "TTNeighborsMessage.hpp"
 #include "TerminalTeams.grpc.pb.h"
 #include <grpcpp/grpcpp.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 using TTNeighborsChatStubIf = tt::NeighborsChat::StubInterface;
 using TTNeighborsDiscoveryStubIf = tt::NeighborsDiscovery::StubInterface;
 using TTUniqueChatStub = std::unique_ptr<TTNeighborsChatStubIf>;
 using TTUniqueDiscoveryStub = std::unique_ptr<TTNeighborsDiscoveryStubIf>;
+using TTNeighborsChatStreamIf = grpc::ClientReaderWriterInterface<tt::ConverseRequest, tt::ConverseReply>;
 
+// Chat payloads (pasted logs, code blocks) repeat heavily, short ones are not worth compressing
+inline constexpr grpc_compression_algorithm TT_COMPRESSION_ALGORITHM = GRPC_COMPRESS_GZIP;
+inline constexpr size_t TT_COMPRESSION_THRESHOLD = 1024;
+
+// Long-lived bidirectional chat stream to the neighbor
+class TTNeighborsChatStream {
+public:
+    explicit TTNeighborsChatStream(TTNeighborsChatStubIf& stub) {
+        // Compression is enabled per stream, small messages are written uncompressed
+        mContext.set_compression_algorithm(TT_COMPRESSION_ALGORITHM);
+        mStream = stub.Converse(&mContext);
+    }
+    ~TTNeighborsChatStream() {
+        if (mStream) {
+            mContext.TryCancel();
+            mStream->Finish();
+        }
+    }
+    TTNeighborsChatStream(const TTNeighborsChatStream&) = delete;
+    TTNeighborsChatStream(TTNeighborsChatStream&&) = delete;
+    TTNeighborsChatStream& operator=(const TTNeighborsChatStream&) = delete;
+    TTNeighborsChatStream& operator=(TTNeighborsChatStream&&) = delete;
+    [[nodiscard]] TTNeighborsChatStreamIf* get() { return mStream.get(); }
+    // Thread-safe cancel, pending reads and writes fail
+    void cancel() {
+        mCancelled.store(true);
+        mContext.TryCancel();
+    }
+    // Thread-safe getter
+    [[nodiscard]] bool cancelled() const { return mCancelled.load(); }
+    // Returns true only for the first request of the stream, the only one carrying identity
+    [[nodiscard]] bool identify() { return !std::exchange(mIdentified, true); }
+private:
+    // Context has to outlive the stream
+    grpc::ClientContext mContext;
+    std::unique_ptr<TTNeighborsChatStreamIf> mStream;
+    bool mIdentified = false;
+    std::atomic<bool> mCancelled{false};
+};
+using TTUniqueChatStream = std::unique_ptr<TTNeighborsChatStream>;
+
+// Single timer thread cancelling armed streams not disarmed before their deadline,
+// thread is started on the first arm and lives as long as the watchdog
+class TTNeighborsChatStreamWatchdog {
+public:
+    TTNeighborsChatStreamWatchdog() = default;
+    ~TTNeighborsChatStreamWatchdog();
+    TTNeighborsChatStreamWatchdog(const TTNeighborsChatStreamWatchdog&) = delete;
+    TTNeighborsChatStreamWatchdog(TTNeighborsChatStreamWatchdog&&) = delete;
+    TTNeighborsChatStreamWatchdog& operator=(const TTNeighborsChatStreamWatchdog&) = delete;
+    TTNeighborsChatStreamWatchdog& operator=(TTNeighborsChatStreamWatchdog&&) = delete;
+    // Returns token for disarm, stream has to outlive it
+    [[nodiscard]] uint64_t arm(TTNeighborsChatStream& stream, std::chrono::milliseconds timeout);
+    // Stream is not cancelled after disarm returns
+    void disarm(uint64_t token);
+private:
+    void watch();
+    struct Armed {
+        std::chrono::steady_clock::time_point deadline;
+        TTNeighborsChatStream* stream;
+    };
+    std::map<uint64_t, Armed> mArmed;
+    uint64_t mNextToken = 0;
+    bool mStopped = false;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::thread mThread;
+};
+
+// Stubs to the same neighbor share one cached channel (single HTTP/2 connection)
 class TTNeighborsStub {
 public:
-    TTNeighborsStub() = default;
+    explicit TTNeighborsStub(std::chrono::milliseconds idleTimeout = CHANNEL_IDLE_TIMEOUT) : mIdleTimeout(idleTimeout) {}
     virtual ~TTNeighborsStub() = default;
     TTNeighborsStub(const TTNeighborsStub&) = delete;
     TTNeighborsStub(TTNeighborsStub&&) = delete;
@@ -18,8 +99,39 @@ public:
     TTNeighborsStub& operator=(TTNeighborsStub&&) = delete;
     [[nodiscard]] virtual TTUniqueChatStub createChatStub(const std::string& ipAddressAndPort) const;
     [[nodiscard]] virtual TTUniqueDiscoveryStub createDiscoveryStub(const std::string& ipAddressAndPort) const;
+    [[nodiscard]] virtual TTUniqueChatStream createChatStream(TTNeighborsChatStubIf& stub) const;
     [[nodiscard]] virtual TTTellResponse sendTell(TTNeighborsChatStubIf& stub, const TTTellRequest& rhs) const;
     [[nodiscard]] virtual TTNarrateResponse sendNarrate(TTNeighborsChatStubIf& stub, const TTNarrateRequest& rhs) const;
+    [[nodiscard]] virtual TTConverseResponse sendConverse(TTNeighborsChatStream& stream, const TTConverseRequest& rhs) const;
     [[nodiscard]] virtual TTGreetResponse sendGreet(TTNeighborsDiscoveryStubIf& stub, const TTGreetRequest& rhs) const;
+    // Sends greets concurrently, each call is bounded by the greet deadline
+    [[nodiscard]] virtual std::vector<TTGreetResponse> sendGreets(const std::vector<std::reference_wrapper<TTNeighborsDiscoveryStubIf>>& stubs,
+        const TTGreetRequest& rhs) const;
     [[nodiscard]] virtual TTHeartbeatResponse sendHeartbeat(TTNeighborsDiscoveryStubIf& stub, const TTHeartbeatRequest& rhs) const;
+    // Sends heartbeats concurrently, each call is bounded by the heartbeat deadline
+    [[nodiscard]] virtual std::vector<TTHeartbeatResponse> sendHeartbeats(const std::vector<std::reference_wrapper<TTNeighborsDiscoveryStubIf>>& stubs,
+        const TTHeartbeatRequest& rhs) const;
+    // Returns cached channel, unused channels idle for too long are evicted
+    [[nodiscard]] std::shared_ptr<grpc::Channel> getChannel(const std::string& ipAddressAndPort) const;
+private:
+    struct Channel {
+        std::shared_ptr<grpc::Channel> channel;
+        std::chrono::steady_clock::time_point lastUsed;
+    };
+    const std::chrono::milliseconds mIdleTimeout;
+    mutable std::unordered_map<std::string, Channel> mChannels;
+    mutable std::mutex mChannelsMutex;
+    // Shared by all converse exchanges of the stub
+    mutable TTNeighborsChatStreamWatchdog mWatchdog;
+    static inline constexpr std::chrono::milliseconds CHANNEL_IDLE_TIMEOUT{60000};
+    static inline constexpr int CHANNEL_KEEPALIVE_TIME_MS = 20000;
+    static inline constexpr int CHANNEL_KEEPALIVE_TIMEOUT_MS = 10000;
+    static inline constexpr std::chrono::milliseconds HEARTBEAT_DEADLINE{1000};
+    // Unreachable neighbor does not hold the delivery worker, narrate carries a whole batch
+    static inline constexpr std::chrono::milliseconds TELL_DEADLINE{2000};
+    static inline constexpr std::chrono::milliseconds NARRATE_DEADLINE{5000};
+    // Stream is cancelled if the batch is not acknowledged in time, the caller falls back to narrate or tell
+    static inline constexpr std::chrono::milliseconds CONVERSE_DEADLINE{2000};
+    // Unreachable static neighbor fails fast instead of waiting for connection
+    static inline constexpr std::chrono::milliseconds GREET_DEADLINE{1000};
 };
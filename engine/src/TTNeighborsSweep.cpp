@@ -0,0 +1,213 @@
+#include "TTNeighborsSweep.hpp"
+#include "TTDiagnosticsLogger.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static bool parseSubnet(const std::string& value, uint32_t& network, int& prefixLength) {
+    const auto slash = value.find('/');
+    if (slash == std::string::npos) {
+        return false;
+    }
+    in_addr address{};
+    if (inet_pton(AF_INET, value.substr(0, slash).c_str(), &address) != 1) {
+        return false;
+    }
+    const auto prefix = value.substr(slash + 1);
+    auto [ptr, ec] = std::from_chars(prefix.data(), prefix.data() + prefix.size(), prefixLength);
+    if (ec != std::errc() || ptr != prefix.data() + prefix.size() || prefixLength > 32) {
+        return false;
+    }
+    const uint32_t mask = prefixLength ? ~uint32_t{0} << (32 - prefixLength) : 0;
+    network = ntohl(address.s_addr) & mask;
+    return true;
+}
+
+TTNeighborsSweep::TTNeighborsSweep(const std::deque<std::string>& subnets,
+                                   const std::string& port,
+                                   const std::string& hostIpAddress,
+                                   size_t concurrency,
+                                   size_t rate) :
+        mPort(port),
+        mConcurrency(std::max<size_t>(concurrency, 1)),
+        mSpacing(std::chrono::microseconds(std::chrono::seconds(1)) / std::max<size_t>(rate, 1)) {
+    LOG_INFO("Constructing...");
+    auto [ptr, ec] = std::from_chars(port.data(), port.data() + port.size(), mPortNumber);
+    if (ec != std::errc()) {
+        throw std::runtime_error("TTNeighborsSweep: Invalid port=" + port);
+    }
+    const auto host = toAddress(hostIpAddress);
+    for (const auto& subnet : subnets) {
+        uint32_t network = 0;
+        int prefixLength = 0;
+        if (!isSubnet(subnet) || !parseSubnet(subnet, network, prefixLength)) {
+            throw std::runtime_error("TTNeighborsSweep: Invalid subnet=" + subnet);
+        }
+        const uint64_t size = uint64_t{1} << (32 - prefixLength);
+        // Network and broadcast addresses are skipped, except for point-to-point and single host ranges
+        const uint64_t first = (size > 2) ? 1 : 0;
+        const uint64_t last = (size > 2) ? size - 1 : size;
+        for (uint64_t i = first; i < last; ++i) {
+            const auto address = static_cast<uint32_t>(network + i);
+            if (address != host) {
+                mTargets.try_emplace(address);
+            }
+        }
+        LOG_INFO("Sweeping subnet={}, addresses={}", subnet, mTargets.size());
+    }
+    LOG_INFO("Successfully constructed!");
+}
+
+std::vector<std::string> TTNeighborsSweep::sweep(const std::function<bool()>& isStopped) {
+    struct Probe {
+        int socket;
+        uint32_t address;
+        std::chrono::steady_clock::time_point deadline;
+    };
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<uint32_t> due;
+    for (const auto& [address, target] : mTargets) {
+        if (target.due <= start) {
+            due.push_back(address);
+        }
+    }
+    std::vector<std::string> reachable;
+    std::vector<Probe> probes;
+    std::vector<pollfd> descriptors;
+    const auto finish = [&](uint32_t address, bool connected, std::chrono::steady_clock::time_point now) {
+        auto& target = mTargets.at(address);
+        if (connected) {
+            reachable.push_back(toIpAddressAndPort(address));
+            // Probed again only if greet fails
+            target.due = std::chrono::steady_clock::time_point::max();
+        } else {
+            backoff(target, now);
+        }
+    };
+    size_t next = 0;
+    auto nextStart = start;
+    while ((next < due.size() || !probes.empty()) && !isStopped()) {
+        auto now = std::chrono::steady_clock::now();
+        // Connects are paced and capped, so the sweep does not flood the network
+        while (next < due.size() && probes.size() < mConcurrency && nextStart <= now) {
+            const auto address = due[next++];
+            nextStart += mSpacing;
+            const int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (fd < 0) [[unlikely]] {
+                LOG_ERROR("Failed to create socket!");
+                backoff(mTargets.at(address), now);
+                continue;
+            }
+            sockaddr_in peer{};
+            peer.sin_family = AF_INET;
+            peer.sin_port = htons(mPortNumber);
+            peer.sin_addr.s_addr = htonl(address);
+            if (connect(fd, reinterpret_cast<sockaddr*>(&peer), sizeof(peer)) == 0) {
+                close(fd);
+                finish(address, true, now);
+            } else if (errno == EINPROGRESS) {
+                probes.push_back(Probe{fd, address, now + CONNECT_TIMEOUT});
+            } else {
+                close(fd);
+                finish(address, false, now);
+            }
+        }
+        if (probes.empty()) {
+            if (next < due.size()) {
+                std::this_thread::sleep_until(nextStart);
+            }
+            continue;
+        }
+        auto wakeup = std::min_element(probes.begin(), probes.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.deadline < rhs.deadline;
+        })->deadline;
+        if (next < due.size() && probes.size() < mConcurrency) {
+            wakeup = std::min(wakeup, nextStart);
+        }
+        descriptors.clear();
+        for (const auto& probe : probes) {
+            descriptors.push_back(pollfd{probe.socket, POLLOUT, 0});
+        }
+        const auto timeout = std::chrono::ceil<std::chrono::milliseconds>(wakeup - now).count();
+        if (poll(descriptors.data(), descriptors.size(), std::max<int>(timeout, 0)) < 0 && errno != EINTR) [[unlikely]] {
+            LOG_ERROR("Failed to poll sockets!");
+        }
+        now = std::chrono::steady_clock::now();
+        std::vector<Probe> pending;
+        for (size_t i = 0; i < probes.size(); ++i) {
+            const auto& probe = probes[i];
+            if (descriptors[i].revents) {
+                int error = 0;
+                socklen_t length = sizeof(error);
+                getsockopt(probe.socket, SOL_SOCKET, SO_ERROR, &error, &length);
+                close(probe.socket);
+                finish(probe.address, error == 0, now);
+            } else if (probe.deadline <= now) {
+                close(probe.socket);
+                finish(probe.address, false, now);
+            } else {
+                pending.push_back(probe);
+            }
+        }
+        probes = std::move(pending);
+    }
+    for (const auto& probe : probes) {
+        close(probe.socket);
+    }
+    LOG_INFO("Swept addresses={}, reachable={}", next, reachable.size());
+    return reachable;
+}
+
+void TTNeighborsSweep::resolve(const std::string& ipAddressAndPort) {
+    mTargets.erase(toAddress(ipAddressAndPort));
+}
+
+void TTNeighborsSweep::backoff(const std::string& ipAddressAndPort) {
+    auto it = mTargets.find(toAddress(ipAddressAndPort));
+    if (it != mTargets.end()) {
+        backoff(it->second, std::chrono::steady_clock::now());
+    }
+}
+
+void TTNeighborsSweep::backoff(Target& target, std::chrono::steady_clock::time_point now) {
+    target.interval = std::clamp(target.interval * 2, MIN_BACKOFF, MAX_BACKOFF);
+    target.due = now + target.interval;
+}
+
+std::chrono::steady_clock::time_point TTNeighborsSweep::deadline() const {
+    auto deadline = std::chrono::steady_clock::time_point::max();
+    for (const auto& [address, target] : mTargets) {
+        deadline = std::min(deadline, target.due);
+    }
+    return deadline;
+}
+
+bool TTNeighborsSweep::isSubnet(const std::string& value) {
+    uint32_t network = 0;
+    int prefixLength = 0;
+    return parseSubnet(value, network, prefixLength) && prefixLength >= MIN_PREFIX_LENGTH;
+}
+
+std::string TTNeighborsSweep::toIpAddressAndPort(uint32_t address) const {
+    in_addr value{htonl(address)};
+    char buffer[INET_ADDRSTRLEN] = {};
+    inet_ntop(AF_INET, &value, buffer, sizeof(buffer));
+    return std::string(buffer) + ":" + mPort;
+}
+
+uint32_t TTNeighborsSweep::toAddress(const std::string& ipAddressAndPort) {
+    in_addr address{};
+    if (inet_pton(AF_INET, ipAddressAndPort.substr(0, ipAddressAndPort.find(':')).c_str(), &address) != 1) {
+        return 0;
+    }
+    return ntohl(address.s_addr);
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+// Finds hosts listening on the port within subnets (CIDR ranges) using fast non-blocking TCP connect,
+// addresses which do not answer are probed again with exponential backoff (thread-unsafe)
+class TTNeighborsSweep {
+public:
+    TTNeighborsSweep(const std::deque<std::string>& subnets,
+                     const std::string& port,
+                     const std::string& hostIpAddress,
+                     size_t concurrency = DEFAULT_CONCURRENCY,
+                     size_t rate = DEFAULT_RATE);
+    virtual ~TTNeighborsSweep() = default;
+    TTNeighborsSweep(const TTNeighborsSweep&) = delete;
+    TTNeighborsSweep(TTNeighborsSweep&&) = delete;
+    TTNeighborsSweep& operator=(const TTNeighborsSweep&) = delete;
+    TTNeighborsSweep& operator=(TTNeighborsSweep&&) = delete;
+    // Probes all due addresses, returns IP addresses and ports which accepted connection
+    [[nodiscard]] std::vector<std::string> sweep(const std::function<bool()>& isStopped);
+    // Address answered greet, it is not probed anymore
+    void resolve(const std::string& ipAddressAndPort);
+    // Address did not answer greet, it is probed again later
+    void backoff(const std::string& ipAddressAndPort);
+    // Point in time when the next address is due, max if there is nothing to probe
+    [[nodiscard]] std::chrono::steady_clock::time_point deadline() const;
+    [[nodiscard]] size_t size() const { return mTargets.size(); }
+    // Returns true if value is IPv4 CIDR range (e.g. 10.0.0.0/22) supported by sweep
+    [[nodiscard]] static bool isSubnet(const std::string& value);
+private:
+    struct Target {
+        std::chrono::steady_clock::time_point due;
+        std::chrono::milliseconds interval{0};
+    };
+    void backoff(Target& target, std::chrono::steady_clock::time_point now);
+    [[nodiscard]] std::string toIpAddressAndPort(uint32_t address) const;
+    // Returns host order address, 0 if it cannot be parsed
+    [[nodiscard]] static uint32_t toAddress(const std::string& ipAddressAndPort);
+    std::string mPort;
+    uint16_t mPortNumber = 0;
+    size_t mConcurrency;
+    // Minimal time between two connects
+    std::chrono::microseconds mSpacing;
+    std::map<uint32_t, Target> mTargets;
+    static inline constexpr size_t DEFAULT_CONCURRENCY = 256;
+    // Connects per second
+    static inline constexpr size_t DEFAULT_RATE = 1000;
+    static inline constexpr std::chrono::milliseconds CONNECT_TIMEOUT{300};
+    static inline constexpr std::chrono::milliseconds MIN_BACKOFF{2000};
+    static inline constexpr std::chrono::milliseconds MAX_BACKOFF{300000};
+    // Larger subnets would take too long to sweep
+    static inline constexpr int MIN_PREFIX_LENGTH = 16;
+};
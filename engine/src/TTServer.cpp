@@ -0,0 +1,299 @@
+#include "TTServer.hpp"
+#include "TTDiagnosticsLogger.hpp"
+
+// Pending call of the asynchronous server, completion queue tag
+class TTServerCall {
+public:
+    TTServerCall(TTServer& server, grpc::ServerCompletionQueue& queue) : mServer(server), mQueue(queue) {}
+    virtual ~TTServerCall() = default;
+    TTServerCall(const TTServerCall&) = delete;
+    TTServerCall(TTServerCall&&) = delete;
+    TTServerCall& operator=(const TTServerCall&) = delete;
+    TTServerCall& operator=(TTServerCall&&) = delete;
+    // Called by polling thread once operation bound to this tag has completed
+    virtual void proceed(bool ok) = 0;
+protected:
+    // Starts next operation unless server is shutting down, otherwise call is released
+    void schedule(const std::function<void()>& operation) {
+        if (!mServer.schedule(operation)) {
+            delete this;
+        }
+    }
+    // Runs handler on the handler pool, which schedules the next operation itself, otherwise call is released
+    void dispatch(const std::function<void()>& handler) {
+        if (!mServer.dispatch(handler)) {
+            delete this;
+        }
+    }
+    TTServer& mServer;
+    grpc::ServerCompletionQueue& mQueue;
+    grpc::ServerContext mContext;
+};
+
+template <typename AsyncService, typename Request, typename Reply>
+class TTServerUnaryCall : public TTServerCall {
+public:
+    using Responder = grpc::ServerAsyncResponseWriter<Reply>;
+    using Requester = std::function<void(AsyncService&, grpc::ServerContext*, Request*, Responder*, grpc::CompletionQueue*, grpc::ServerCompletionQueue*, void*)>;
+    using Handler = std::function<grpc::Status(grpc::ServerContext*, const Request*, Reply*)>;
+    TTServerUnaryCall(TTServer& server, grpc::ServerCompletionQueue& queue, AsyncService& service, Requester requester, Handler handler) :
+            TTServerCall(server, queue), mService(service), mRequester(requester), mHandler(handler), mResponder(&mContext) {
+        schedule([this]() { mRequester(mService, &mContext, &mRequest, &mResponder, &mQueue, &mQueue, this); });
+    }
+    void proceed(bool ok) override {
+        if (!ok || mFinished) {
+            delete this;
+            return;
+        }
+        new TTServerUnaryCall(mServer, mQueue, mService, mRequester, mHandler);
+        mFinished = true;
+        dispatch([this]() {
+            const auto status = mHandler(&mContext, &mRequest, &mReply);
+            schedule([this, status]() { mResponder.Finish(mReply, status, this); });
+        });
+    }
+private:
+    AsyncService& mService;
+    Requester mRequester;
+    Handler mHandler;
+    Responder mResponder;
+    Request mRequest;
+    Reply mReply;
+    bool mFinished = false;
+};
+
+class TTServerNarrateCall : public TTServerCall {
+public:
+    TTServerNarrateCall(TTServer& server, grpc::ServerCompletionQueue& queue, tt::NeighborsChat::AsyncService& service, TTNeighborsServiceChat& chat) :
+            TTServerCall(server, queue), mService(service), mChat(chat), mReader(&mContext) {
+        schedule([this]() { mService.RequestNarrate(&mContext, &mReader, &mQueue, &mQueue, this); });
+    }
+    void proceed(bool ok) override {
+        switch (mState) {
+            case State::REQUESTED:
+                if (!ok) {
+                    delete this;
+                    return;
+                }
+                new TTServerNarrateCall(mServer, mQueue, mService, mChat);
+                mState = State::READING;
+                schedule([this]() { mReader.Read(mRequest, this); });
+                return;
+            case State::READING:
+                if (ok) {
+                    // Stream is drained even if identity does not match
+                    mUnique = mUnique && TTNeighborsServiceChat::appendNarrate(mMessage, *mRequest);
+                    schedule([this]() { mReader.Read(mRequest, this); });
+                    return;
+                }
+                // Client has half-closed the stream
+                mState = State::FINISHED;
+                dispatch([this]() {
+                    const auto status = mUnique ? mChat.handleNarrate(&mContext, mMessage, &mReply) :
+                        grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Wrong number of unique ids!");
+                    schedule([this, status]() { mReader.Finish(mReply, status, this); });
+                });
+                return;
+            case State::FINISHED:
+            default:
+                delete this;
+                return;
+        }
+    }
+private:
+    enum class State { REQUESTED, READING, FINISHED };
+    tt::NeighborsChat::AsyncService& mService;
+    TTNeighborsServiceChat& mChat;
+    grpc::ServerAsyncReader<tt::NarrateReply, tt::NarrateRequest> mReader;
+    // Single arena-allocated request is parsed over and over, its strings are moved out
+    google::protobuf::Arena mArena;
+    tt::NarrateRequest* mRequest = google::protobuf::Arena::CreateMessage<tt::NarrateRequest>(&mArena);
+    TTNarrateRequest mMessage;
+    bool mUnique = true;
+    tt::NarrateReply mReply;
+    State mState = State::REQUESTED;
+};
+
+class TTServerConverseCall : public TTServerCall {
+public:
+    TTServerConverseCall(TTServer& server, grpc::ServerCompletionQueue& queue, tt::NeighborsChat::AsyncService& service, TTNeighborsServiceChat& chat) :
+            TTServerCall(server, queue), mService(service), mChat(chat), mStream(&mContext) {
+        schedule([this]() { mService.RequestConverse(&mContext, &mStream, &mQueue, &mQueue, this); });
+    }
+    void proceed(bool ok) override {
+        switch (mState) {
+            case State::REQUESTED:
+                if (!ok) {
+                    delete this;
+                    return;
+                }
+                new TTServerConverseCall(mServer, mQueue, mService, mChat);
+                read();
+                return;
+            case State::READING:
+                if (!ok) {
+                    // Client has half-closed the stream
+                    finish(grpc::Status::OK);
+                    return;
+                }
+                mState = State::WRITING;
+                dispatch([this]() {
+                    mReply.Clear();
+                    const auto status = mChat.handleConverse(&mContext, &mRequest, mIdentity, &mReply);
+                    if (status.ok()) [[likely]] {
+                        schedule([this]() { mStream.Write(mReply, this); });
+                    } else {
+                        finish(status);
+                    }
+                });
+                return;
+            case State::WRITING:
+                if (!ok) {
+                    delete this;
+                    return;
+                }
+                read();
+                return;
+            case State::FINISHED:
+            default:
+                delete this;
+                return;
+        }
+    }
+private:
+    void read() {
+        mState = State::READING;
+        schedule([this]() { mStream.Read(&mRequest, this); });
+    }
+    void finish(const grpc::Status& status) {
+        mState = State::FINISHED;
+        schedule([this, status]() { mStream.Finish(status, this); });
+    }
+    enum class State { REQUESTED, READING, WRITING, FINISHED };
+    tt::NeighborsChat::AsyncService& mService;
+    TTNeighborsServiceChat& mChat;
+    grpc::ServerAsyncReaderWriter<tt::ConverseReply, tt::ConverseRequest> mStream;
+    tt::ConverseRequest mRequest;
+    // Carried by the first request of the stream only
+    std::string mIdentity;
+    tt::ConverseReply mReply;
+    State mState = State::REQUESTED;
+};
+
+TTServer::TTServer(const std::string& ipAddressAndPort, TTNeighborsServiceChat& chat, TTNeighborsServiceDiscovery& discovery, size_t threads) :
+        mChat(&chat), mDiscovery(&discovery) {
+    LOG_INFO("Constructing...");
+    grpc::EnableDefaultHealthCheckService(true);
+    grpc::reflection::InitProtoReflectionServerBuilderPlugin();
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort(ipAddressAndPort, grpc::InsecureServerCredentials());
+    // Neighbors keep their channels alive with pings
+    builder.AddChannelArgument(GRPC_ARG_KEEPALIVE_PERMIT_WITHOUT_CALLS, 1);
+    builder.AddChannelArgument(GRPC_ARG_HTTP2_MIN_RECV_PING_INTERVAL_WITHOUT_DATA_MS, MIN_PING_INTERVAL_MS);
+    if (threads == 0) {
+        builder.RegisterService(&chat);
+        builder.RegisterService(&discovery);
+    } else {
+        mAsyncChat = std::make_unique<tt::NeighborsChat::AsyncService>();
+        mAsyncDiscovery = std::make_unique<tt::NeighborsDiscovery::AsyncService>();
+        builder.RegisterService(mAsyncChat.get());
+        builder.RegisterService(mAsyncDiscovery.get());
+        for (size_t i = 0; i < threads; ++i) {
+            mCompletionQueues.push_back(builder.AddCompletionQueue());
+        }
+        mHandlers = std::make_unique<TTUtilsExecutor>(std::max(threads, MIN_HANDLER_THREADS));
+    }
+    mGrpcServer = std::unique_ptr<grpc::Server>(builder.BuildAndStart());
+    if (!mGrpcServer) {
+        throw std::runtime_error("TTServer: Failed to build and start server!");
+    }
+    LOG_INFO("Successfully constructed, polling threads={}", threads);
+}
+
+TTServer::~TTServer() {
+    LOG_INFO("Destructing...");
+    stop();
+    // Completion queues have to be drained before destruction
+    for (auto& queue : mCompletionQueues) {
+        void* tag = nullptr;
+        bool ok = false;
+        while (queue->Next(&tag, &ok)) {
+            static_cast<TTServerCall*>(tag)->proceed(ok);
+        }
+    }
+    // Calls still owned by handlers are released once they are executed
+    mHandlers.reset();
+    LOG_INFO("Successfully destructed!");
+}
+
+void TTServer::run() {
+    if (mCompletionQueues.empty()) {
+        mGrpcServer->Wait();
+        return;
+    }
+    std::vector<std::thread> threads;
+    for (auto& queue : mCompletionQueues) {
+        threads.emplace_back(&TTServer::poll, this, std::ref(*queue));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    // Handlers still running are inside the services, which may be destroyed as soon as run returns
+    mHandlers->drain();
+    mHandlers->join();
+}
+
+void TTServer::onStop() {
+    if (!mGrpcServer) {
+        return;
+    }
+    {
+        std::unique_lock lock(mCompletionQueuesMutex);
+        mCompletionQueuesShutdown = true;
+    }
+    if (mCompletionQueues.empty()) {
+        mGrpcServer->Shutdown();
+        return;
+    }
+    // In-flight asynchronous calls are cancelled immediately
+    mGrpcServer->Shutdown(std::chrono::system_clock::now());
+    for (auto& queue : mCompletionQueues) {
+        queue->Shutdown();
+    }
+    mHandlers->drain();
+}
+
+void TTServer::poll(grpc::ServerCompletionQueue& queue) {
+    LOG_INFO("Started polling thread");
+    using namespace std::placeholders;
+    const auto handleTell = std::bind(&TTNeighborsServiceChat::Tell, mChat, _1, _2, _3);
+    const auto handleGreet = std::bind(&TTNeighborsServiceDiscovery::Greet, mDiscovery, _1, _2, _3);
+    const auto handleHeartbeat = std::bind(&TTNeighborsServiceDiscovery::Heartbeat, mDiscovery, _1, _2, _3);
+    new TTServerUnaryCall<tt::NeighborsChat::AsyncService, tt::TellRequest, tt::TellReply>(*this, queue, *mAsyncChat,
+        std::mem_fn(&tt::NeighborsChat::AsyncService::RequestTell), handleTell);
+    new TTServerNarrateCall(*this, queue, *mAsyncChat, *mChat);
+    new TTServerConverseCall(*this, queue, *mAsyncChat, *mChat);
+    new TTServerUnaryCall<tt::NeighborsDiscovery::AsyncService, tt::GreetRequest, tt::GreetReply>(*this, queue, *mAsyncDiscovery,
+        std::mem_fn(&tt::NeighborsDiscovery::AsyncService::RequestGreet), handleGreet);
+    new TTServerUnaryCall<tt::NeighborsDiscovery::AsyncService, tt::HeartbeatRequest, tt::HeartbeatReply>(*this, queue, *mAsyncDiscovery,
+        std::mem_fn(&tt::NeighborsDiscovery::AsyncService::RequestHeartbeat), handleHeartbeat);
+    void* tag = nullptr;
+    bool ok = false;
+    while (queue.Next(&tag, &ok)) {
+        static_cast<TTServerCall*>(tag)->proceed(ok);
+    }
+    LOG_INFO("Completed polling thread");
+}
+
+bool TTServer::dispatch(const std::function<void()>& handler) {
+    return mHandlers->submit(handler);
+}
+
+bool TTServer::schedule(const std::function<void()>& operation) {
+    std::shared_lock lock(mCompletionQueuesMutex);
+    if (mCompletionQueuesShutdown) {
+        return false;
+    }
+    operation();
+    return true;
+}
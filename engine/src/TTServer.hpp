@@ -2,34 +2,43 @@
 #include "TTNeighborsServiceChat.hpp"
 #include "TTNeighborsServiceDiscovery.hpp"
 #include "TTUtilsStopable.hpp"
+#include "TTUtilsExecutor.hpp"
 #include <grpcpp/grpcpp.h>
 #include <grpcpp/ext/proto_server_reflection_plugin.h>
 #include <grpcpp/health_check_service_interface.h>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
 
+// Synchronous server if number of threads is zero, otherwise asynchronous (completion queue) server
 class TTServer : public TTUtilsStopable {
 public:
-    TTServer(const std::string& ipAddressAndPort, TTNeighborsServiceChat& chat, TTNeighborsServiceDiscovery& discovery) {
-        grpc::EnableDefaultHealthCheckService(true);
-        grpc::reflection::InitProtoReflectionServerBuilderPlugin();
-        grpc::ServerBuilder builder;
-        builder.AddListeningPort(ipAddressAndPort, grpc::InsecureServerCredentials());
-        builder.RegisterService(&chat);
-        builder.RegisterService(&discovery);
-        mGrpcServer = std::unique_ptr<grpc::Server>(builder.BuildAndStart());
-    }
-    virtual ~TTServer() = default;
-    TTServer(const TTServer&) = default;
-    TTServer(TTServer&&) = default;
-    TTServer& operator=(const TTServer&) = default;
-    TTServer& operator=(TTServer&&) = default;
-    virtual void run() {
-        mGrpcServer->Wait();
-    }
+    TTServer(const std::string& ipAddressAndPort, TTNeighborsServiceChat& chat, TTNeighborsServiceDiscovery& discovery, size_t threads = 0);
+    virtual ~TTServer();
+    TTServer(const TTServer&) = delete;
+    TTServer(TTServer&&) = delete;
+    TTServer& operator=(const TTServer&) = delete;
+    TTServer& operator=(TTServer&&) = delete;
+    virtual void run();
 protected:
     TTServer() = default;
-    virtual void onStop() override {
-        mGrpcServer->Shutdown();
-    }
+    virtual void onStop() override;
 private:
+    friend class TTServerCall;
+    void poll(grpc::ServerCompletionQueue& queue);
+    [[nodiscard]] bool schedule(const std::function<void()>& operation);
+    [[nodiscard]] bool dispatch(const std::function<void()>& handler);
+    // Services and completion queues have to outlive the server
+    std::unique_ptr<tt::NeighborsChat::AsyncService> mAsyncChat;
+    std::unique_ptr<tt::NeighborsDiscovery::AsyncService> mAsyncDiscovery;
+    std::vector<std::unique_ptr<grpc::ServerCompletionQueue>> mCompletionQueues;
     std::unique_ptr<grpc::Server> mGrpcServer;
+    TTNeighborsServiceChat* mChat = nullptr;
+    TTNeighborsServiceDiscovery* mDiscovery = nullptr;
+    std::shared_mutex mCompletionQueuesMutex;
+    bool mCompletionQueuesShutdown = false;
+    // Handlers may block (e.g. indirect probe), so they are not executed by polling threads
+    std::unique_ptr<TTUtilsExecutor> mHandlers;
+    static inline constexpr int MIN_PING_INTERVAL_MS = 10000;
+    static inline constexpr size_t MIN_HANDLER_THREADS = 4;
 };
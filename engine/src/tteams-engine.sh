@@ -13,6 +13,8 @@ TMUX_SESSION_NAME="${RANDOM_STRING}-terminal-teams-session"
 CONTACTS_SHARED_MEMORY_NAME="${RANDOM_STRING}-contacts"
 CHAT_MESSAGE_QUEUE_NAME="${RANDOM_STRING}-chat"
 TEXTBOX_PIPE_NAME="${RANDOM_STRING}-textbox"
+# Neighbors seen before are greeted first after restart
+export TT_NEIGHBORS_CACHE="${TT_NEIGHBORS_CACHE-${XDG_CACHE_HOME:-${HOME}/.cache}/tteams/neighbors-${IDENTITY}}"
 NEIGHBORS_RAW=$(ip -4 neigh | grep "${INTERFACE}")
 NEIGHBORS=$(awk -F ' ' '{print $1}' <<< "${NEIGHBORS_RAW[@]}")
 
@@ -3,6 +3,7 @@
 #include "TTChatHandlerMock.hpp"
 #include "TTNeighborsStubMock.hpp"
 #include "TTNeighborsChatStubMock.hpp"
+#include "TTNeighborsChatStreamMock.hpp"
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
@@ -12,8 +13,21 @@ using ::testing::DoAll;
 using ::testing::InSequence;
 using ::testing::_;
 using ::testing::AtLeast;
+using ::testing::AtMost;
 using ::testing::Matcher;
 using ::testing::ByMove;
+using ::testing::AnyNumber;
+using ::testing::NiceMock;
+using ::testing::ElementsAre;
+
+// Sequence numbers depend on the sender epoch, only content is compared
+MATCHER_P(IsTellContentEqualTo, request, "") {
+    return arg.identity == request.identity && arg.message == request.message;
+}
+
+MATCHER_P(IsMessagesContentEqualTo, request, "") {
+    return arg.identity == request.identity && arg.messages == request.messages;
+}
 
 class TTBroadcasterChatTest : public Test {
 protected:
@@ -21,12 +35,16 @@ protected:
         mContactsHandler = std::make_shared<TTContactsHandlerMock>();
         mChatHandler = std::make_shared<TTChatHandlerMock>();
         mNeighborsStub = std::make_shared<TTNeighborsStubMock>();
+        // By default stream is not available, tell and narrate are used
+        EXPECT_CALL(*mNeighborsStub, createChatStream(_))
+            .Times(AnyNumber())
+            .WillRepeatedly([](){ return TTUniqueChatStream(nullptr); });
     }
     ~TTBroadcasterChatTest() {
     }
     // Called after constructor, before each test
     virtual void SetUp() override {
-        mBroadcaster = std::make_unique<TTBroadcasterChat>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mNetworkInterface);
+        mBroadcaster = std::make_unique<TTBroadcasterChat>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface);
     }
     // Called before destructor, after each test
     virtual void TearDown() override {
@@ -36,71 +54,117 @@ protected:
     std::shared_ptr<TTContactsHandlerMock> mContactsHandler;
     std::shared_ptr<TTChatHandlerMock> mChatHandler;
     std::shared_ptr<TTNeighborsStubMock> mNeighborsStub;
+    TTNeighborsLiveness mLiveness;
     std::unique_ptr<TTBroadcasterChat> mBroadcaster;
 };
 
 TEST_F(TTBroadcasterChatTest, HappyPathReceiveTellRequest) {
     const TTTellRequest request("312382290f4f71e7fb7f00449fb529fce3b8ec95", "Hello world!");
     std::optional<size_t> id = 1;
-    EXPECT_CALL(*mContactsHandler, get(request.identity))
-        .Times(1)
-        .WillOnce(Return(id));
     TTContactsHandlerEntry entry("nickname", "312382290f4f71e7fb7f00449fb529fce3b8ec95", "192.168.1.88:875");
-    EXPECT_CALL(*mContactsHandler, get(Matcher<size_t>(id.value())))
+    EXPECT_CALL(*mContactsHandler, snapshot())
         .Times(1)
-        .WillOnce(Return(entry));
+        .WillOnce(Return(TTContactsHandlerMock::makeSnapshot({{id.value(), entry}})));
     EXPECT_CALL(*mContactsHandler, receive(id.value()))
         .Times(1)
         .WillOnce(Return(true));
     EXPECT_CALL(*mChatHandler, receive(id.value(), request.message, _))
         .Times(1)
         .WillOnce(Return(true));
+    EXPECT_FALSE(mLiveness.last(id.value()));
     EXPECT_TRUE(mBroadcaster->handleReceive(request));
+    // Received message proves liveness of the sender
+    EXPECT_TRUE(mLiveness.last(id.value()));
+}
+
+TEST_F(TTBroadcasterChatTest, HappyPathReceiveTellRequestDuplicateIgnored) {
+    const std::string identity = "312382290f4f71e7fb7f00449fb529fce3b8ec95";
+    const TTTellRequest request(identity, "Hello world!", 7, 1);
+    const TTTellRequest restartedRequest(identity, "Hello again!", 8, 1);
+    std::optional<size_t> id = 1;
+    TTContactsHandlerEntry entry("nickname", identity, "192.168.1.88:875");
+    EXPECT_CALL(*mContactsHandler, snapshot())
+        .Times(3)
+        .WillRepeatedly(Return(TTContactsHandlerMock::makeSnapshot({{id.value(), entry}})));
+    EXPECT_CALL(*mContactsHandler, receive(id.value()))
+        .Times(2)
+        .WillRepeatedly(Return(true));
+    EXPECT_CALL(*mChatHandler, receive(id.value(), request.message, _))
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mChatHandler, receive(id.value(), restartedRequest.message, _))
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_TRUE(mBroadcaster->handleReceive(request));
+    // Retransmission
+    EXPECT_TRUE(mBroadcaster->handleReceive(request));
+    // Sender restarted (new epoch), numbering starts over
+    EXPECT_TRUE(mBroadcaster->handleReceive(restartedRequest));
+}
+
+TEST_F(TTBroadcasterChatTest, HappyPathReceiveNarrateRequestOnlyUnreceivedSuffixHandled) {
+    const std::string identity = "312382290f4f71e7fb7f00449fb529fce3b8ec95";
+    const TTNarrateRequest partialRequest(identity, {"Hello", "world"}, 7, 1);
+    const TTNarrateRequest retransmittedRequest(identity, {"Hello", "world", "!"}, 7, 1);
+    std::optional<size_t> id = 1;
+    TTContactsHandlerEntry entry("nickname", identity, "192.168.1.88:875");
+    EXPECT_CALL(*mContactsHandler, snapshot())
+        .Times(2)
+        .WillRepeatedly(Return(TTContactsHandlerMock::makeSnapshot({{id.value(), entry}})));
+    {
+        InSequence __;
+        EXPECT_CALL(*mContactsHandler, receiveMany(id.value(), 2))
+            .Times(1)
+            .WillOnce(Return(true));
+        EXPECT_CALL(*mChatHandler, receiveMany(id.value(), ElementsAre("Hello", "world"), _))
+            .Times(1)
+            .WillOnce(Return(true));
+        EXPECT_CALL(*mContactsHandler, receiveMany(id.value(), 1))
+            .Times(1)
+            .WillOnce(Return(true));
+        EXPECT_CALL(*mChatHandler, receiveMany(id.value(), ElementsAre("!"), _))
+            .Times(1)
+            .WillOnce(Return(true));
+    }
+    EXPECT_TRUE(mBroadcaster->handleReceive(partialRequest));
+    EXPECT_TRUE(mBroadcaster->handleReceive(retransmittedRequest));
 }
 
 TEST_F(TTBroadcasterChatTest, HappyPathReceiveTellRequestMessageToItself) {
     const TTTellRequest request("312382290f4f71e7fb7f00449fb529fce3b8ec95", "Hello world!");
     std::optional<size_t> id = 1;
-    EXPECT_CALL(*mContactsHandler, get(request.identity))
-        .Times(1)
-        .WillOnce(Return(id));
     TTContactsHandlerEntry entry("nickname", "312382290f4f71e7fb7f00449fb529fce3b8ec95", "192.168.1.1:1777");
-    EXPECT_CALL(*mContactsHandler, get(Matcher<size_t>(id.value())))
+    EXPECT_CALL(*mContactsHandler, snapshot())
         .Times(1)
-        .WillOnce(Return(entry));
+        .WillOnce(Return(TTContactsHandlerMock::makeSnapshot({{id.value(), entry}})));
     EXPECT_TRUE(mBroadcaster->handleReceive(request));
 }
 
 TEST_F(TTBroadcasterChatTest, UnhappyPathReceiveTellRequestNoIdentity) {
     const TTTellRequest request("312382290f4f71e7fb7f00449fb529fce3b8ec95", "Hello world!");
-    EXPECT_CALL(*mContactsHandler, get(request.identity))
+    EXPECT_CALL(*mContactsHandler, snapshot())
         .Times(1)
-        .WillOnce(Return(std::nullopt));
+        .WillOnce(Return(std::make_shared<const TTContactsSnapshot>()));
     EXPECT_FALSE(mBroadcaster->handleReceive(request));
 }
 
-TEST_F(TTBroadcasterChatTest, UnhappyPathReceiveTellRequestContactsHandlerFailedToGetEntry) {
+TEST_F(TTBroadcasterChatTest, UnhappyPathReceiveTellRequestIdentityNotInSnapshot) {
     const TTTellRequest request("312382290f4f71e7fb7f00449fb529fce3b8ec95", "Hello world!");
-    std::optional<size_t> id = 1;
-    EXPECT_CALL(*mContactsHandler, get(request.identity))
-        .Times(1)
-        .WillOnce(Return(id));
-    EXPECT_CALL(*mContactsHandler, get(Matcher<size_t>(id.value())))
+    TTContactsHandlerEntry entry("nickname", "f71e7fb7f00449fb529fce3b8ec95312382290f4", "192.168.1.88:875");
+    EXPECT_CALL(*mContactsHandler, snapshot())
         .Times(1)
-        .WillOnce(Return(std::nullopt));
+        .WillOnce(Return(TTContactsHandlerMock::makeSnapshot({{1, entry}})));
     EXPECT_FALSE(mBroadcaster->handleReceive(request));
+    EXPECT_FALSE(mBroadcaster->isStopped());
 }
 
 TEST_F(TTBroadcasterChatTest, UnhappyPathReceiveTellRequestContactsHandlerFailed) {
     const TTTellRequest request("312382290f4f71e7fb7f00449fb529fce3b8ec95", "Hello world!");
     std::optional<size_t> id = 1;
-    EXPECT_CALL(*mContactsHandler, get(request.identity))
-        .Times(1)
-        .WillOnce(Return(id));
     TTContactsHandlerEntry entry("nickname", "312382290f4f71e7fb7f00449fb529fce3b8ec95", "192.168.1.88:875");
-    EXPECT_CALL(*mContactsHandler, get(Matcher<size_t>(id.value())))
+    EXPECT_CALL(*mContactsHandler, snapshot())
         .Times(1)
-        .WillOnce(Return(entry));
+        .WillOnce(Return(TTContactsHandlerMock::makeSnapshot({{id.value(), entry}})));
     EXPECT_CALL(*mContactsHandler, receive(id.value()))
         .Times(1)
         .WillOnce(Return(false));
@@ -110,13 +174,10 @@ TEST_F(TTBroadcasterChatTest, UnhappyPathReceiveTellRequestContactsHandlerFailed
 TEST_F(TTBroadcasterChatTest, UnhappyPathReceiveTellRequestChatHandlerFailed) {
     const TTTellRequest request("312382290f4f71e7fb7f00449fb529fce3b8ec95", "Hello world!");
     std::optional<size_t> id = 1;
-    EXPECT_CALL(*mContactsHandler, get(request.identity))
-        .Times(1)
-        .WillOnce(Return(id));
     TTContactsHandlerEntry entry("nickname", "312382290f4f71e7fb7f00449fb529fce3b8ec95", "192.168.1.88:875");
-    EXPECT_CALL(*mContactsHandler, get(Matcher<size_t>(id.value())))
+    EXPECT_CALL(*mContactsHandler, snapshot())
         .Times(1)
-        .WillOnce(Return(entry));
+        .WillOnce(Return(TTContactsHandlerMock::makeSnapshot({{id.value(), entry}})));
     EXPECT_CALL(*mContactsHandler, receive(id.value()))
         .Times(1)
         .WillOnce(Return(true));
@@ -129,68 +190,55 @@ TEST_F(TTBroadcasterChatTest, UnhappyPathReceiveTellRequestChatHandlerFailed) {
 TEST_F(TTBroadcasterChatTest, HappyPathReceiveNarrateRequest) {
     const TTNarrateRequest request("312382290f4f71e7fb7f00449fb529fce3b8ec95", { "a", "b", "c" });
     std::optional<size_t> id = 1;
-    EXPECT_CALL(*mContactsHandler, get(request.identity))
-        .Times(1)
-        .WillOnce(Return(id));
     TTContactsHandlerEntry entry("nickname", "312382290f4f71e7fb7f00449fb529fce3b8ec95", "192.168.1.88:875");
-    EXPECT_CALL(*mContactsHandler, get(Matcher<size_t>(id.value())))
+    EXPECT_CALL(*mContactsHandler, snapshot())
         .Times(1)
-        .WillOnce(Return(entry));
-    EXPECT_CALL(*mContactsHandler, receive(id.value()))
+        .WillOnce(Return(TTContactsHandlerMock::makeSnapshot({{id.value(), entry}})));
+    EXPECT_CALL(*mContactsHandler, receiveMany(id.value(), 3))
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mChatHandler, receiveMany(id.value(), ElementsAre("a", "b", "c"), _))
         .Times(1)
         .WillOnce(Return(true));
-    for (const auto& message : request.messages) {
-        EXPECT_CALL(*mChatHandler, receive(id.value(), message, _))
-            .Times(1)
-            .WillOnce(Return(true));
-    }
     EXPECT_TRUE(mBroadcaster->handleReceive(request));
 }
 
 TEST_F(TTBroadcasterChatTest, HappyPathReceiveNarrateRequestMessageToItself) {
     const TTNarrateRequest request("312382290f4f71e7fb7f00449fb529fce3b8ec95", { "a", "b", "c" });
     std::optional<size_t> id = 1;
-    EXPECT_CALL(*mContactsHandler, get(request.identity))
-        .Times(1)
-        .WillOnce(Return(id));
     TTContactsHandlerEntry entry("nickname", "312382290f4f71e7fb7f00449fb529fce3b8ec95", "192.168.1.1:1777");
-    EXPECT_CALL(*mContactsHandler, get(Matcher<size_t>(id.value())))
+    EXPECT_CALL(*mContactsHandler, snapshot())
         .Times(1)
-        .WillOnce(Return(entry));
+        .WillOnce(Return(TTContactsHandlerMock::makeSnapshot({{id.value(), entry}})));
     EXPECT_TRUE(mBroadcaster->handleReceive(request));
 }
 
 TEST_F(TTBroadcasterChatTest, UnhappyPathReceiveNarrateRequestNoIdentity) {
     const TTNarrateRequest request("312382290f4f71e7fb7f00449fb529fce3b8ec95", { "a", "b", "c" });
-    EXPECT_CALL(*mContactsHandler, get(request.identity))
+    EXPECT_CALL(*mContactsHandler, snapshot())
         .Times(1)
-        .WillOnce(Return(std::nullopt));
+        .WillOnce(Return(std::make_shared<const TTContactsSnapshot>()));
     EXPECT_FALSE(mBroadcaster->handleReceive(request));
 }
 
-TEST_F(TTBroadcasterChatTest, UnhappyPathReceiveNarrateRequestContactsHandlerFailedToGetEntry) {
+TEST_F(TTBroadcasterChatTest, UnhappyPathReceiveNarrateRequestIdentityNotInSnapshot) {
     const TTNarrateRequest request("312382290f4f71e7fb7f00449fb529fce3b8ec95", { "a", "b", "c" });
-    std::optional<size_t> id = 1;
-    EXPECT_CALL(*mContactsHandler, get(request.identity))
-        .Times(1)
-        .WillOnce(Return(id));
-    EXPECT_CALL(*mContactsHandler, get(Matcher<size_t>(id.value())))
+    TTContactsHandlerEntry entry("nickname", "f71e7fb7f00449fb529fce3b8ec95312382290f4", "192.168.1.88:875");
+    EXPECT_CALL(*mContactsHandler, snapshot())
         .Times(1)
-        .WillOnce(Return(std::nullopt));
+        .WillOnce(Return(TTContactsHandlerMock::makeSnapshot({{1, entry}})));
     EXPECT_FALSE(mBroadcaster->handleReceive(request));
+    EXPECT_FALSE(mBroadcaster->isStopped());
 }
 
 TEST_F(TTBroadcasterChatTest, UnhappyPathReceiveNarrateRequestContactsHandlerFailed) {
     const TTNarrateRequest request("312382290f4f71e7fb7f00449fb529fce3b8ec95", { "a", "b", "c" });
     std::optional<size_t> id = 1;
-    EXPECT_CALL(*mContactsHandler, get(request.identity))
-        .Times(1)
-        .WillOnce(Return(id));
     TTContactsHandlerEntry entry("nickname", "312382290f4f71e7fb7f00449fb529fce3b8ec95", "192.168.1.88:875");
-    EXPECT_CALL(*mContactsHandler, get(Matcher<size_t>(id.value())))
+    EXPECT_CALL(*mContactsHandler, snapshot())
         .Times(1)
-        .WillOnce(Return(entry));
-    EXPECT_CALL(*mContactsHandler, receive(id.value()))
+        .WillOnce(Return(TTContactsHandlerMock::makeSnapshot({{id.value(), entry}})));
+    EXPECT_CALL(*mContactsHandler, receiveMany(id.value(), 3))
         .Times(1)
         .WillOnce(Return(false));
     EXPECT_FALSE(mBroadcaster->handleReceive(request));
@@ -199,17 +247,14 @@ TEST_F(TTBroadcasterChatTest, UnhappyPathReceiveNarrateRequestContactsHandlerFai
 TEST_F(TTBroadcasterChatTest, UnhappyPathReceiveNarrateRequestChatHandlerFailed) {
     const TTNarrateRequest request("312382290f4f71e7fb7f00449fb529fce3b8ec95", { "a", "b", "c" });
     std::optional<size_t> id = 1;
-    EXPECT_CALL(*mContactsHandler, get(request.identity))
-        .Times(1)
-        .WillOnce(Return(id));
     TTContactsHandlerEntry entry("nickname", "312382290f4f71e7fb7f00449fb529fce3b8ec95", "192.168.1.88:875");
-    EXPECT_CALL(*mContactsHandler, get(Matcher<size_t>(id.value())))
+    EXPECT_CALL(*mContactsHandler, snapshot())
         .Times(1)
-        .WillOnce(Return(entry));
-    EXPECT_CALL(*mContactsHandler, receive(id.value()))
+        .WillOnce(Return(TTContactsHandlerMock::makeSnapshot({{id.value(), entry}})));
+    EXPECT_CALL(*mContactsHandler, receiveMany(id.value(), 3))
         .Times(1)
         .WillOnce(Return(true));
-    EXPECT_CALL(*mChatHandler, receive(id.value(), request.messages.front(), _))
+    EXPECT_CALL(*mChatHandler, receiveMany(id.value(), ElementsAre("a", "b", "c"), _))
         .Times(1)
         .WillOnce(Return(false));
     EXPECT_FALSE(mBroadcaster->handleReceive(request));
@@ -363,6 +408,9 @@ TEST_F(TTBroadcasterChatTest, UnhappyPathSendTellImmediateStubCreationFailed) {
     EXPECT_CALL(*mContactsHandler, get(currentId))
         .Times(AtLeast(1))
         .WillRepeatedly(Return(entry));
+    EXPECT_CALL(*mContactsHandler, snapshot())
+        .Times(AtLeast(1))
+        .WillRepeatedly(Return(TTContactsHandlerMock::makeSnapshot({{currentId, entry}})));
     EXPECT_CALL(*mContactsHandler, get(Matcher<size_t>(size_t(0))))
         .Times(AtLeast(1))
         .WillRepeatedly(Return(hostEntry));
@@ -374,7 +422,7 @@ TEST_F(TTBroadcasterChatTest, UnhappyPathSendTellImmediateStubCreationFailed) {
         EXPECT_CALL(*mNeighborsStub, createChatStub(entry.ipAddressAndPort))
             .Times(1)
             .WillOnce(Return(ByMove(std::make_unique<TTNeighborsChatStubMock>(entry.ipAddressAndPort))));
-        EXPECT_CALL(*mNeighborsStub, sendTell(_, expectedRequest))
+        EXPECT_CALL(*mNeighborsStub, sendTell(_, IsTellContentEqualTo(expectedRequest)))
             .Times(1)
             .WillOnce(Return(TTTellResponse{true}));
     }
@@ -388,6 +436,8 @@ TEST_F(TTBroadcasterChatTest, UnhappyPathSendTellImmediateStubCreationFailed) {
     mBroadcaster->stop();
     std::this_thread::sleep_for(std::chrono::milliseconds{100});
     loop.join();
+    // Delivered message proves liveness of the neighbor
+    EXPECT_TRUE(mLiveness.last(currentId));
 }
 
 TEST_F(TTBroadcasterChatTest, UnhappyPathSendTellLazyStubCreationFailed) {
@@ -411,6 +461,9 @@ TEST_F(TTBroadcasterChatTest, UnhappyPathSendTellLazyStubCreationFailed) {
     EXPECT_CALL(*mContactsHandler, get(currentId))
         .Times(AtLeast(1))
         .WillRepeatedly(Return(entry));
+    EXPECT_CALL(*mContactsHandler, snapshot())
+        .Times(AtLeast(1))
+        .WillRepeatedly(Return(TTContactsHandlerMock::makeSnapshot({{currentId, entry}})));
     EXPECT_CALL(*mNeighborsStub, createChatStub(entry.ipAddressAndPort))
         .Times(AtLeast(2))
         .WillRepeatedly([&](){ return std::unique_ptr<TTNeighborsChatStubMock>(nullptr); });
@@ -424,6 +477,7 @@ TEST_F(TTBroadcasterChatTest, UnhappyPathSendTellLazyStubCreationFailed) {
     mBroadcaster->stop();
     std::this_thread::sleep_for(std::chrono::milliseconds{100});
     loop.join();
+    EXPECT_FALSE(mLiveness.last(currentId));
 }
 
 TEST_F(TTBroadcasterChatTest, HappyPathSendTellImmediateStubCreationFailed) {
@@ -450,6 +504,9 @@ TEST_F(TTBroadcasterChatTest, HappyPathSendTellImmediateStubCreationFailed) {
     EXPECT_CALL(*mContactsHandler, get(currentId))
         .Times(AtLeast(1))
         .WillRepeatedly(Return(neighborEntry));
+    EXPECT_CALL(*mContactsHandler, snapshot())
+        .Times(AtLeast(1))
+        .WillRepeatedly(Return(TTContactsHandlerMock::makeSnapshot({{currentId, neighborEntry}})));
     EXPECT_CALL(*mContactsHandler, get(Matcher<size_t>(size_t(0))))
         .Times(AtLeast(1))
         .WillRepeatedly(Return(hostEntry));
@@ -461,7 +518,7 @@ TEST_F(TTBroadcasterChatTest, HappyPathSendTellImmediateStubCreationFailed) {
         EXPECT_CALL(*mNeighborsStub, createChatStub(neighborEntry.ipAddressAndPort))
             .Times(1)
             .WillOnce(Return(ByMove(std::make_unique<TTNeighborsChatStubMock>(neighborEntry.ipAddressAndPort))));
-        EXPECT_CALL(*mNeighborsStub, sendTell(_, expectedRequest))
+        EXPECT_CALL(*mNeighborsStub, sendTell(_, IsTellContentEqualTo(expectedRequest)))
             .Times(1)
             .WillOnce(Return(TTTellResponse{true}));
     }
@@ -507,6 +564,9 @@ TEST_F(TTBroadcasterChatTest, HappyPathSendNarrateImmediateStubCreationFailed) {
     EXPECT_CALL(*mContactsHandler, get(currentId))
         .Times(AtLeast(1))
         .WillRepeatedly(Return(neighborEntry));
+    EXPECT_CALL(*mContactsHandler, snapshot())
+        .Times(AtLeast(1))
+        .WillRepeatedly(Return(TTContactsHandlerMock::makeSnapshot({{currentId, neighborEntry}})));
     EXPECT_CALL(*mContactsHandler, get(Matcher<size_t>(size_t(0))))
         .Times(AtLeast(1))
         .WillRepeatedly(Return(hostEntry));
@@ -518,7 +578,7 @@ TEST_F(TTBroadcasterChatTest, HappyPathSendNarrateImmediateStubCreationFailed) {
         EXPECT_CALL(*mNeighborsStub, createChatStub(neighborEntry.ipAddressAndPort))
             .Times(1)
             .WillOnce(Return(ByMove(std::make_unique<TTNeighborsChatStubMock>(neighborEntry.ipAddressAndPort))));
-        EXPECT_CALL(*mNeighborsStub, sendNarrate(_, expectedRequest))
+        EXPECT_CALL(*mNeighborsStub, sendNarrate(_, IsMessagesContentEqualTo(expectedRequest)))
             .Times(1)
             .WillOnce(Return(TTNarrateResponse{true}));
     }
@@ -535,3 +595,433 @@ TEST_F(TTBroadcasterChatTest, HappyPathSendNarrateImmediateStubCreationFailed) {
     std::this_thread::sleep_for(std::chrono::milliseconds{100});
     loop.join();
 }
+
+TEST_F(TTBroadcasterChatTest, HappyPathSendSlowNeighborDoesNotDelayOthers) {
+    const TTContactsHandlerEntry hostEntry{"host", "888992ef", mNetworkInterface.getIpAddressAndPort()};
+    const TTContactsHandlerEntry slowEntry{"slow", "f71e7fb", "192.168.1.80:8879"};
+    const TTContactsHandlerEntry fastEntry{"fast", "e7fb7f0", "192.168.1.81:8879"};
+    std::atomic<bool> fastDelivered{false};
+    EXPECT_CALL(*mContactsHandler, current())
+        .Times(AtLeast(2))
+        .WillOnce(Return(1))
+        .WillRepeatedly(Return(2));
+    EXPECT_CALL(*mChatHandler, current())
+        .Times(AtLeast(2))
+        .WillOnce(Return(1))
+        .WillRepeatedly(Return(2));
+    EXPECT_CALL(*mContactsHandler, send(_))
+        .Times(2)
+        .WillRepeatedly(Return(true));
+    EXPECT_CALL(*mChatHandler, send(_, _, _))
+        .Times(2)
+        .WillRepeatedly(Return(true));
+    EXPECT_CALL(*mContactsHandler, get(Matcher<size_t>(size_t(0))))
+        .Times(AtLeast(1))
+        .WillRepeatedly(Return(hostEntry));
+    EXPECT_CALL(*mContactsHandler, get(Matcher<size_t>(size_t(1))))
+        .Times(AtLeast(1))
+        .WillRepeatedly(Return(slowEntry));
+    EXPECT_CALL(*mContactsHandler, get(Matcher<size_t>(size_t(2))))
+        .Times(AtLeast(1))
+        .WillRepeatedly(Return(fastEntry));
+    EXPECT_CALL(*mContactsHandler, snapshot())
+        .Times(AtLeast(1))
+        .WillRepeatedly(Return(TTContactsHandlerMock::makeSnapshot({{1, slowEntry}, {2, fastEntry}})));
+    EXPECT_CALL(*mNeighborsStub, createChatStub(_))
+        .Times(2)
+        .WillRepeatedly([](const std::string& ipAddressAndPort){ return std::make_unique<TTNeighborsChatStubMock>(ipAddressAndPort); });
+    EXPECT_CALL(*mNeighborsStub, sendTell(_, IsTellContentEqualTo(TTTellRequest(hostEntry.identity, "slow"))))
+        .Times(1)
+        .WillOnce([](TTNeighborsChatStubIf&, const TTTellRequest&) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{3000});
+            return TTTellResponse{true};
+        });
+    EXPECT_CALL(*mNeighborsStub, sendTell(_, IsTellContentEqualTo(TTTellRequest(hostEntry.identity, "fast"))))
+        .Times(1)
+        .WillOnce([&](TTNeighborsChatStubIf&, const TTTellRequest&) {
+            fastDelivered.store(true);
+            return TTTellResponse{true};
+        });
+    std::thread loop(std::bind(&TTBroadcasterChat::run, mBroadcaster.get()));
+    EXPECT_TRUE(mBroadcaster->handleSend("slow"));
+    EXPECT_TRUE(mBroadcaster->handleSend("fast"));
+    // Fast neighbor is delivered while slow one is still in flight
+    std::this_thread::sleep_for(std::chrono::milliseconds{1000});
+    EXPECT_TRUE(fastDelivered.load());
+    std::this_thread::sleep_for(std::chrono::milliseconds{3000});
+    mBroadcaster->stop();
+    loop.join();
+}
+
+TEST_F(TTBroadcasterChatTest, HappyPathSendDoesNotWaitForNetwork) {
+    const TTContactsHandlerEntry hostEntry{"host", "888992ef", mNetworkInterface.getIpAddressAndPort()};
+    const TTContactsHandlerEntry neighborEntry{"neighbor", "f71e7fb", "192.168.1.80:8879"};
+    EXPECT_CALL(*mContactsHandler, current())
+        .Times(2)
+        .WillRepeatedly(Return(1));
+    EXPECT_CALL(*mChatHandler, current())
+        .Times(2)
+        .WillRepeatedly(Return(1));
+    EXPECT_CALL(*mContactsHandler, send(1))
+        .Times(2)
+        .WillRepeatedly(Return(true));
+    EXPECT_CALL(*mChatHandler, send(1, _, _))
+        .Times(2)
+        .WillRepeatedly(Return(true));
+    EXPECT_CALL(*mContactsHandler, get(Matcher<size_t>(size_t(0))))
+        .Times(AtLeast(1))
+        .WillRepeatedly(Return(hostEntry));
+    EXPECT_CALL(*mContactsHandler, get(Matcher<size_t>(size_t(1))))
+        .Times(AtLeast(1))
+        .WillRepeatedly(Return(neighborEntry));
+    EXPECT_CALL(*mContactsHandler, snapshot())
+        .Times(AtLeast(1))
+        .WillRepeatedly(Return(TTContactsHandlerMock::makeSnapshot({{1, neighborEntry}})));
+    EXPECT_CALL(*mNeighborsStub, createChatStub(neighborEntry.ipAddressAndPort))
+        .Times(1)
+        .WillOnce(Return(ByMove(std::make_unique<TTNeighborsChatStubMock>(neighborEntry.ipAddressAndPort))));
+    std::atomic<bool> inFlight{false};
+    EXPECT_CALL(*mNeighborsStub, sendTell(_, IsTellContentEqualTo(TTTellRequest(hostEntry.identity, "first"))))
+        .Times(1)
+        .WillOnce([&](TTNeighborsChatStubIf&, const TTTellRequest&) {
+            inFlight.store(true);
+            std::this_thread::sleep_for(std::chrono::milliseconds{3000});
+            return TTTellResponse{true};
+        });
+    EXPECT_CALL(*mNeighborsStub, sendTell(_, IsTellContentEqualTo(TTTellRequest(hostEntry.identity, "second"))))
+        .Times(AtMost(1))
+        .WillRepeatedly(Return(TTTellResponse{true}));
+    std::thread loop(std::bind(&TTBroadcasterChat::run, mBroadcaster.get()));
+    EXPECT_TRUE(mBroadcaster->handleSend("first"));
+    while (!inFlight.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+    // Sender returns immediately while the network call is stalled
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(mBroadcaster->handleSend("second"));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds{100});
+    mBroadcaster->stop();
+    loop.join();
+}
+
+class TTBroadcasterChatStreamTest : public TTBroadcasterChatTest {
+protected:
+    void SetUpNeighbor() {
+        EXPECT_CALL(*mContactsHandler, current())
+            .Times(AtLeast(1))
+            .WillRepeatedly(Return(mCurrentId));
+        EXPECT_CALL(*mChatHandler, current())
+            .Times(AtLeast(1))
+            .WillRepeatedly(Return(mCurrentId));
+        EXPECT_CALL(*mContactsHandler, send(mCurrentId))
+            .Times(AtLeast(1))
+            .WillRepeatedly(Return(true));
+        EXPECT_CALL(*mChatHandler, send(mCurrentId, mMessage, _))
+            .Times(AtLeast(1))
+            .WillRepeatedly(Return(true));
+        EXPECT_CALL(*mContactsHandler, get(mCurrentId))
+            .Times(AtLeast(1))
+            .WillRepeatedly(Return(mNeighborEntry));
+        EXPECT_CALL(*mContactsHandler, snapshot())
+            .Times(AtLeast(1))
+            .WillRepeatedly(Return(TTContactsHandlerMock::makeSnapshot({{mCurrentId, mNeighborEntry}})));
+        EXPECT_CALL(*mContactsHandler, get(Matcher<size_t>(size_t(0))))
+            .Times(AtLeast(1))
+            .WillRepeatedly(Return(mHostEntry));
+        EXPECT_CALL(*mNeighborsStub, createChatStub(mNeighborEntry.ipAddressAndPort))
+            .Times(1)
+            .WillOnce(Return(ByMove(std::make_unique<TTNeighborsChatStubMock>(mNeighborEntry.ipAddressAndPort))));
+        EXPECT_CALL(mStreamStub, ConverseRaw(_))
+            .Times(AtLeast(1))
+            .WillRepeatedly([](::grpc::ClientContext*) { return new NiceMock<TTNeighborsChatStreamMock>(); });
+        EXPECT_CALL(*mNeighborsStub, createChatStream(_))
+            .Times(1)
+            .WillOnce([&](){ return std::make_unique<TTNeighborsChatStream>(mStreamStub); });
+    }
+    void SendAndWait() {
+        std::thread loop(std::bind(&TTBroadcasterChat::run, mBroadcaster.get()));
+        EXPECT_TRUE(mBroadcaster->handleSend(mMessage));
+        EXPECT_FALSE(mBroadcaster->isStopped());
+        std::this_thread::sleep_for(std::chrono::milliseconds{4000});
+        mBroadcaster->stop();
+        std::this_thread::sleep_for(std::chrono::milliseconds{100});
+        loop.join();
+    }
+    const size_t mCurrentId = 1;
+    const std::string mMessage = "foo";
+    const std::string mHostIdentity = "888992ef";
+    const TTContactsHandlerEntry mNeighborEntry{"neighbor", "f71e7fb", "192.168.1.80:8879"};
+    const TTContactsHandlerEntry mHostEntry{"host", mHostIdentity, mNetworkInterface.getIpAddressAndPort()};
+    TTNeighborsChatStubMock mStreamStub{mNeighborEntry.ipAddressAndPort};
+};
+
+TEST_F(TTBroadcasterChatStreamTest, HappyPathSendConverse) {
+    SetUpNeighbor();
+    EXPECT_CALL(*mNeighborsStub, sendConverse(_, IsMessagesContentEqualTo(TTConverseRequest(mHostIdentity, {mMessage}))))
+        .Times(1)
+        .WillOnce(Return(TTConverseResponse{true, 1}));
+    EXPECT_CALL(*mNeighborsStub, sendTell(_, _))
+        .Times(0);
+    SendAndWait();
+}
+
+TEST_F(TTBroadcasterChatStreamTest, HappyPathSendFallbackKeepsSequenceNumbers) {
+    SetUpNeighbor();
+    uint64_t epoch = 0;
+    EXPECT_CALL(*mNeighborsStub, sendConverse(_, IsMessagesContentEqualTo(TTConverseRequest(mHostIdentity, {mMessage}))))
+        .Times(1)
+        .WillOnce([&](TTNeighborsChatStream&, const TTConverseRequest& request) {
+            EXPECT_EQ(request.sequence, 1);
+            epoch = request.epoch;
+            return TTConverseResponse{false, 0};
+        });
+    // Unacknowledged message is sent again with the same number, so the receiver can drop duplicate
+    EXPECT_CALL(*mNeighborsStub, sendTell(_, IsTellContentEqualTo(TTTellRequest(mHostIdentity, mMessage))))
+        .Times(1)
+        .WillOnce([&](TTNeighborsChatStubIf&, const TTTellRequest& request) {
+            EXPECT_EQ(request.epoch, epoch);
+            EXPECT_EQ(request.sequence, 1);
+            return TTTellResponse{true};
+        });
+    SendAndWait();
+}
+
+TEST_F(TTBroadcasterChatStreamTest, HappyPathSendConverseBrokenStreamFallbackToTell) {
+    SetUpNeighbor();
+    EXPECT_CALL(*mNeighborsStub, sendConverse(_, IsMessagesContentEqualTo(TTConverseRequest(mHostIdentity, {mMessage}))))
+        .Times(1)
+        .WillOnce(Return(TTConverseResponse{false, 0}));
+    EXPECT_CALL(*mNeighborsStub, sendTell(_, IsTellContentEqualTo(TTTellRequest(mHostIdentity, mMessage))))
+        .Times(1)
+        .WillOnce(Return(TTTellResponse{true}));
+    SendAndWait();
+}
+
+class TTBroadcasterChatLimitsTest : public TTBroadcasterChatTest {
+protected:
+    void SetUpNeighbor(const TTBroadcasterChatLimits& limits) {
+        mBroadcaster = std::make_unique<TTBroadcasterChat>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, limits);
+        EXPECT_CALL(*mContactsHandler, current())
+            .Times(AtLeast(1))
+            .WillRepeatedly(Return(mCurrentId));
+        EXPECT_CALL(*mChatHandler, current())
+            .Times(AtLeast(1))
+            .WillRepeatedly(Return(mCurrentId));
+        EXPECT_CALL(*mContactsHandler, send(mCurrentId))
+            .Times(AtLeast(1))
+            .WillRepeatedly(Return(true));
+        EXPECT_CALL(*mChatHandler, send(mCurrentId, _, _))
+            .Times(AtLeast(1))
+            .WillRepeatedly(Return(true));
+        EXPECT_CALL(*mContactsHandler, get(mCurrentId))
+            .Times(AtLeast(1))
+            .WillRepeatedly(Return(mNeighborEntry));
+        EXPECT_CALL(*mContactsHandler, snapshot())
+            .Times(AtLeast(1))
+            .WillRepeatedly(Return(TTContactsHandlerMock::makeSnapshot({{mCurrentId, mNeighborEntry}})));
+        EXPECT_CALL(*mContactsHandler, get(Matcher<size_t>(size_t(0))))
+            .Times(AtLeast(1))
+            .WillRepeatedly(Return(mHostEntry));
+        EXPECT_CALL(*mNeighborsStub, createChatStub(mNeighborEntry.ipAddressAndPort))
+            .Times(1)
+            .WillOnce(Return(ByMove(std::make_unique<TTNeighborsChatStubMock>(mNeighborEntry.ipAddressAndPort))));
+    }
+    // Messages are queued before the consumer starts, so they are dispatched at once
+    void SendAndWait(const std::deque<std::string>& messages) {
+        for (const auto& message : messages) {
+            EXPECT_TRUE(mBroadcaster->handleSend(message));
+        }
+        std::thread loop(std::bind(&TTBroadcasterChat::run, mBroadcaster.get()));
+        std::this_thread::sleep_for(std::chrono::milliseconds{1000});
+        EXPECT_FALSE(mBroadcaster->isStopped());
+        mBroadcaster->stop();
+        loop.join();
+    }
+    const size_t mCurrentId = 1;
+    const std::string mHostIdentity = "888992ef";
+    const TTContactsHandlerEntry mNeighborEntry{"neighbor", "f71e7fb", "192.168.1.80:8879"};
+    const TTContactsHandlerEntry mHostEntry{"host", mHostIdentity, mNetworkInterface.getIpAddressAndPort()};
+};
+
+TEST_F(TTBroadcasterChatLimitsTest, HappyPathSendOverBudgetDropOldest) {
+    TTBroadcasterChatLimits limits;
+    limits.neighborBytes = 8;
+    limits.overflow = TTBroadcasterChatLimits::Overflow::DROP_OLDEST;
+    SetUpNeighbor(limits);
+    EXPECT_CALL(*mNeighborsStub, sendNarrate(_, IsMessagesContentEqualTo(TTNarrateRequest(mHostIdentity, {"bbbb", "cccc"}))))
+        .Times(1)
+        .WillOnce([](TTNeighborsChatStubIf&, const TTNarrateRequest& request) {
+            // Dropped message keeps its sequence number
+            EXPECT_EQ(request.sequence, 2);
+            return TTNarrateResponse{true};
+        });
+    SendAndWait({"aaaa", "bbbb", "cccc"});
+}
+
+TEST_F(TTBroadcasterChatLimitsTest, HappyPathSendOverBudgetDropOldestWhileInFlight) {
+    TTBroadcasterChatLimits limits;
+    limits.neighborBytes = 12;
+    limits.overflow = TTBroadcasterChatLimits::Overflow::DROP_OLDEST;
+    SetUpNeighbor(limits);
+    std::atomic<bool> telling{false};
+    std::atomic<bool> released{false};
+    EXPECT_CALL(*mNeighborsStub, sendTell(_, IsTellContentEqualTo(TTTellRequest(mHostIdentity, "aaaa"))))
+        .Times(1)
+        .WillOnce([&](TTNeighborsChatStubIf&, const TTTellRequest& request) {
+            EXPECT_EQ(request.sequence, 1);
+            telling.store(true);
+            while (!released.load()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            }
+            return TTTellResponse{true};
+        });
+    // Message following the dropped one is not renumbered, so it cannot reuse number already seen by the receiver
+    EXPECT_CALL(*mNeighborsStub, sendNarrate(_, IsMessagesContentEqualTo(TTNarrateRequest(mHostIdentity, {"cccc", "dddd"}))))
+        .Times(1)
+        .WillOnce([](TTNeighborsChatStubIf&, const TTNarrateRequest& request) {
+            EXPECT_EQ(request.sequence, 3);
+            return TTNarrateResponse{true};
+        });
+    std::thread loop(std::bind(&TTBroadcasterChat::run, mBroadcaster.get()));
+    EXPECT_TRUE(mBroadcaster->handleSend("aaaa"));
+    while (!telling.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    // Message being delivered keeps its place, the oldest one after it is dropped
+    EXPECT_TRUE(mBroadcaster->handleSend("bbbb"));
+    EXPECT_TRUE(mBroadcaster->handleSend("cccc"));
+    EXPECT_TRUE(mBroadcaster->handleSend("dddd"));
+    std::this_thread::sleep_for(std::chrono::milliseconds{100});
+    released.store(true);
+    std::this_thread::sleep_for(std::chrono::milliseconds{1000});
+    EXPECT_FALSE(mBroadcaster->isStopped());
+    mBroadcaster->stop();
+    loop.join();
+}
+
+TEST_F(TTBroadcasterChatLimitsTest, HappyPathSendOverGlobalBudgetReject) {
+    TTBroadcasterChatLimits limits;
+    limits.globalBytes = 8;
+    limits.overflow = TTBroadcasterChatLimits::Overflow::REJECT;
+    SetUpNeighbor(limits);
+    EXPECT_CALL(*mNeighborsStub, sendNarrate(_, IsMessagesContentEqualTo(TTNarrateRequest(mHostIdentity, {"aaaa", "bbbb"}))))
+        .Times(1)
+        .WillOnce(Return(TTNarrateResponse{true}));
+    SendAndWait({"aaaa", "bbbb", "cccc"});
+}
+
+TEST_F(TTBroadcasterChatLimitsTest, HappyPathSendOverGlobalBudgetRejectedWithEmptyQueue) {
+    TTBroadcasterChatLimits limits;
+    limits.neighborBytes = 4;
+    limits.globalBytes = 8;
+    limits.overflow = TTBroadcasterChatLimits::Overflow::SPILL;
+    limits.spillDirectory = ::testing::TempDir();
+    SetUpNeighbor(limits);
+    // Message over the neighbor budget is accepted alone, message over the global one is neither queued nor spilled
+    EXPECT_CALL(*mNeighborsStub, sendTell(_, IsTellContentEqualTo(TTTellRequest(mHostIdentity, "aaaaaa"))))
+        .Times(1)
+        .WillOnce(Return(TTTellResponse{true}));
+    EXPECT_CALL(*mNeighborsStub, sendNarrate(_, _))
+        .Times(0);
+    SendAndWait({"aaaaaa", "bbbbbbbbbb"});
+}
+
+TEST_F(TTBroadcasterChatLimitsTest, HappyPathSendOverBudgetSpillAndDrain) {
+    TTBroadcasterChatLimits limits;
+    limits.neighborBytes = 8;
+    limits.overflow = TTBroadcasterChatLimits::Overflow::SPILL;
+    limits.spillDirectory = ::testing::TempDir();
+    SetUpNeighbor(limits);
+    {
+        InSequence __;
+        EXPECT_CALL(*mNeighborsStub, sendNarrate(_, IsMessagesContentEqualTo(TTNarrateRequest(mHostIdentity, {"aaaa", "bbbb"}))))
+            .Times(1)
+            .WillOnce(Return(TTNarrateResponse{true}));
+        // Spilled messages are loaded back and sent without waiting for the flush interval
+        EXPECT_CALL(*mNeighborsStub, sendNarrate(_, IsMessagesContentEqualTo(TTNarrateRequest(mHostIdentity, {"cccc", "dddd"}))))
+            .Times(1)
+            .WillOnce([](TTNeighborsChatStubIf&, const TTNarrateRequest& request) {
+                EXPECT_EQ(request.sequence, 3);
+                return TTNarrateResponse{true};
+            });
+    }
+    SendAndWait({"aaaa", "bbbb", "cccc", "dddd"});
+}
+
+TEST_F(TTBroadcasterChatLimitsTest, HappyPathSendBacklogPaced) {
+    SetUpNeighbor(TTBroadcasterChatLimits());
+    std::deque<std::string> messages;
+    for (size_t i = 0; i < 100; ++i) {
+        messages.push_back(std::to_string(i));
+    }
+    {
+        InSequence __;
+        EXPECT_CALL(*mNeighborsStub, sendNarrate(_, IsMessagesContentEqualTo(TTNarrateRequest(mHostIdentity, {messages.begin(), messages.begin() + 64}))))
+            .Times(1)
+            .WillOnce(Return(TTNarrateResponse{true}));
+        EXPECT_CALL(*mNeighborsStub, sendNarrate(_, IsMessagesContentEqualTo(TTNarrateRequest(mHostIdentity, {messages.begin() + 64, messages.end()}))))
+            .Times(1)
+            .WillOnce(Return(TTNarrateResponse{true}));
+    }
+    SendAndWait(messages);
+}
+
+TEST_F(TTBroadcasterChatLimitsTest, HappyPathSendFirstImmediatelyFollowUpsCoalesced) {
+    TTBroadcasterChatLimits limits;
+    limits.flushWindow = std::chrono::milliseconds{50};
+    SetUpNeighbor(limits);
+    std::atomic<bool> told{false};
+    std::chrono::steady_clock::time_point tellTime;
+    std::chrono::steady_clock::time_point narrateTime;
+    EXPECT_CALL(*mNeighborsStub, sendTell(_, IsTellContentEqualTo(TTTellRequest(mHostIdentity, "first"))))
+        .Times(1)
+        .WillOnce([&](TTNeighborsChatStubIf&, const TTTellRequest&) {
+            tellTime = std::chrono::steady_clock::now();
+            told.store(true);
+            return TTTellResponse{true};
+        });
+    EXPECT_CALL(*mNeighborsStub, sendNarrate(_, IsMessagesContentEqualTo(TTNarrateRequest(mHostIdentity, {"second", "third"}))))
+        .Times(1)
+        .WillOnce([&](TTNeighborsChatStubIf&, const TTNarrateRequest&) {
+            narrateTime = std::chrono::steady_clock::now();
+            return TTNarrateResponse{true};
+        });
+    std::thread loop(std::bind(&TTBroadcasterChat::run, mBroadcaster.get()));
+    const auto firstTime = std::chrono::steady_clock::now();
+    EXPECT_TRUE(mBroadcaster->handleSend("first"));
+    while (!told.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    // Follow-ups within the flush window are sent together
+    const auto secondTime = std::chrono::steady_clock::now();
+    EXPECT_TRUE(mBroadcaster->handleSend("second"));
+    EXPECT_TRUE(mBroadcaster->handleSend("third"));
+    std::this_thread::sleep_for(std::chrono::milliseconds{1000});
+    mBroadcaster->stop();
+    loop.join();
+    // Neither waits for the retry interval
+    EXPECT_LT(tellTime - firstTime, std::chrono::milliseconds{500});
+    EXPECT_LT(narrateTime - secondTime, std::chrono::milliseconds{500});
+}
+
+TEST_F(TTBroadcasterChatLimitsTest, UnhappyPathSendFailedRetriedAfterInterval) {
+    SetUpNeighbor(TTBroadcasterChatLimits());
+    std::vector<std::chrono::steady_clock::time_point> tellTimes;
+    EXPECT_CALL(*mNeighborsStub, sendTell(_, IsTellContentEqualTo(TTTellRequest(mHostIdentity, "foo"))))
+        .Times(2)
+        .WillOnce([&](TTNeighborsChatStubIf&, const TTTellRequest&) {
+            tellTimes.push_back(std::chrono::steady_clock::now());
+            return TTTellResponse{false};
+        })
+        .WillOnce([&](TTNeighborsChatStubIf&, const TTTellRequest&) {
+            tellTimes.push_back(std::chrono::steady_clock::now());
+            return TTTellResponse{true};
+        });
+    std::thread loop(std::bind(&TTBroadcasterChat::run, mBroadcaster.get()));
+    EXPECT_TRUE(mBroadcaster->handleSend("foo"));
+    std::this_thread::sleep_for(std::chrono::milliseconds{7000}); // max retry interval (6s)
+    mBroadcaster->stop();
+    loop.join();
+    ASSERT_EQ(tellTimes.size(), 2);
+    EXPECT_GE(tellTimes[1] - tellTimes[0], std::chrono::milliseconds{3000});
+}
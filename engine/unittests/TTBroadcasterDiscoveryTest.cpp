@@ -5,6 +5,10 @@
 #include "TTNeighborsDiscoveryStubMock.hpp"
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 using ::testing::Test;
 using ::testing::Return;
@@ -13,7 +17,9 @@ using ::testing::InSequence;
 using ::testing::_;
 using ::testing::AtLeast;
 using ::testing::Matcher;
+using ::testing::Field;
 using ::testing::ByMove;
+using ::testing::AnyNumber;
 
 class TTBroadcasterDiscoveryTest : public Test {
 protected:
@@ -41,29 +47,51 @@ protected:
 
     void SetNeighborsGreetCalls() {
         const TTGreetRequest expectedGreetRequest(mHostEntry->nickname, mHostEntry->identity, mHostEntry->ipAddressAndPort);
-        EXPECT_CALL(*mNeighborsStub, sendGreet(_, expectedGreetRequest))
+        EXPECT_CALL(*mNeighborsStub, sendGreets(_, expectedGreetRequest))
             .Times(AtLeast(1))
-            .WillRepeatedly([&](auto& stub, const auto& rhs) {
-                const auto requestIpAddressAndPort = reinterpret_cast<TTNeighborsDiscoveryStubMock&>(stub).ipAddressAndPort;
-                auto& entry = mNeighborEntries.at(requestIpAddressAndPort);
-                entry.sendGreetCounter += 1;
-                const auto retcode = entry.greets.front();
-                entry.greets.pop_front();
-                return TTGreetResponse(retcode, entry.nickname, entry.identity, entry.ipAddress + ":" + entry.port);
+            .WillRepeatedly([&](const auto& stubs, const auto&) {
+                ++mSendGreetsCounter;
+                std::vector<TTGreetResponse> responses;
+                for (auto& stub : stubs) {
+                    const auto requestIpAddressAndPort = reinterpret_cast<TTNeighborsDiscoveryStubMock&>(stub.get()).ipAddressAndPort;
+                    auto& entry = mNeighborEntries.at(requestIpAddressAndPort);
+                    entry.sendGreetCounter += 1;
+                    mGreeted.push_back(requestIpAddressAndPort);
+                    const auto retcode = entry.greets.front();
+                    entry.greets.pop_front();
+                    responses.emplace_back(retcode, entry.nickname, entry.identity, entry.ipAddress + ":" + entry.port, entry.peers);
+                }
+                return responses;
             });
     }
 
     void SetNeighborsHeartbeatCalls() {
-        const TTHeartbeatRequest expectedHeartbeatRequest(mHostEntry->identity);
-        EXPECT_CALL(*mNeighborsStub, sendHeartbeat(_, expectedHeartbeatRequest))
+        EXPECT_CALL(*mNeighborsStub, sendHeartbeats(_, Field(&TTHeartbeatRequest::identity, mHostEntry->identity)))
             .Times(AtLeast(1))
-            .WillRepeatedly([&](auto& stub, const auto& rhs) {
-                const auto requestIpAddressAndPort = reinterpret_cast<TTNeighborsDiscoveryStubMock&>(stub).ipAddressAndPort;
-                auto& entry = mNeighborEntries.at(requestIpAddressAndPort);
-                entry.sendHeartbeatCounter += 1;
-                const auto retcode = entry.heartbeats.front();
-                entry.heartbeats.pop_front();
-                return TTHeartbeatResponse(retcode, entry.identity);
+            .WillRepeatedly([&](const auto& stubs, const auto& rhs) {
+                // Probes run concurrently
+                std::scoped_lock lock(mHeartbeatsMutex);
+                if (rhs.target.empty()) {
+                    mMaxDirectProbes = std::max(mMaxDirectProbes, stubs.size());
+                }
+                std::vector<TTHeartbeatResponse> responses;
+                for (auto& stub : stubs) {
+                    // Helpers of indirect probes cannot reach the target either
+                    if (!rhs.target.empty()) {
+                        responses.emplace_back(false, "");
+                        continue;
+                    }
+                    const auto requestIpAddressAndPort = reinterpret_cast<TTNeighborsDiscoveryStubMock&>(stub.get()).ipAddressAndPort;
+                    auto& entry = mNeighborEntries.at(requestIpAddressAndPort);
+                    entry.sendHeartbeatCounter += 1;
+                    // Last state is kept once the scenario is exhausted
+                    const auto retcode = entry.heartbeats.front();
+                    if (entry.heartbeats.size() > 1) {
+                        entry.heartbeats.pop_front();
+                    }
+                    responses.emplace_back(retcode, entry.identity);
+                }
+                return responses;
             });
     }
 
@@ -135,6 +163,8 @@ protected:
         std::string port;
         std::deque<bool> greets;
         std::deque<bool> heartbeats;
+        // Sent on greet reply
+        std::deque<TTPeer> peers;
         size_t sendGreetCounter = 0;
         size_t sendHeartbeatCounter = 0;
     };
@@ -143,16 +173,22 @@ protected:
     std::shared_ptr<TTContactsHandlerMock> mContactsHandler;
     std::shared_ptr<TTChatHandlerMock> mChatHandler;
     std::shared_ptr<TTNeighborsStubMock> mNeighborsStub;
+    TTNeighborsLiveness mLiveness;
     std::deque<std::string> mNeighbors;
     std::unique_ptr<TTContactsHandlerEntry> mHostEntry;
     std::map<std::string, NeighborEntry> mNeighborEntries;
     size_t mNeighborIdentityCounter;
+    size_t mSendGreetsCounter = 0;
+    // Largest number of members probed directly by single call
+    size_t mMaxDirectProbes = 0;
+    std::mutex mHeartbeatsMutex;
+    std::vector<std::string> mGreeted;
 };
 
 TEST_F(TTBroadcasterDiscoveryTest, HappyPathReceiveGreetRequestNewNeighbor) {
     const TTGreetRequest request("John", "5e5fe55f", std::string{"192.168.1.74:"} + mNetworkInterface.getPort());
     SetNeighborCall(request.nickname, request.identity, request.ipAddressAndPort);
-    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mNetworkInterface, mNeighbors);
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
     EXPECT_TRUE(broadcaster->handleGreet(request));
     EXPECT_FALSE(broadcaster->isStopped());
     broadcaster->stop();
@@ -172,7 +208,7 @@ TEST_F(TTBroadcasterDiscoveryTest, HappyPathReceiveGreetRequestExistingNeighbor)
             .Times(1)
             .WillOnce(Return(true));
     }
-    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mNetworkInterface, mNeighbors);
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
     EXPECT_TRUE(broadcaster->handleGreet(request));
     EXPECT_FALSE(broadcaster->isStopped());
     broadcaster->stop();
@@ -180,9 +216,34 @@ TEST_F(TTBroadcasterDiscoveryTest, HappyPathReceiveGreetRequestExistingNeighbor)
     EXPECT_TRUE(broadcaster->isStopped());
 }
 
+TEST_F(TTBroadcasterDiscoveryTest, HappyPathReceiveBeaconRequestNewNeighbor) {
+    SetHostEntryAndCall("Gabrielle", "6e6e6e6", "192.168.1.74");
+    const TTBeaconRequest request("John", "5e5fe55f", std::string{"192.168.1.75:"} + mNetworkInterface.getPort());
+    SetNeighborCall(request.nickname, request.identity, request.ipAddressAndPort);
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
+    EXPECT_TRUE(broadcaster->handleBeacon(request));
+    EXPECT_FALSE(broadcaster->isStopped());
+    broadcaster->stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds{100});
+    EXPECT_TRUE(broadcaster->isStopped());
+}
+
+TEST_F(TTBroadcasterDiscoveryTest, HappyPathReceiveBeaconRequestItself) {
+    SetHostEntryAndCall("Gabrielle", "6e6e6e6", "192.168.1.74");
+    const TTBeaconRequest request(mHostEntry->nickname, mHostEntry->identity, mHostEntry->ipAddressAndPort);
+    EXPECT_CALL(*mContactsHandler, create(_, _, _))
+        .Times(0);
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
+    EXPECT_TRUE(broadcaster->handleBeacon(request));
+    EXPECT_FALSE(broadcaster->isStopped());
+    broadcaster->stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds{100});
+    EXPECT_TRUE(broadcaster->isStopped());
+}
+
 TEST_F(TTBroadcasterDiscoveryTest, UnhappyPathReceiveGreetRequestNewNeighborNoNickname) {
     const TTGreetRequest request("", "5e5fe55f", std::string{"192.168.1.74:"} + mNetworkInterface.getPort());
-    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mNetworkInterface, mNeighbors);
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
     EXPECT_FALSE(broadcaster->handleGreet(request));
     EXPECT_FALSE(broadcaster->isStopped());
     broadcaster->stop();
@@ -192,7 +253,7 @@ TEST_F(TTBroadcasterDiscoveryTest, UnhappyPathReceiveGreetRequestNewNeighborNoNi
 
 TEST_F(TTBroadcasterDiscoveryTest, UnhappyPathReceiveGreetRequestNewNeighborNoIdentity) {
     const TTGreetRequest request("John", "", std::string{"192.168.1.74:"} + mNetworkInterface.getPort());
-    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mNetworkInterface, mNeighbors);
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
     EXPECT_FALSE(broadcaster->handleGreet(request));
     EXPECT_FALSE(broadcaster->isStopped());
     broadcaster->stop();
@@ -202,7 +263,7 @@ TEST_F(TTBroadcasterDiscoveryTest, UnhappyPathReceiveGreetRequestNewNeighborNoId
 
 TEST_F(TTBroadcasterDiscoveryTest, UnhappyPathReceiveGreetRequestNewNeighborNoIpAddressAndPort) {
     const TTGreetRequest request("John", "5e5fe55f", "");
-    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mNetworkInterface, mNeighbors);
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
     EXPECT_FALSE(broadcaster->handleGreet(request));
     EXPECT_FALSE(broadcaster->isStopped());
     broadcaster->stop();
@@ -222,7 +283,7 @@ TEST_F(TTBroadcasterDiscoveryTest, UnhappyPathReceiveGreetRequestNewNeighborCont
             .Times(1)
             .WillOnce(Return(false));
     }
-    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mNetworkInterface, mNeighbors);
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
     EXPECT_FALSE(broadcaster->handleGreet(request));
     EXPECT_FALSE(broadcaster->isStopped());
     broadcaster->stop();
@@ -245,7 +306,7 @@ TEST_F(TTBroadcasterDiscoveryTest, UnhappyPathReceiveGreetRequestNewNeighborCont
             .Times(1)
             .WillOnce(Return(std::nullopt));
     }
-    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mNetworkInterface, mNeighbors);
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
     EXPECT_FALSE(broadcaster->handleGreet(request));
     std::this_thread::sleep_for(std::chrono::milliseconds{100});
     EXPECT_TRUE(broadcaster->isStopped());
@@ -269,7 +330,7 @@ TEST_F(TTBroadcasterDiscoveryTest, UnhappyPathReceiveGreetRequestNewNeighborChat
             .Times(1)
             .WillOnce(Return(false));
     }
-    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mNetworkInterface, mNeighbors);
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
     EXPECT_FALSE(broadcaster->handleGreet(request));
     std::this_thread::sleep_for(std::chrono::milliseconds{100});
     EXPECT_TRUE(broadcaster->isStopped());
@@ -287,7 +348,7 @@ TEST_F(TTBroadcasterDiscoveryTest, UnhappyPathReceiveGreetRequestExistingNeighbo
             .Times(1)
             .WillOnce(Return(false));
     }
-    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mNetworkInterface, mNeighbors);
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
     EXPECT_FALSE(broadcaster->handleGreet(request));
     std::this_thread::sleep_for(std::chrono::milliseconds{100});
     EXPECT_TRUE(broadcaster->isStopped());
@@ -305,7 +366,43 @@ TEST_F(TTBroadcasterDiscoveryTest, HappyPathReceiveHeartbeatRequestExistingNeigh
             .Times(1)
             .WillOnce(Return(true));
     }
-    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mNetworkInterface, mNeighbors);
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
+    EXPECT_TRUE(broadcaster->handleHeartbeat(request));
+    EXPECT_FALSE(broadcaster->isStopped());
+    broadcaster->stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds{100});
+    EXPECT_TRUE(broadcaster->isStopped());
+}
+
+TEST_F(TTBroadcasterDiscoveryTest, HappyPathReceiveHeartbeatRequestGossipAndIndirectProbe) {
+    SetHostEntryAndCall("Gabrielle", "6e6e6e6", "192.168.1.74");
+    const TTGreetRequest target("John", "aaaaaaa", std::string{"192.168.1.75:"} + mNetworkInterface.getPort());
+    const size_t targetId = mNeighborIdentityCounter;
+    SetNeighborCall(target.nickname, target.identity, target.ipAddressAndPort);
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
+    EXPECT_TRUE(broadcaster->handleGreet(target));
+    // Sender gossips that target failed and asks to probe it
+    const TTHeartbeatRequest request("5e5fe55f", {TTMemberUpdate(target.identity, 0, false)}, target.identity);
+    const size_t senderId = 7;
+    EXPECT_CALL(*mContactsHandler, get(request.identity))
+        .Times(1)
+        .WillOnce(Return(std::optional<size_t>(senderId)));
+    EXPECT_CALL(*mContactsHandler, activate(senderId))
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mContactsHandler, deactivate(targetId))
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mContactsHandler, get(target.identity))
+        .Times(1)
+        .WillOnce(Return(std::optional<size_t>(targetId)));
+    EXPECT_CALL(*mContactsHandler, snapshot())
+        .Times(1)
+        .WillOnce(Return(TTContactsHandlerMock::makeSnapshot({{targetId, TTContactsHandlerEntry(target.nickname, target.identity, target.ipAddressAndPort)}})));
+    SetNeighborCreateDiscoveryStub(target.ipAddressAndPort);
+    EXPECT_CALL(*mNeighborsStub, sendHeartbeats(_, Field(&TTHeartbeatRequest::target, "")))
+        .Times(1)
+        .WillOnce(Return(std::vector<TTHeartbeatResponse>{TTHeartbeatResponse(true, target.identity)}));
     EXPECT_TRUE(broadcaster->handleHeartbeat(request));
     EXPECT_FALSE(broadcaster->isStopped());
     broadcaster->stop();
@@ -318,7 +415,7 @@ TEST_F(TTBroadcasterDiscoveryTest, UnhappyPathReceiveHeartbeatRequestNonExisting
     EXPECT_CALL(*mContactsHandler, get(request.identity))
         .Times(1)
         .WillOnce(Return(std::nullopt));
-    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mNetworkInterface, mNeighbors);
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
     EXPECT_FALSE(broadcaster->handleHeartbeat(request));
     EXPECT_FALSE(broadcaster->isStopped());
     broadcaster->stop();
@@ -338,7 +435,7 @@ TEST_F(TTBroadcasterDiscoveryTest, UnhappyPathReceiveHeartbeatRequestExistingNei
             .Times(1)
             .WillOnce(Return(false));
     }
-    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mNetworkInterface, mNeighbors);
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
     EXPECT_FALSE(broadcaster->handleHeartbeat(request));
     std::this_thread::sleep_for(std::chrono::milliseconds{100});
     EXPECT_TRUE(broadcaster->isStopped());
@@ -346,7 +443,7 @@ TEST_F(TTBroadcasterDiscoveryTest, UnhappyPathReceiveHeartbeatRequestExistingNei
 
 TEST_F(TTBroadcasterDiscoveryTest, HappyPathGetNickname) {
     SetHostEntryAndCall("Gabrielle", "6e6e6e6", "192.168.1.74");
-    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mNetworkInterface, mNeighbors);
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
     EXPECT_EQ(broadcaster->getNickname(), mHostEntry->nickname);
     EXPECT_FALSE(broadcaster->isStopped());
     broadcaster->stop();
@@ -358,7 +455,7 @@ TEST_F(TTBroadcasterDiscoveryTest, UnhappyPathGetNickname) {
     EXPECT_CALL(*mContactsHandler, get(Matcher<size_t>(size_t(0))))
         .Times(1)
         .WillOnce(Return(std::nullopt));
-    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mNetworkInterface, mNeighbors);
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
     EXPECT_EQ(broadcaster->getNickname(), "");
     std::this_thread::sleep_for(std::chrono::milliseconds{100});
     EXPECT_TRUE(broadcaster->isStopped());
@@ -366,7 +463,7 @@ TEST_F(TTBroadcasterDiscoveryTest, UnhappyPathGetNickname) {
 
 TEST_F(TTBroadcasterDiscoveryTest, HappyPathGetIdentity) {
     SetHostEntryAndCall("Gabrielle", "6e6e6e6", "192.168.1.74");
-    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mNetworkInterface, mNeighbors);
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
     EXPECT_EQ(broadcaster->getIdentity(), mHostEntry->identity);
     EXPECT_FALSE(broadcaster->isStopped());
     broadcaster->stop();
@@ -378,7 +475,7 @@ TEST_F(TTBroadcasterDiscoveryTest, UnhappyPathGetIdentity) {
     EXPECT_CALL(*mContactsHandler, get(Matcher<size_t>(size_t(0))))
         .Times(1)
         .WillOnce(Return(std::nullopt));
-    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mNetworkInterface, mNeighbors);
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
     EXPECT_EQ(broadcaster->getIdentity(), "");
     std::this_thread::sleep_for(std::chrono::milliseconds{100});
     EXPECT_TRUE(broadcaster->isStopped());
@@ -386,7 +483,7 @@ TEST_F(TTBroadcasterDiscoveryTest, UnhappyPathGetIdentity) {
 
 TEST_F(TTBroadcasterDiscoveryTest, HappyPathGetIpAddressAndPort) {
     SetHostEntryAndCall("Gabrielle", "6e6e6e6", "192.168.1.74");
-    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mNetworkInterface, mNeighbors);
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
     EXPECT_EQ(broadcaster->getIpAddressAndPort(), mHostEntry->ipAddressAndPort);
     EXPECT_FALSE(broadcaster->isStopped());
     broadcaster->stop();
@@ -398,7 +495,7 @@ TEST_F(TTBroadcasterDiscoveryTest, UnhappyPathGetIpAddressAndPort) {
     EXPECT_CALL(*mContactsHandler, get(Matcher<size_t>(size_t(0))))
         .Times(1)
         .WillOnce(Return(std::nullopt));
-    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mNetworkInterface, mNeighbors);
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
     EXPECT_EQ(broadcaster->getIpAddressAndPort(), "");
     std::this_thread::sleep_for(std::chrono::milliseconds{100});
     EXPECT_TRUE(broadcaster->isStopped());
@@ -419,7 +516,7 @@ TEST_F(TTBroadcasterDiscoveryTest, HappyPathStaticNeighborsResolvedThenEachIsAct
     for (const auto &[ipAddressAndPort, entry] : mNeighborEntries) {
         mNeighbors.push_back(entry.ipAddress);
     }
-    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mNetworkInterface, mNeighbors);
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
     // Start async consumer
     std::thread loop(std::bind(&TTBroadcasterDiscovery::run, broadcaster.get()));
     // Expect consumer to react
@@ -431,6 +528,10 @@ TEST_F(TTBroadcasterDiscoveryTest, HappyPathStaticNeighborsResolvedThenEachIsAct
         EXPECT_EQ(stats.sendGreetCounter, 1);
         EXPECT_GE(stats.sendHeartbeatCounter, 1);
     }
+    // All static neighbors are greeted at once
+    EXPECT_EQ(mSendGreetsCounter, 1);
+    // Although all of them are due at the same time, one member is probed per protocol period
+    EXPECT_EQ(mMaxDirectProbes, 1);
 }
 
 TEST_F(TTBroadcasterDiscoveryTest, HappyPathStaticNeighborsResolvedThenEachIsInactive) {
@@ -448,7 +549,7 @@ TEST_F(TTBroadcasterDiscoveryTest, HappyPathStaticNeighborsResolvedThenEachIsIna
     for (const auto &[ipAddressAndPort, entry] : mNeighborEntries) {
         mNeighbors.push_back(entry.ipAddress);
     }
-    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mNetworkInterface, mNeighbors);
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
     // Start async consumer
     std::thread loop(std::bind(&TTBroadcasterDiscovery::run, broadcaster.get()));
     // Expect consumer to react
@@ -480,7 +581,7 @@ TEST_F(TTBroadcasterDiscoveryTest, HappyPathStaticNeighborsResolvedThenEachIsFla
     for (const auto &[ipAddressAndPort, entry] : mNeighborEntries) {
         mNeighbors.push_back(entry.ipAddress);
     }
-    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mNetworkInterface, mNeighbors);
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
     // Start async consumer
     std::thread loop(std::bind(&TTBroadcasterDiscovery::run, broadcaster.get()));
     // Expect consumer to react
@@ -503,7 +604,7 @@ TEST_F(TTBroadcasterDiscoveryTest, HappyPathStaticNeighborsUnresolvedStubCreatio
     mNeighbors.push_back("168.0.55.1");
     mNeighbors.push_back("145.111.55.8");
     mNeighbors.push_back("157.88.64.7");
-    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mNetworkInterface, mNeighbors);
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
     // Start async consumer
     std::thread loop(std::bind(&TTBroadcasterDiscovery::run, broadcaster.get()));
     // Expect consumer to react
@@ -517,6 +618,23 @@ TEST_F(TTBroadcasterDiscoveryTest, HappyPathStaticNeighborsUnresolvedStubCreatio
     }
 }
 
+TEST_F(TTBroadcasterDiscoveryTest, HappyPathStaticNeighborsUnresolvedStopWakesResolversUp) {
+    EXPECT_CALL(*mNeighborsStub, createDiscoveryStub(_))
+        .Times(AtLeast(1))
+        .WillRepeatedly([&](){return std::unique_ptr<TTNeighborsDiscoveryStubMock>(nullptr);});
+    // Create broadcaster
+    mNeighbors.push_back("122.124.0.9");
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
+    // Start async consumer
+    std::thread loop(std::bind(&TTBroadcasterDiscovery::run, broadcaster.get()));
+    std::this_thread::sleep_for(std::chrono::milliseconds{200});
+    // Resolvers wait for the next attempt, they do not spin or sleep through the stop
+    const auto start = std::chrono::steady_clock::now();
+    broadcaster->stop();
+    loop.join();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds{500});
+}
+
 TEST_F(TTBroadcasterDiscoveryTest, HappyPathStaticNeighborsUnresolvedGreetSendFailed) {
     const std::deque<bool> greets = {false, false, false};
     SetNeighborEntry("Oak", "14eeffe", "122.124.0.9", greets, {});
@@ -533,7 +651,7 @@ TEST_F(TTBroadcasterDiscoveryTest, HappyPathStaticNeighborsUnresolvedGreetSendFa
     for (const auto &[ipAddressAndPort, entry] : mNeighborEntries) {
         mNeighbors.push_back(entry.ipAddress);
     }
-    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mNetworkInterface, mNeighbors);
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
     // Start async consumer
     std::thread loop(std::bind(&TTBroadcasterDiscovery::run, broadcaster.get()));
     // Expect consumer to react
@@ -559,7 +677,7 @@ TEST_F(TTBroadcasterDiscoveryTest, HappyPathStaticNeighborIsResolvedThenContacts
     for (const auto &[ipAddressAndPort, entry] : mNeighborEntries) {
         mNeighbors.push_back(entry.ipAddress);
     }
-    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mNetworkInterface, mNeighbors);
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
     // Start async consumer
     std::thread loop(std::bind(&TTBroadcasterDiscovery::run, broadcaster.get()));
     // Expect consumer to react
@@ -586,7 +704,7 @@ TEST_F(TTBroadcasterDiscoveryTest, HappyPathStaticNeighborIsResolvedThenContacts
     for (const auto &[ipAddressAndPort, entry] : mNeighborEntries) {
         mNeighbors.push_back(entry.ipAddress);
     }
-    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mNetworkInterface, mNeighbors);
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
     // Start async consumer
     std::thread loop(std::bind(&TTBroadcasterDiscovery::run, broadcaster.get()));
     // Expect consumer to react
@@ -600,3 +718,242 @@ TEST_F(TTBroadcasterDiscoveryTest, HappyPathStaticNeighborIsResolvedThenContacts
         EXPECT_GE(stats.sendHeartbeatCounter, 1);
     }
 }
+
+TEST_F(TTBroadcasterDiscoveryTest, HappyPathSubnetSweptListeningNeighborGreeted) {
+    // Only 127.0.0.1 listens on the port, 127.0.0.2 refuses connection and is not greeted
+    const int listener = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(listener, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+    ASSERT_EQ(bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+    ASSERT_EQ(listen(listener, 16), 0);
+    socklen_t length = sizeof(address);
+    ASSERT_EQ(getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length), 0);
+    const auto port = std::to_string(ntohs(address.sin_port));
+    const auto ipAddressAndPort = "127.0.0.1:" + port;
+    const TTNetworkInterface networkInterface("lo", "192.168.1.74", port);
+    SetHostEntryAndCall("Gabrielle", "6e6e6e6", "192.168.1.74");
+    SetNeighborCreateDiscoveryStub(ipAddressAndPort);
+    SetNeighborCall("Oak", "14eeffe", ipAddressAndPort);
+    EXPECT_CALL(*mNeighborsStub, sendGreets(_, _))
+        .Times(1)
+        .WillOnce([&](const auto& stubs, const auto&) {
+            EXPECT_EQ(stubs.size(), 1);
+            return std::vector<TTGreetResponse>{TTGreetResponse(true, "Oak", "14eeffe", ipAddressAndPort)};
+        });
+    EXPECT_CALL(*mNeighborsStub, sendHeartbeats(_, _))
+        .Times(AnyNumber())
+        .WillRepeatedly(Return(std::vector<TTHeartbeatResponse>{TTHeartbeatResponse(true, "14eeffe")}));
+    EXPECT_CALL(*mContactsHandler, activate(_))
+        .Times(AnyNumber())
+        .WillRepeatedly(Return(true));
+    mNeighbors.push_back("127.0.0.0/30");
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, networkInterface, mNeighbors);
+    std::thread loop(std::bind(&TTBroadcasterDiscovery::run, broadcaster.get()));
+    std::this_thread::sleep_for(std::chrono::milliseconds{1500});
+    EXPECT_FALSE(broadcaster->isStopped());
+    broadcaster->stop();
+    loop.join();
+    close(listener);
+}
+
+TEST_F(TTBroadcasterDiscoveryTest, HappyPathCachedNeighborsGreetedFirstMostRecentlySeenFirst) {
+    const auto cachePath = std::filesystem::temp_directory_path() / "tteams-unittests" / "discovery-neighbors";
+    std::filesystem::remove(cachePath);
+    {
+        TTNeighborsCache cache(cachePath);
+        cache.store("Oak", "14eeffe", "122.124.0.9:1777");
+        cache.store("Johny", "123456", "168.0.55.1:1777");
+        // Host itself is never greeted
+        cache.store("Gabrielle", "6e6e6e6", "192.168.1.1:1777");
+    }
+    SetHostEntryAndCall("Gabrielle", "6e6e6e6", "192.168.1.1");
+    SetNeighborEntryAndCall("Oak", "14eeffe", "122.124.0.9", {true}, {true});
+    SetNeighborEntryAndCall("Johny", "123456", "168.0.55.1", {true}, {true});
+    SetNeighborEntryAndCall("Camille", "ddddddd", "145.111.55.8", {true}, {true});
+    SetNeighborsGreetCalls();
+    SetNeighborsHeartbeatCalls();
+    EXPECT_CALL(*mContactsHandler, activate(_))
+        .Times(AnyNumber())
+        .WillRepeatedly(Return(true));
+    // Cached static neighbor is greeted once
+    mNeighbors.push_back("122.124.0.9");
+    mNeighbors.push_back("145.111.55.8");
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors, cachePath);
+    std::thread loop(std::bind(&TTBroadcasterDiscovery::run, broadcaster.get()));
+    // First probe follows one min interval after greet
+    std::this_thread::sleep_for(std::chrono::milliseconds{1500});
+    broadcaster->stop();
+    loop.join();
+    EXPECT_EQ(mGreeted, (std::vector<std::string>{"168.0.55.1:1777", "122.124.0.9:1777", "145.111.55.8:1777"}));
+    broadcaster.reset();
+    // Neighbor found by other means is cached as well
+    EXPECT_EQ(TTNeighborsCache(cachePath).size(), 4);
+    std::filesystem::remove(cachePath);
+}
+
+TEST_F(TTBroadcasterDiscoveryTest, HappyPathDynamicNeighborHealthyProbedLessOftenFailureSuspected) {
+    SetHostEntryAndCall("Gabrielle", "6e6e6e6", "192.168.1.74");
+    SetNeighborEntryAndCall("Oak", "14eeffe", "122.124.0.9", {true}, {true, true, false});
+    SetNeighborsGreetCalls();
+    SetNeighborsHeartbeatCalls();
+    EXPECT_CALL(*mContactsHandler, activate(_))
+        .Times(AtLeast(1))
+        .WillRepeatedly(Return(true));
+    std::chrono::steady_clock::time_point deactivated;
+    // Member is deactivated once, although it keeps failing probes
+    EXPECT_CALL(*mContactsHandler, deactivate(_))
+        .Times(1)
+        .WillOnce([&]() {
+            deactivated = std::chrono::steady_clock::now();
+            return true;
+        });
+    mNeighbors.push_back("122.124.0.9");
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
+    const auto start = std::chrono::steady_clock::now();
+    std::thread loop(std::bind(&TTBroadcasterDiscovery::run, broadcaster.get()));
+    std::this_thread::sleep_for(std::chrono::milliseconds{10000});
+    broadcaster->stop();
+    loop.join();
+    // Probed after 1s, 2s and 4s intervals, then failure is retried after 1s
+    const auto& stats = mNeighborEntries.at("122.124.0.9:1777");
+    EXPECT_GE(stats.sendHeartbeatCounter, 4);
+    EXPECT_LE(stats.sendHeartbeatCounter, 6);
+    // Heartbeat expected 7s after start, suspicion follows shortly after the missed one
+    EXPECT_GT(deactivated - start, std::chrono::milliseconds{7000});
+    EXPECT_LT(deactivated - start, std::chrono::milliseconds{9000});
+}
+
+TEST_F(TTBroadcasterDiscoveryTest, HappyPathDynamicNeighborChattingIsNotProbed) {
+    SetHostEntryAndCall("Gabrielle", "6e6e6e6", "192.168.1.74");
+    SetNeighborEntryAndCall("Oak", "14eeffe", "122.124.0.9", {true}, {false});
+    SetNeighborsGreetCalls();
+    // Chat traffic proves liveness, so no heartbeat is sent and member is never suspected
+    EXPECT_CALL(*mNeighborsStub, sendHeartbeats(_, _))
+        .Times(0);
+    EXPECT_CALL(*mContactsHandler, activate(_))
+        .Times(AnyNumber())
+        .WillRepeatedly(Return(true));
+    EXPECT_CALL(*mContactsHandler, deactivate(_))
+        .Times(0);
+    mNeighbors.push_back("122.124.0.9");
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
+    std::thread loop(std::bind(&TTBroadcasterDiscovery::run, broadcaster.get()));
+    const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds{6000};
+    while (std::chrono::steady_clock::now() < end) {
+        mLiveness.contact(100);
+        std::this_thread::sleep_for(std::chrono::milliseconds{300});
+    }
+    broadcaster->stop();
+    loop.join();
+    EXPECT_EQ(mNeighborEntries.at("122.124.0.9:1777").sendHeartbeatCounter, 0);
+}
+
+TEST_F(TTBroadcasterDiscoveryTest, HappyPathDynamicNeighborPingedOverUdpWithoutGossip) {
+    SetHostEntryAndCall("Gabrielle", "6e6e6e6", "192.168.1.74");
+    SetNeighborEntryAndCall("Oak", "14eeffe", "127.0.0.2", {true}, {true});
+    SetNeighborsGreetCalls();
+    SetNeighborsHeartbeatCalls();
+    EXPECT_CALL(*mContactsHandler, activate(_))
+        .Times(AnyNumber())
+        .WillRepeatedly(Return(true));
+    EXPECT_CALL(*mContactsHandler, deactivate(_))
+        .Times(0);
+    // Neighbor answers pings on its own loopback address
+    const uint16_t heartbeatPort = 47822;
+    TTNeighborsLiveness neighborLiveness;
+    TTNeighborsPulse neighbor("127.0.0.2", heartbeatPort, "14eeffe", neighborLiveness);
+    std::thread neighborLoop(&TTNeighborsPulse::run, &neighbor);
+    TTNeighborsDetectorSettings detectorSettings;
+    detectorSettings.minInterval = std::chrono::milliseconds{100};
+    detectorSettings.maxInterval = std::chrono::milliseconds{200};
+    const TTNetworkInterface networkInterface("lo", "127.0.0.1", mNetworkInterface.getPort());
+    mNeighbors.push_back("127.0.0.2");
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, networkInterface, mNeighbors, "", detectorSettings, heartbeatPort);
+    std::thread loop(std::bind(&TTBroadcasterDiscovery::run, broadcaster.get()));
+    std::this_thread::sleep_for(std::chrono::milliseconds{2500});
+    const auto& stats = mNeighborEntries.at("127.0.0.2:1777");
+    const auto gossiped = stats.sendHeartbeatCounter;
+    std::this_thread::sleep_for(std::chrono::milliseconds{2000});
+    broadcaster->stop();
+    loop.join();
+    neighbor.stop();
+    neighborLoop.join();
+    // Gossip about the new member is piggybacked on gRPC heartbeats, afterwards the member is only pinged
+    EXPECT_GE(gossiped, 1);
+    EXPECT_EQ(stats.sendHeartbeatCounter, gossiped);
+}
+
+TEST_F(TTBroadcasterDiscoveryTest, HappyPathDynamicNeighborSlowProbeDoesNotBlockOthers) {
+    SetHostEntryAndCall("Gabrielle", "6e6e6e6", "192.168.1.74");
+    SetNeighborEntryAndCall("Oak", "14eeffe", "122.124.0.9", {true}, {true});
+    SetNeighborEntryAndCall("Johny", "123456", "168.0.55.1", {true}, {true});
+    SetNeighborsGreetCalls();
+    std::mutex mutex;
+    size_t inFlight = 0;
+    size_t maxInFlight = 0;
+    // Each member answers only after a while
+    EXPECT_CALL(*mNeighborsStub, sendHeartbeats(_, _))
+        .Times(AtLeast(2))
+        .WillRepeatedly([&](const auto& stubs, const auto&) {
+            {
+                std::scoped_lock lock(mutex);
+                maxInFlight = std::max(maxInFlight, ++inFlight);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds{1000});
+            std::vector<TTHeartbeatResponse> responses;
+            for (auto& stub : stubs) {
+                const auto requestIpAddressAndPort = reinterpret_cast<TTNeighborsDiscoveryStubMock&>(stub.get()).ipAddressAndPort;
+                responses.emplace_back(true, mNeighborEntries.at(requestIpAddressAndPort).identity);
+            }
+            std::scoped_lock lock(mutex);
+            --inFlight;
+            return responses;
+        });
+    EXPECT_CALL(*mContactsHandler, activate(_))
+        .Times(AnyNumber())
+        .WillRepeatedly(Return(true));
+    EXPECT_CALL(*mContactsHandler, deactivate(_))
+        .Times(0);
+    mNeighbors.push_back("122.124.0.9");
+    mNeighbors.push_back("168.0.55.1");
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
+    std::thread loop(std::bind(&TTBroadcasterDiscovery::run, broadcaster.get()));
+    std::this_thread::sleep_for(std::chrono::milliseconds{2500});
+    broadcaster->stop();
+    loop.join();
+    // Both members become due at once, the second one is probed in the next period, not after the first one answers
+    EXPECT_EQ(maxInFlight, 2);
+}
+
+TEST_F(TTBroadcasterDiscoveryTest, HappyPathPeersLearnedFromGreetReplyAreGreeted) {
+    SetHostEntryAndCall("Gabrielle", "6e6e6e6", "192.168.1.74");
+    SetNeighborEntryAndCall("Oak", "14eeffe", "122.124.0.9", {true}, {true});
+    // Peer is known only to the static neighbor, host itself is not greeted
+    SetNeighborEntry("Elm", "5e5fe55f", "122.124.0.10", {true}, {true});
+    {
+        InSequence __;
+        EXPECT_CALL(*mContactsHandler, get("5e5fe55f"))
+            .Times(1)
+            .WillOnce(Return(std::nullopt));
+        SetNeighborCreateDiscoveryStub("122.124.0.10:1777");
+        SetNeighborCall("Elm", "5e5fe55f", "122.124.0.10:1777");
+    }
+    mNeighborEntries.at("122.124.0.9:1777").peers = {
+        {"Elm", "5e5fe55f", "122.124.0.10:1777"},
+        {"Gabrielle", "6e6e6e6", mNetworkInterface.getIpAddressAndPort()}
+    };
+    SetNeighborsGreetCalls();
+    SetNeighborsHeartbeatCalls();
+    EXPECT_CALL(*mContactsHandler, activate(_))
+        .Times(AnyNumber())
+        .WillRepeatedly(Return(true));
+    mNeighbors.push_back("122.124.0.9");
+    auto broadcaster = std::make_unique<TTBroadcasterDiscovery>(*mContactsHandler, *mChatHandler, *mNeighborsStub, mLiveness, mNetworkInterface, mNeighbors);
+    std::thread loop(std::bind(&TTBroadcasterDiscovery::run, broadcaster.get()));
+    std::this_thread::sleep_for(std::chrono::milliseconds{1500});
+    broadcaster->stop();
+    loop.join();
+    EXPECT_EQ(mGreeted, (std::vector<std::string>{"122.124.0.9:1777", "122.124.0.10:1777"}));
+}
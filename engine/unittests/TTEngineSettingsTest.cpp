@@ -73,6 +73,49 @@ TEST(TTEngineSettingsTest, HappyPathFewNeighbors) {
     EXPECT_EQ(settings.getNeighbors()[2], neighbor3IpAddress);
 }
 
+TEST(TTEngineSettingsTest, HappyPathNeighborsAndSubnets) {
+    const int argc = 12;
+    const char* const argv[12] = {
+        "/tmp",
+        "contacts",
+        "chat",
+        "textbox",
+        "nickname",
+        "identity",
+        "eno1",
+        "192.168.1.15",
+        "158",
+        "192.168.1.85",
+        "10.0.0.0/22",
+        "172.16.4.1/32"
+    };
+    const TTEngineSettings settings(argc, argv);
+    ASSERT_EQ(settings.getNeighbors().size(), 3);
+    EXPECT_EQ(settings.getNeighbors()[0], "192.168.1.85");
+    EXPECT_EQ(settings.getNeighbors()[1], "10.0.0.0/22");
+    EXPECT_EQ(settings.getNeighbors()[2], "172.16.4.1/32");
+}
+
+TEST(TTEngineSettingsTest, UnhappyPathInvalidSubnet) {
+    for (const auto& subnet : {"10.0.0.0/8", "10.0.0.0/33", "10.0.0.0/", "10.0.0/24", "10.0.0.0/2x"}) {
+        const int argc = 10;
+        const char* const argv[10] = {
+            "/tmp",
+            "contacts",
+            "chat",
+            "textbox",
+            "nickname",
+            "identity",
+            "eno1",
+            "192.168.1.15",
+            "158",
+            subnet
+        };
+        EXPECT_THAT([&]() {TTEngineSettings(argc, argv);},
+            ThrowsMessage<std::runtime_error>(HasSubstr(std::string("TTEngineSettings: Invalid neighbor subnet=") + subnet)));
+    }
+}
+
 TEST(TTEngineSettingsTest, UnhappyPathNotEnoughArguments) {
     const int argc = 1;
     const char* const argv[1] = { "a" };
@@ -221,3 +264,301 @@ TEST(TTEngineSettingsTest, UnhappyPathInvalidHostPortNoNeighbors2) {
     EXPECT_THAT([&]() {TTEngineSettings(argc, argv);},
         ThrowsMessage<std::runtime_error>(HasSubstr("TTEngineSettings: Invalid (out of range) port=")));
 }
+
+TEST(TTEngineSettingsTest, HappyPathServerThreads) {
+    const int argc = 9;
+    const char* const argv[9] = {
+        "/tmp",
+        "contacts",
+        "chat",
+        "textbox",
+        "nickname",
+        "identity",
+        "eno1",
+        "192.168.1.15",
+        "158"
+    };
+    unsetenv("TT_SERVER_THREADS");
+    EXPECT_EQ(TTEngineSettings(argc, argv).getServerThreads(), 2);
+    setenv("TT_SERVER_THREADS", "8", 1);
+    EXPECT_EQ(TTEngineSettings(argc, argv).getServerThreads(), 8);
+    setenv("TT_SERVER_THREADS", "0", 1);
+    EXPECT_EQ(TTEngineSettings(argc, argv).getServerThreads(), 0);
+    unsetenv("TT_SERVER_THREADS");
+}
+
+TEST(TTEngineSettingsTest, UnhappyPathInvalidServerThreads) {
+    const int argc = 9;
+    const char* const argv[9] = {
+        "/tmp",
+        "contacts",
+        "chat",
+        "textbox",
+        "nickname",
+        "identity",
+        "eno1",
+        "192.168.1.15",
+        "158"
+    };
+    setenv("TT_SERVER_THREADS", "blahblah", 1);
+    EXPECT_THAT([&]() {TTEngineSettings(argc, argv);},
+        ThrowsMessage<std::runtime_error>(HasSubstr("TTEngineSettings: Invalid number of server threads=blahblah")));
+    setenv("TT_SERVER_THREADS", "65", 1);
+    EXPECT_THAT([&]() {TTEngineSettings(argc, argv);},
+        ThrowsMessage<std::runtime_error>(HasSubstr("TTEngineSettings: Invalid (out of range) number of server threads=65")));
+    unsetenv("TT_SERVER_THREADS");
+}
+
+TEST(TTEngineSettingsTest, HappyPathBeaconAddress) {
+    const int argc = 9;
+    const char* const argv[9] = {
+        "/tmp",
+        "contacts",
+        "chat",
+        "textbox",
+        "nickname",
+        "identity",
+        "eno1",
+        "192.168.1.15",
+        "158"
+    };
+    unsetenv("TT_BEACON_ADDRESS");
+    EXPECT_TRUE(TTEngineSettings(argc, argv).getBeaconAddress().empty());
+    setenv("TT_BEACON_ADDRESS", "239.255.77.77", 1);
+    EXPECT_EQ(TTEngineSettings(argc, argv).getBeaconAddress(), "239.255.77.77");
+    setenv("TT_BEACON_ADDRESS", "blahblah", 1);
+    EXPECT_THAT([&]() {TTEngineSettings(argc, argv);},
+        ThrowsMessage<std::runtime_error>(HasSubstr("TTEngineSettings: Invalid beacon IPv4 address=blahblah")));
+    unsetenv("TT_BEACON_ADDRESS");
+}
+
+TEST(TTEngineSettingsTest, HappyPathDetectorSettings) {
+    const int argc = 9;
+    const char* const argv[9] = {
+        "/tmp",
+        "contacts",
+        "chat",
+        "textbox",
+        "nickname",
+        "identity",
+        "eno1",
+        "192.168.1.15",
+        "158"
+    };
+    unsetenv("TT_PHI_THRESHOLD");
+    unsetenv("TT_HEARTBEAT_MIN_INTERVAL");
+    unsetenv("TT_HEARTBEAT_MAX_INTERVAL");
+    {
+        const auto& detectorSettings = TTEngineSettings(argc, argv).getDetectorSettings();
+        EXPECT_EQ(detectorSettings.threshold, TTNeighborsDetectorSettings::DEFAULT_THRESHOLD);
+        EXPECT_EQ(detectorSettings.minInterval, TTNeighborsDetectorSettings::DEFAULT_MIN_INTERVAL);
+        EXPECT_EQ(detectorSettings.maxInterval, TTNeighborsDetectorSettings::DEFAULT_MAX_INTERVAL);
+    }
+    setenv("TT_PHI_THRESHOLD", "3.5", 1);
+    setenv("TT_HEARTBEAT_MIN_INTERVAL", "500", 1);
+    setenv("TT_HEARTBEAT_MAX_INTERVAL", "20000", 1);
+    {
+        TTEngineSettings settings(argc, argv);
+        const auto& detectorSettings = settings.getDetectorSettings();
+        EXPECT_EQ(detectorSettings.threshold, 3.5);
+        EXPECT_EQ(detectorSettings.minInterval, std::chrono::milliseconds(500));
+        EXPECT_EQ(detectorSettings.maxInterval, std::chrono::milliseconds(20000));
+    }
+    unsetenv("TT_PHI_THRESHOLD");
+    unsetenv("TT_HEARTBEAT_MIN_INTERVAL");
+    unsetenv("TT_HEARTBEAT_MAX_INTERVAL");
+}
+
+TEST(TTEngineSettingsTest, UnhappyPathInvalidDetectorSettings) {
+    const int argc = 9;
+    const char* const argv[9] = {
+        "/tmp",
+        "contacts",
+        "chat",
+        "textbox",
+        "nickname",
+        "identity",
+        "eno1",
+        "192.168.1.15",
+        "158"
+    };
+    setenv("TT_PHI_THRESHOLD", "high", 1);
+    EXPECT_THAT([&]() {TTEngineSettings(argc, argv);},
+        ThrowsMessage<std::runtime_error>(HasSubstr("TTEngineSettings: Invalid phi threshold=high")));
+    setenv("TT_PHI_THRESHOLD", "0", 1);
+    EXPECT_THAT([&]() {TTEngineSettings(argc, argv);},
+        ThrowsMessage<std::runtime_error>(HasSubstr("TTEngineSettings: Invalid (out of range) phi threshold=0")));
+    unsetenv("TT_PHI_THRESHOLD");
+    setenv("TT_HEARTBEAT_MIN_INTERVAL", "0", 1);
+    EXPECT_THAT([&]() {TTEngineSettings(argc, argv);},
+        ThrowsMessage<std::runtime_error>(HasSubstr("TTEngineSettings: Invalid (out of range) heartbeat min interval=0")));
+    setenv("TT_HEARTBEAT_MIN_INTERVAL", "9000", 1);
+    EXPECT_THAT([&]() {TTEngineSettings(argc, argv);},
+        ThrowsMessage<std::runtime_error>(HasSubstr("TTEngineSettings: Invalid heartbeat min interval greater than max interval")));
+    unsetenv("TT_HEARTBEAT_MIN_INTERVAL");
+    setenv("TT_HEARTBEAT_MAX_INTERVAL", "1s", 1);
+    EXPECT_THAT([&]() {TTEngineSettings(argc, argv);},
+        ThrowsMessage<std::runtime_error>(HasSubstr("TTEngineSettings: Invalid heartbeat max interval=1s")));
+    unsetenv("TT_HEARTBEAT_MAX_INTERVAL");
+}
+
+TEST(TTEngineSettingsTest, HappyPathHeartbeatPort) {
+    const int argc = 9;
+    const char* const argv[9] = {
+        "/tmp",
+        "contacts",
+        "chat",
+        "textbox",
+        "nickname",
+        "identity",
+        "eno1",
+        "192.168.1.15",
+        "158"
+    };
+    unsetenv("TT_HEARTBEAT_PORT");
+    EXPECT_EQ(TTEngineSettings(argc, argv).getHeartbeatPort(), 0);
+    setenv("TT_HEARTBEAT_PORT", "7778", 1);
+    EXPECT_EQ(TTEngineSettings(argc, argv).getHeartbeatPort(), 7778);
+    unsetenv("TT_HEARTBEAT_PORT");
+}
+
+TEST(TTEngineSettingsTest, UnhappyPathInvalidHeartbeatPort) {
+    const int argc = 9;
+    const char* const argv[9] = {
+        "/tmp",
+        "contacts",
+        "chat",
+        "textbox",
+        "nickname",
+        "identity",
+        "eno1",
+        "192.168.1.15",
+        "158"
+    };
+    setenv("TT_HEARTBEAT_PORT", "udp", 1);
+    EXPECT_THAT([&]() {TTEngineSettings(argc, argv);},
+        ThrowsMessage<std::runtime_error>(HasSubstr("TTEngineSettings: Invalid heartbeat port=udp")));
+    setenv("TT_HEARTBEAT_PORT", "65536", 1);
+    EXPECT_THAT([&]() {TTEngineSettings(argc, argv);},
+        ThrowsMessage<std::runtime_error>(HasSubstr("TTEngineSettings: Invalid heartbeat port=65536")));
+    setenv("TT_HEARTBEAT_PORT", "0", 1);
+    EXPECT_THAT([&]() {TTEngineSettings(argc, argv);},
+        ThrowsMessage<std::runtime_error>(HasSubstr("TTEngineSettings: Invalid heartbeat port=0")));
+    unsetenv("TT_HEARTBEAT_PORT");
+}
+
+TEST(TTEngineSettingsTest, HappyPathNeighborsCache) {
+    const int argc = 9;
+    const char* const argv[9] = {
+        "/tmp",
+        "contacts",
+        "chat",
+        "textbox",
+        "nickname",
+        "identity",
+        "eno1",
+        "192.168.1.15",
+        "158"
+    };
+    unsetenv("TT_NEIGHBORS_CACHE");
+    EXPECT_TRUE(TTEngineSettings(argc, argv).getNeighborsCache().empty());
+    setenv("TT_NEIGHBORS_CACHE", "/var/tmp/neighbors", 1);
+    EXPECT_EQ(TTEngineSettings(argc, argv).getNeighborsCache(), "/var/tmp/neighbors");
+    unsetenv("TT_NEIGHBORS_CACHE");
+}
+
+TEST(TTEngineSettingsTest, HappyPathChatLimits) {
+    const int argc = 9;
+    const char* const argv[9] = {
+        "/tmp",
+        "contacts",
+        "chat",
+        "textbox",
+        "nickname",
+        "identity",
+        "eno1",
+        "192.168.1.15",
+        "158"
+    };
+    unsetenv("TT_CHAT_NEIGHBOR_BYTES");
+    unsetenv("TT_CHAT_GLOBAL_BYTES");
+    unsetenv("TT_CHAT_OVERFLOW");
+    unsetenv("TT_CHAT_SPILL_DIRECTORY");
+    unsetenv("TT_CHAT_FLUSH_WINDOW");
+    unsetenv("TT_CHAT_IN_FLIGHT");
+    {
+        const auto& limits = TTEngineSettings(argc, argv).getChatLimits();
+        EXPECT_EQ(limits.neighborBytes, TTBroadcasterChatLimits::DEFAULT_NEIGHBOR_BYTES);
+        EXPECT_EQ(limits.globalBytes, TTBroadcasterChatLimits::DEFAULT_GLOBAL_BYTES);
+        EXPECT_EQ(limits.overflow, TTBroadcasterChatLimits::Overflow::DROP_OLDEST);
+        EXPECT_TRUE(limits.spillDirectory.empty());
+        EXPECT_EQ(limits.flushWindow, TTBroadcasterChatLimits::DEFAULT_FLUSH_WINDOW);
+        EXPECT_EQ(limits.inFlight, TTBroadcasterChatLimits::DEFAULT_IN_FLIGHT);
+    }
+    setenv("TT_CHAT_NEIGHBOR_BYTES", "4096", 1);
+    setenv("TT_CHAT_GLOBAL_BYTES", "65536", 1);
+    setenv("TT_CHAT_OVERFLOW", "spill", 1);
+    setenv("TT_CHAT_SPILL_DIRECTORY", "/var/tmp", 1);
+    setenv("TT_CHAT_FLUSH_WINDOW", "20", 1);
+    setenv("TT_CHAT_IN_FLIGHT", "8", 1);
+    {
+        TTEngineSettings settings(argc, argv);
+        const auto& limits = settings.getChatLimits();
+        EXPECT_EQ(limits.neighborBytes, 4096);
+        EXPECT_EQ(limits.globalBytes, 65536);
+        EXPECT_EQ(limits.overflow, TTBroadcasterChatLimits::Overflow::SPILL);
+        EXPECT_EQ(limits.spillDirectory, "/var/tmp");
+        EXPECT_EQ(limits.flushWindow, std::chrono::milliseconds(20));
+        EXPECT_EQ(limits.inFlight, 8);
+    }
+    unsetenv("TT_CHAT_NEIGHBOR_BYTES");
+    unsetenv("TT_CHAT_GLOBAL_BYTES");
+    unsetenv("TT_CHAT_OVERFLOW");
+    unsetenv("TT_CHAT_SPILL_DIRECTORY");
+    unsetenv("TT_CHAT_FLUSH_WINDOW");
+    unsetenv("TT_CHAT_IN_FLIGHT");
+}
+
+TEST(TTEngineSettingsTest, UnhappyPathInvalidChatLimits) {
+    const int argc = 9;
+    const char* const argv[9] = {
+        "/tmp",
+        "contacts",
+        "chat",
+        "textbox",
+        "nickname",
+        "identity",
+        "eno1",
+        "192.168.1.15",
+        "158"
+    };
+    setenv("TT_CHAT_NEIGHBOR_BYTES", "blahblah", 1);
+    EXPECT_THAT([&]() {TTEngineSettings(argc, argv);},
+        ThrowsMessage<std::runtime_error>(HasSubstr("TTEngineSettings: Invalid chat neighbor budget=blahblah")));
+    unsetenv("TT_CHAT_NEIGHBOR_BYTES");
+    setenv("TT_CHAT_GLOBAL_BYTES", "0", 1);
+    EXPECT_THAT([&]() {TTEngineSettings(argc, argv);},
+        ThrowsMessage<std::runtime_error>(HasSubstr("TTEngineSettings: Invalid chat global budget=0")));
+    unsetenv("TT_CHAT_GLOBAL_BYTES");
+    setenv("TT_CHAT_OVERFLOW", "blahblah", 1);
+    EXPECT_THAT([&]() {TTEngineSettings(argc, argv);},
+        ThrowsMessage<std::runtime_error>(HasSubstr("TTEngineSettings: Invalid chat overflow policy=blahblah")));
+    unsetenv("TT_CHAT_OVERFLOW");
+    setenv("TT_CHAT_FLUSH_WINDOW", "-5", 1);
+    EXPECT_THAT([&]() {TTEngineSettings(argc, argv);},
+        ThrowsMessage<std::runtime_error>(HasSubstr("TTEngineSettings: Invalid chat flush window=-5")));
+    setenv("TT_CHAT_FLUSH_WINDOW", "1001", 1);
+    EXPECT_THAT([&]() {TTEngineSettings(argc, argv);},
+        ThrowsMessage<std::runtime_error>(HasSubstr("TTEngineSettings: Invalid (out of range) chat flush window=1001")));
+    unsetenv("TT_CHAT_FLUSH_WINDOW");
+    setenv("TT_CHAT_IN_FLIGHT", "blahblah", 1);
+    EXPECT_THAT([&]() {TTEngineSettings(argc, argv);},
+        ThrowsMessage<std::runtime_error>(HasSubstr("TTEngineSettings: Invalid chat in-flight limit=blahblah")));
+    setenv("TT_CHAT_IN_FLIGHT", "0", 1);
+    EXPECT_THAT([&]() {TTEngineSettings(argc, argv);},
+        ThrowsMessage<std::runtime_error>(HasSubstr("TTEngineSettings: Invalid (out of range) chat in-flight limit=0")));
+    setenv("TT_CHAT_IN_FLIGHT", "65", 1);
+    EXPECT_THAT([&]() {TTEngineSettings(argc, argv);},
+        ThrowsMessage<std::runtime_error>(HasSubstr("TTEngineSettings: Invalid (out of range) chat in-flight limit=65")));
+    unsetenv("TT_CHAT_IN_FLIGHT");
+}
@@ -76,6 +76,11 @@ protected:
         ON_CALL(*mEngineSettings, getNickname()).WillByDefault(ReturnRef(mHostNickname));
         ON_CALL(*mEngineSettings, getIdentity()).WillByDefault(ReturnRef(mHostIdentity));
         ON_CALL(*mEngineSettings, getNeighbors()).WillByDefault(ReturnRef(mNeighbors));
+        ON_CALL(*mEngineSettings, getBeaconAddress()).WillByDefault(ReturnRef(mBeaconAddress));
+        ON_CALL(*mEngineSettings, getChatLimits()).WillByDefault(ReturnRef(mChatLimits));
+        ON_CALL(*mEngineSettings, getNeighborsCache()).WillByDefault(ReturnRef(mNeighborsCache));
+        ON_CALL(*mEngineSettings, getDetectorSettings()).WillByDefault(ReturnRef(mDetectorSettings));
+        ON_CALL(*mEngineSettings, getHeartbeatPort()).WillByDefault(Return(0));
         // Getter
         EXPECT_CALL(*mEngineSettings, getAbstractFactory())
             .Times(1)
@@ -96,14 +101,15 @@ protected:
                 .WillOnce([&](){ return nullptr; });
         }
         if (textBoxHandlerStatus) {
-            EXPECT_CALL(*mAbstractFactory, createTextBoxHandler(_, _))
-                .WillOnce([&](auto callbackMessageSent, auto callbackContactsSelect) {
+            EXPECT_CALL(*mAbstractFactory, createTextBoxHandler(_, _, _))
+                .WillOnce([&](auto callbackMessageSent, auto callbackContactsSelect, auto callbackChatPage) {
                     mCallbackMessageSent = callbackMessageSent;
                     mCallbackContactsSelect = callbackContactsSelect;
+                    mCallbackChatPage = callbackChatPage;
                     return std::move(mTextBoxHandler);
                 });
         } else {
-            EXPECT_CALL(*mAbstractFactory, createTextBoxHandler(_, _))
+            EXPECT_CALL(*mAbstractFactory, createTextBoxHandler(_, _, _))
                 .WillOnce([&](){ return nullptr; });
         }
         if (!contactsHandlerStatus || !chatHandlerStatus || !textBoxHandlerStatus) {
@@ -133,17 +139,17 @@ protected:
         }
         // Creation of the broadcasters
         if (broadcasterChatStatus) {
-            EXPECT_CALL(*mAbstractFactory, createBroadcasterChat(_, _, _, _))
+            EXPECT_CALL(*mAbstractFactory, createBroadcasterChat(_, _, _, _, _, _))
                 .WillOnce([&](){ return std::move(mBroadcasterChat); });
         } else {
-            EXPECT_CALL(*mAbstractFactory, createBroadcasterChat(_, _, _, _))
+            EXPECT_CALL(*mAbstractFactory, createBroadcasterChat(_, _, _, _, _, _))
                 .WillOnce([&](){ return nullptr; });
         }
         if (broadcasterDiscoveryStatus) {
-            EXPECT_CALL(*mAbstractFactory, createBroadcasterDiscovery(_, _, _, _, _))
+            EXPECT_CALL(*mAbstractFactory, createBroadcasterDiscovery(_, _, _, _, _, _, _, _, _))
                 .WillOnce([&](){ return std::move(mBroadcasterDiscovery); });
         } else {
-            EXPECT_CALL(*mAbstractFactory, createBroadcasterDiscovery(_, _, _, _, _))
+            EXPECT_CALL(*mAbstractFactory, createBroadcasterDiscovery(_, _, _, _, _, _, _, _, _))
                 .WillOnce([&](){ return nullptr; });
         }
         if (!broadcasterChatStatus || !broadcasterDiscoveryStatus) {
@@ -169,10 +175,10 @@ protected:
         }
         // Creation of the server
         if (serverStatus) {
-            EXPECT_CALL(*mAbstractFactory, createServer(_, _, _))
+            EXPECT_CALL(*mAbstractFactory, createServer(_, _, _, _))
                 .WillOnce([&](){ return std::move(mServer); });
         } else {
-            EXPECT_CALL(*mAbstractFactory, createServer(_, _, _))
+            EXPECT_CALL(*mAbstractFactory, createServer(_, _, _, _))
                 .WillOnce([&](){ return nullptr; });
             return;
         }
@@ -237,6 +243,10 @@ protected:
     inline static const std::string mHostNickname = "adriqun";
     inline static const std::string mHostIdentity = "00DEAD00BEAF00";
     inline static const std::deque<std::string> mNeighbors = {"192.168.1.9:1", "192.168.1.10:2", "192.168.1.11:3"};
+    inline static const std::string mBeaconAddress;
+    inline static const TTBroadcasterChatLimits mChatLimits;
+    inline static const std::string mNeighborsCache;
+    inline static const TTNeighborsDetectorSettings mDetectorSettings;
     std::atomic<bool> mContactsStopFlag;
     std::atomic<bool> mChatStopFlag;
     std::atomic<bool> mTextBoxStopFlag;
@@ -251,6 +261,7 @@ protected:
     std::condition_variable mServerCondition;
     TTTextBoxCallbackMessageSent mCallbackMessageSent;
     TTTextBoxCallbackContactSelect mCallbackContactsSelect;
+    TTTextBoxCallbackChatPage mCallbackChatPage;
     std::unique_ptr<TTEngine> mEngine;
 };
 
@@ -541,3 +552,66 @@ TEST_F(TTEngineTest, UnhappyPathSelectionContactsHandlerAndChatHandlerSelectFail
     EXPECT_TRUE(mEngine->isStopped());
     loop.join();
 }
+
+TEST_F(TTEngineTest, HappyPathPaging) {
+    PrepareEngineDependencies();
+    const size_t message = 2;
+    EXPECT_CALL(*mChatHandler, current())
+        .Times(1)
+        .WillOnce(Return(std::optional<size_t>{0}));
+    EXPECT_CALL(*mChatHandler, page(message))
+        .Times(1)
+        .WillOnce(Return(true));
+    CreateEngine();
+    EXPECT_FALSE(mEngine->isStopped());
+    std::thread loop(std::bind(&TTEngine::run, mEngine.get()));
+    std::this_thread::sleep_for(std::chrono::milliseconds{150});
+    EXPECT_FALSE(mEngine->isStopped());
+    mCallbackChatPage(message);
+    EXPECT_FALSE(mEngine->isStopped());
+    mEngine->stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds{200});
+    EXPECT_TRUE(mEngine->isStopped());
+    loop.join();
+}
+
+TEST_F(TTEngineTest, UnhappyPathPagingNoCurrentContact) {
+    PrepareEngineDependencies();
+    const size_t message = 2;
+    EXPECT_CALL(*mChatHandler, current())
+        .Times(1)
+        .WillOnce(Return(std::nullopt));
+    EXPECT_CALL(*mChatHandler, page(_))
+        .Times(0);
+    CreateEngine();
+    EXPECT_FALSE(mEngine->isStopped());
+    std::thread loop(std::bind(&TTEngine::run, mEngine.get()));
+    std::this_thread::sleep_for(std::chrono::milliseconds{150});
+    EXPECT_FALSE(mEngine->isStopped());
+    mCallbackChatPage(message);
+    EXPECT_FALSE(mEngine->isStopped());
+    mEngine->stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds{200});
+    EXPECT_TRUE(mEngine->isStopped());
+    loop.join();
+}
+
+TEST_F(TTEngineTest, UnhappyPathPagingChatHandlerPageFailed) {
+    PrepareEngineDependencies();
+    const size_t message = 2;
+    EXPECT_CALL(*mChatHandler, current())
+        .Times(1)
+        .WillOnce(Return(std::optional<size_t>{0}));
+    EXPECT_CALL(*mChatHandler, page(message))
+        .Times(1)
+        .WillOnce(Return(false));
+    CreateEngine();
+    EXPECT_FALSE(mEngine->isStopped());
+    std::thread loop(std::bind(&TTEngine::run, mEngine.get()));
+    std::this_thread::sleep_for(std::chrono::milliseconds{150});
+    EXPECT_FALSE(mEngine->isStopped());
+    mCallbackChatPage(message);
+    std::this_thread::sleep_for(std::chrono::milliseconds{200});
+    EXPECT_TRUE(mEngine->isStopped());
+    loop.join();
+}
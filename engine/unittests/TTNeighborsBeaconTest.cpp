@@ -0,0 +1,49 @@
+#include "TTNeighborsBeacon.hpp"
+#include "TTBroadcasterDiscoveryMock.hpp"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <thread>
+
+using ::testing::Test;
+using ::testing::Return;
+using ::testing::AtLeast;
+using ::testing::HasSubstr;
+using ::testing::ThrowsMessage;
+using ::testing::_;
+
+class TTNeighborsBeaconTest : public Test {
+protected:
+    TTNeighborsBeaconTest() {
+        EXPECT_CALL(mBroadcasterDiscovery, getNickname())
+            .WillRepeatedly(Return("Gabrielle"));
+        EXPECT_CALL(mBroadcasterDiscovery, getIdentity())
+            .WillRepeatedly(Return("6e6e6e6"));
+        EXPECT_CALL(mBroadcasterDiscovery, getIpAddressAndPort())
+            .WillRepeatedly(Return(mNetworkInterface.getIpAddressAndPort()));
+    }
+    const TTNetworkInterface mNetworkInterface{"lo", "127.0.0.1", "47820"};
+    TTBroadcasterDiscoveryMock mBroadcasterDiscovery;
+};
+
+TEST_F(TTNeighborsBeaconTest, HappyPathBeaconReceived) {
+    // Unicast loopback address, so each beacon is received by the sender itself
+    std::atomic<size_t> received{0};
+    EXPECT_CALL(mBroadcasterDiscovery, handleBeacon(TTBeaconRequest("Gabrielle", "6e6e6e6", "127.0.0.1:47820")))
+        .Times(AtLeast(2))
+        .WillRepeatedly([&](const TTBeaconRequest&) {
+            ++received;
+            return true;
+        });
+    TTNeighborsBeacon beacon("127.0.0.1", mNetworkInterface, mBroadcasterDiscovery, std::chrono::milliseconds{100});
+    std::thread loop(&TTNeighborsBeacon::run, &beacon);
+    std::this_thread::sleep_for(std::chrono::milliseconds{500});
+    beacon.stop();
+    loop.join();
+    EXPECT_TRUE(beacon.isStopped());
+    EXPECT_GE(received.load(), 2);
+}
+
+TEST_F(TTNeighborsBeaconTest, UnhappyPathInvalidGroupAddress) {
+    EXPECT_THAT([&]() {TTNeighborsBeacon("blahblah", mNetworkInterface, mBroadcasterDiscovery);},
+        ThrowsMessage<std::runtime_error>(HasSubstr("TTNeighborsBeacon: Invalid group address=blahblah")));
+}
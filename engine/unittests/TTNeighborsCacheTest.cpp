@@ -0,0 +1,108 @@
+#include "TTNeighborsCache.hpp"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <fstream>
+
+using ::testing::ThrowsMessage;
+using ::testing::HasSubstr;
+
+class TTNeighborsCacheTest : public ::testing::Test {
+protected:
+    virtual void SetUp() override {
+        mPath = std::filesystem::temp_directory_path() / "tteams-unittests" /
+            ::testing::UnitTest::GetInstance()->current_test_info()->name();
+        std::filesystem::remove(mPath);
+    }
+    virtual void TearDown() override {
+        std::filesystem::remove(mPath);
+    }
+    static std::vector<std::string> identities(const TTNeighborsCache& cache) {
+        std::vector<std::string> result;
+        for (const auto& entry : cache.load()) {
+            result.push_back(entry.identity);
+        }
+        return result;
+    }
+    std::filesystem::path mPath;
+};
+
+TEST_F(TTNeighborsCacheTest, HappyPathNeighborsLoadedMostRecentlySeenFirst) {
+    TTNeighborsCache cache(mPath);
+    EXPECT_TRUE(cache.store("Oak", "14eeffe", "122.124.0.9:1777"));
+    EXPECT_TRUE(cache.store("Johny", "123456", "168.0.55.1:1777"));
+    EXPECT_TRUE(cache.store("Camille", "ddddddd", "145.111.55.8:1777"));
+    EXPECT_TRUE(cache.touch("14eeffe"));
+    EXPECT_EQ(cache.size(), 3);
+    EXPECT_EQ(identities(cache), (std::vector<std::string>{"14eeffe", "ddddddd", "123456"}));
+    const auto entries = cache.load();
+    EXPECT_EQ(entries[0].nickname, "Oak");
+    EXPECT_EQ(entries[0].ipAddressAndPort, "122.124.0.9:1777");
+    EXPECT_GT(entries[0].lastSeen, entries[1].lastSeen);
+}
+
+TEST_F(TTNeighborsCacheTest, HappyPathNeighborsKeptAfterRestart) {
+    {
+        TTNeighborsCache cache(mPath);
+        EXPECT_TRUE(cache.store("Oak", "14eeffe", "122.124.0.9:1777"));
+        EXPECT_TRUE(cache.store("Johny", "123456", "168.0.55.1:1777"));
+    }
+    TTNeighborsCache cache(mPath);
+    EXPECT_EQ(identities(cache), (std::vector<std::string>{"123456", "14eeffe"}));
+    // Updates after restart are still ordered after the loaded ones
+    EXPECT_TRUE(cache.touch("14eeffe"));
+    EXPECT_EQ(identities(cache), (std::vector<std::string>{"14eeffe", "123456"}));
+}
+
+TEST_F(TTNeighborsCacheTest, HappyPathNeighborUpdatedInPlace) {
+    TTNeighborsCache cache(mPath);
+    EXPECT_TRUE(cache.store("Oak", "14eeffe", "122.124.0.9:1777"));
+    EXPECT_TRUE(cache.store("Oak the Great", "14eeffe", "122.124.0.10:1777"));
+    const auto entries = cache.load();
+    ASSERT_EQ(entries.size(), 1);
+    EXPECT_EQ(entries[0].nickname, "Oak the Great");
+    EXPECT_EQ(entries[0].ipAddressAndPort, "122.124.0.10:1777");
+}
+
+TEST_F(TTNeighborsCacheTest, HappyPathLeastRecentlySeenEvictedWhenFull) {
+    TTNeighborsCache cache(mPath, 2);
+    EXPECT_TRUE(cache.store("Oak", "14eeffe", "122.124.0.9:1777"));
+    EXPECT_TRUE(cache.store("Johny", "123456", "168.0.55.1:1777"));
+    EXPECT_TRUE(cache.touch("14eeffe"));
+    EXPECT_TRUE(cache.store("Camille", "ddddddd", "145.111.55.8:1777"));
+    EXPECT_EQ(cache.size(), 2);
+    EXPECT_EQ(identities(cache), (std::vector<std::string>{"ddddddd", "14eeffe"}));
+    EXPECT_FALSE(cache.touch("123456"));
+}
+
+TEST_F(TTNeighborsCacheTest, UnhappyPathDataDoesNotFit) {
+    TTNeighborsCache cache(mPath);
+    EXPECT_FALSE(cache.store(std::string(64, 'a'), "14eeffe", "122.124.0.9:1777"));
+    EXPECT_FALSE(cache.store("Oak", "", "122.124.0.9:1777"));
+    EXPECT_FALSE(cache.store("Oak", "14eeffe", std::string(32, '1')));
+    EXPECT_EQ(cache.size(), 0);
+}
+
+TEST_F(TTNeighborsCacheTest, UnhappyPathIncompatibleFileDiscarded) {
+    {
+        TTNeighborsCache cache(mPath, 4);
+        EXPECT_TRUE(cache.store("Oak", "14eeffe", "122.124.0.9:1777"));
+    }
+    // Different capacity
+    {
+        TTNeighborsCache cache(mPath, 8);
+        EXPECT_EQ(cache.size(), 0);
+        EXPECT_TRUE(cache.store("Oak", "14eeffe", "122.124.0.9:1777"));
+    }
+    // Garbage
+    {
+        std::ofstream file(mPath, std::ios::binary | std::ios::trunc);
+        file << "garbage";
+    }
+    TTNeighborsCache cache(mPath, 8);
+    EXPECT_EQ(cache.size(), 0);
+}
+
+TEST_F(TTNeighborsCacheTest, UnhappyPathFileCannotBeOpened) {
+    EXPECT_THAT([]() { TTNeighborsCache("/dev/null/neighbors"); },
+        ThrowsMessage<std::runtime_error>(HasSubstr("TTNeighborsCache: Failed to open file=/dev/null/neighbors")));
+}
@@ -0,0 +1,115 @@
+#include "TTNeighborsDetector.hpp"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace std::chrono_literals;
+
+class TTNeighborsDetectorTest : public ::testing::Test {
+protected:
+    // Neighbor answers each probe after delay drawn from normal distribution
+    void Learn(TTNeighborsDetector& detector, size_t id, double deviation, size_t heartbeats) {
+        std::mt19937 generator(7);
+        std::normal_distribution<double> delay(250.0, deviation);
+        detector.heartbeat(id, mNow);
+        for (size_t i = 0; i < heartbeats; ++i) {
+            mNow = detector.due(id) + std::chrono::milliseconds(static_cast<int>(std::max(delay(generator), 0.0)));
+            detector.heartbeat(id, mNow);
+        }
+    }
+    // Time from the expected heartbeat until neighbor is suspected
+    std::chrono::milliseconds Detection(const TTNeighborsDetector& detector, size_t id) {
+        const auto expected = detector.due(id);
+        auto now = expected;
+        while (!detector.suspected(id, now)) {
+            now += 10ms;
+        }
+        return std::chrono::duration_cast<std::chrono::milliseconds>(now - expected);
+    }
+    TTNeighborsDetector::Clock::time_point mNow = TTNeighborsDetector::Clock::now();
+};
+
+TEST_F(TTNeighborsDetectorTest, HappyPathHealthyNeighborProbedLessOften) {
+    TTNeighborsDetector detector;
+    EXPECT_EQ(detector.due(1), TTNeighborsDetector::Clock::time_point::max());
+    detector.heartbeat(1, mNow);
+    EXPECT_EQ(detector.due(1), mNow + TTNeighborsDetectorSettings::DEFAULT_MIN_INTERVAL);
+    std::vector<std::chrono::milliseconds> intervals;
+    for (size_t i = 0; i < 5; ++i) {
+        mNow = detector.due(1);
+        detector.heartbeat(1, mNow);
+        intervals.push_back(detector.interval(1));
+    }
+    EXPECT_EQ(intervals, (std::vector<std::chrono::milliseconds>{2000ms, 4000ms, 8000ms, 8000ms, 8000ms}));
+    EXPECT_EQ(detector.deadline(), mNow + 8000ms);
+}
+
+TEST_F(TTNeighborsDetectorTest, HappyPathPhiGrowsOnlyAfterExpectedHeartbeat) {
+    TTNeighborsDetector detector;
+    Learn(detector, 1, 20.0, 50);
+    const auto expected = detector.due(1);
+    EXPECT_EQ(detector.phi(1, expected - 500ms), 0.0);
+    EXPECT_LT(detector.phi(1, expected + 250ms), 1.0);
+    EXPECT_LT(detector.phi(1, expected + 300ms), detector.phi(1, expected + 600ms));
+    EXPECT_FALSE(detector.suspected(1, expected + 300ms));
+    EXPECT_TRUE(detector.suspected(1, expected + 5000ms));
+    EXPECT_EQ(detector.phi(2, expected + 5000ms), 0.0);
+}
+
+TEST_F(TTNeighborsDetectorTest, HappyPathJitteryNeighborSuspectedLater) {
+    TTNeighborsDetector detector;
+    Learn(detector, 1, 20.0, 50);
+    Learn(detector, 2, 400.0, 50);
+    const auto stable = Detection(detector, 1);
+    const auto jittery = Detection(detector, 2);
+    // Regular neighbor is bounded by min deviation, jittery one gets more slack
+    EXPECT_LT(stable, 1500ms);
+    EXPECT_GT(jittery, stable + 600ms);
+}
+
+TEST_F(TTNeighborsDetectorTest, HappyPathFailureRetriedSoonThenBackedOff) {
+    TTNeighborsDetector detector;
+    Learn(detector, 1, 20.0, 5);
+    const auto expected = detector.due(1);
+    // Missed heartbeat is retried after min interval
+    detector.failure(1, expected);
+    EXPECT_EQ(detector.interval(1), TTNeighborsDetectorSettings::DEFAULT_MIN_INTERVAL);
+    EXPECT_EQ(detector.due(1), expected + 1000ms);
+    // Failed neighbor is probed less and less often
+    mNow = expected + 10000ms;
+    ASSERT_TRUE(detector.suspected(1, mNow));
+    detector.failure(1, mNow);
+    EXPECT_EQ(detector.interval(1), 2000ms);
+    detector.failure(1, mNow);
+    EXPECT_EQ(detector.interval(1), 4000ms);
+    // Recovered neighbor starts from min interval, outage is not learned
+    detector.heartbeat(1, mNow);
+    EXPECT_EQ(detector.interval(1), TTNeighborsDetectorSettings::DEFAULT_MIN_INTERVAL);
+    EXPECT_FALSE(detector.suspected(1, mNow + 1100ms));
+}
+
+TEST_F(TTNeighborsDetectorTest, HappyPathThresholdAndIntervalsConfigurable) {
+    TTNeighborsDetectorSettings settings;
+    settings.threshold = 2.0;
+    settings.minInterval = 500ms;
+    settings.maxInterval = 1000ms;
+    TTNeighborsDetector detector(settings);
+    TTNeighborsDetector defaults;
+    Learn(detector, 1, 20.0, 20);
+    Learn(defaults, 1, 20.0, 20);
+    EXPECT_EQ(detector.interval(1), 1000ms);
+    EXPECT_LT(Detection(detector, 1), Detection(defaults, 1));
+}
+
+TEST_F(TTNeighborsDetectorTest, HappyPathPostponedProbeDoesNotAffectSuspicion) {
+    TTNeighborsDetector detector;
+    Learn(detector, 1, 20.0, 5);
+    const auto expected = detector.due(1);
+    detector.postpone(1, expected + 500ms);
+    EXPECT_EQ(detector.due(1), expected + 500ms);
+    EXPECT_EQ(detector.deadline(), expected + 500ms);
+    EXPECT_EQ(detector.phi(1, expected - 100ms), 0.0);
+    EXPECT_TRUE(detector.suspected(1, expected + 5000ms));
+    // Neighbor which is not tracked is not postponed
+    detector.postpone(2, expected);
+    EXPECT_EQ(detector.due(2), TTNeighborsDetector::Clock::time_point::max());
+}
@@ -0,0 +1,47 @@
+#include "TTNeighborsIdentity.hpp"
+#include "TerminalTeams.pb.h"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+TEST(TTNeighborsIdentityTest, HappyPathPackUnpack) {
+    const std::string identity = "a94a8fe5ccb19ba61c4c0873d391e987982fbbd3";
+    const auto key = TTNeighborsIdentity::pack(identity);
+    ASSERT_TRUE(key);
+    EXPECT_EQ(key.value().size(), 20);
+    EXPECT_EQ(static_cast<uint8_t>(key.value().front()), 0xa9);
+    EXPECT_EQ(TTNeighborsIdentity::unpack(key.value()), identity);
+}
+
+TEST(TTNeighborsIdentityTest, HappyPathOtherFormatNotPacked) {
+    EXPECT_FALSE(TTNeighborsIdentity::pack("5ef885a"));
+    EXPECT_FALSE(TTNeighborsIdentity::pack(""));
+    // Uppercase would not be restored as it is
+    EXPECT_FALSE(TTNeighborsIdentity::pack("A94A8FE5CCB19BA61C4C0873D391E987982FBBD3"));
+    EXPECT_FALSE(TTNeighborsIdentity::pack("a94a8fe5ccb19ba61c4c0873d391e987982fbbdx"));
+}
+
+TEST(TTNeighborsIdentityTest, HappyPathSetGet) {
+    tt::TellRequest packed;
+    TTNeighborsIdentity::set(packed, "a94a8fe5ccb19ba61c4c0873d391e987982fbbd3");
+    EXPECT_TRUE(packed.identity().empty());
+    EXPECT_TRUE(TTNeighborsIdentity::has(packed));
+    // Key is not unpacked, contacts resolve it as it is
+    EXPECT_EQ(TTNeighborsIdentity::get(packed), TTNeighborsIdentity::pack("a94a8fe5ccb19ba61c4c0873d391e987982fbbd3"));
+    tt::TellRequest plain;
+    TTNeighborsIdentity::set(plain, "5ef885a");
+    EXPECT_TRUE(plain.key().empty());
+    EXPECT_EQ(TTNeighborsIdentity::get(plain), "5ef885a");
+    EXPECT_FALSE(TTNeighborsIdentity::has(tt::TellRequest()));
+}
+
+TEST(TTNeighborsIdentityTest, HappyPathSetGetTarget) {
+    tt::HeartbeatRequest packed;
+    TTNeighborsIdentity::setTarget(packed, "a94a8fe5ccb19ba61c4c0873d391e987982fbbd3");
+    EXPECT_TRUE(packed.target().empty());
+    EXPECT_EQ(TTNeighborsIdentity::getTarget(packed), TTNeighborsIdentity::pack("a94a8fe5ccb19ba61c4c0873d391e987982fbbd3"));
+    tt::HeartbeatRequest plain;
+    TTNeighborsIdentity::setTarget(plain, "5ef885a");
+    EXPECT_TRUE(plain.targetkey().empty());
+    EXPECT_EQ(TTNeighborsIdentity::getTarget(plain), "5ef885a");
+    EXPECT_TRUE(TTNeighborsIdentity::getTarget(tt::HeartbeatRequest()).empty());
+}
@@ -0,0 +1,107 @@
+#include "TTNeighborsMembership.hpp"
+#include "TTContactsKey.hpp"
+#include <gtest/gtest.h>
+#include <set>
+
+TEST(TTNeighborsMembershipTest, HappyPathNextProbesEachMemberOncePerRound) {
+    TTNeighborsMembership membership;
+    for (size_t id = 1; id <= 5; ++id) {
+        EXPECT_TRUE(membership.add(id, std::to_string(id)));
+    }
+    EXPECT_FALSE(membership.add(1, "1"));
+    const auto eligible = [](size_t) { return true; };
+    for (size_t round = 0; round < 3; ++round) {
+        std::set<size_t> probed;
+        for (size_t i = 0; i < 5; ++i) {
+            const auto id = membership.next(eligible);
+            ASSERT_TRUE(id);
+            probed.insert(id.value());
+        }
+        EXPECT_EQ(probed.size(), 5);
+    }
+}
+
+TEST(TTNeighborsMembershipTest, HappyPathNextSkipsNotEligible) {
+    TTNeighborsMembership membership;
+    EXPECT_FALSE(membership.next([](size_t) { return true; }));
+    membership.add(1, "1");
+    membership.add(2, "2");
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(membership.next([](size_t id) { return id == 2; }), 2);
+    }
+    EXPECT_FALSE(membership.next([](size_t) { return false; }));
+}
+
+TEST(TTNeighborsMembershipTest, HappyPathHelpersExcludeTargetAndFailedMembers) {
+    TTNeighborsMembership membership(2);
+    for (size_t id = 1; id <= 5; ++id) {
+        membership.add(id, std::to_string(id));
+    }
+    EXPECT_TRUE(membership.observe(3, false));
+    EXPECT_FALSE(membership.observe(3, false));
+    for (size_t i = 0; i < 10; ++i) {
+        const auto helpers = membership.helpers(1);
+        EXPECT_EQ(helpers.size(), 2);
+        for (const auto helper : helpers) {
+            EXPECT_NE(helper, 1);
+            EXPECT_NE(helper, 3);
+        }
+    }
+}
+
+TEST(TTNeighborsMembershipTest, HappyPathApplyIncarnationOrder) {
+    TTNeighborsMembership membership;
+    membership.add(1, "aaa");
+    // Failure wins within the same incarnation
+    EXPECT_EQ(membership.apply(TTMemberUpdate("aaa", 0, false), "host"), std::pair(size_t(1), false));
+    EXPECT_FALSE(membership.alive(1));
+    EXPECT_FALSE(membership.apply(TTMemberUpdate("aaa", 0, true), "host"));
+    EXPECT_FALSE(membership.alive(1));
+    // Newer incarnation wins
+    EXPECT_EQ(membership.apply(TTMemberUpdate("aaa", 1, true), "host"), std::pair(size_t(1), true));
+    EXPECT_TRUE(membership.alive(1));
+    EXPECT_FALSE(membership.apply(TTMemberUpdate("aaa", 0, false), "host"));
+    EXPECT_TRUE(membership.alive(1));
+    // Unknown members are ignored
+    EXPECT_FALSE(membership.apply(TTMemberUpdate("bbb", 5, false), "host"));
+}
+
+TEST(TTNeighborsMembershipTest, HappyPathApplyRefutesFailureOfHost) {
+    TTNeighborsMembership membership;
+    EXPECT_FALSE(membership.apply(TTMemberUpdate("host", 3, false), "host"));
+    const auto updates = membership.updates();
+    ASSERT_EQ(updates.size(), 1);
+    EXPECT_EQ(updates.front(), TTMemberUpdate("host", 4, true));
+}
+
+TEST(TTNeighborsMembershipTest, HappyPathApplyPackedKey) {
+    const std::string identity = "a94a8fe5ccb19ba61c4c0873d391e987982fbbd3";
+    const std::string host = "0feca8420feca8420feca8420feca8420feca842";
+    TTNeighborsMembership membership;
+    membership.add(1, identity);
+    membership.updates();
+    // Update received from the network carries packed key
+    EXPECT_EQ(membership.apply(TTMemberUpdate(TTContactsKey::make(identity), 0, false), host), std::pair(size_t(1), false));
+    auto updates = membership.updates();
+    ASSERT_EQ(updates.size(), 1);
+    EXPECT_EQ(updates.front(), TTMemberUpdate(identity, 0, false));
+    EXPECT_FALSE(membership.apply(TTMemberUpdate(TTContactsKey::make(host), 2, false), host));
+    updates = membership.updates();
+    ASSERT_EQ(updates.size(), 2);
+    EXPECT_EQ(updates.back(), TTMemberUpdate(host, 3, true));
+}
+
+TEST(TTNeighborsMembershipTest, HappyPathUpdatesAreLimited) {
+    TTNeighborsMembership membership(3, 2);
+    for (size_t id = 1; id <= 3; ++id) {
+        membership.add(id, std::to_string(id));
+    }
+    // Piggyback size is bounded, pending updates rotate
+    size_t sent = 0;
+    for (auto updates = membership.updates(); !updates.empty(); updates = membership.updates()) {
+        EXPECT_LE(updates.size(), 2);
+        sent += updates.size();
+        ASSERT_LT(sent, 100);
+    }
+    EXPECT_GE(sent, 3);
+}
@@ -0,0 +1,74 @@
+#include "TTNeighborsPulse.hpp"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <thread>
+
+using ::testing::Test;
+using ::testing::HasSubstr;
+using ::testing::ThrowsMessage;
+
+class TTNeighborsPulseTest : public Test {
+protected:
+    void WaitForContact(const TTNeighborsLiveness& liveness, size_t id) {
+        for (size_t i = 0; i < 50 && !liveness.last(id); ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        }
+    }
+    // Both ends listen on the same port, on different loopback addresses
+    const uint16_t mPort = 47821;
+    TTNeighborsLiveness mHostLiveness;
+    TTNeighborsLiveness mNeighborLiveness;
+};
+
+TEST_F(TTNeighborsPulseTest, HappyPathPingAnsweredBothEndsRecordContact) {
+    TTNeighborsPulse host("127.0.0.1", mPort, "6e6e6e6", mHostLiveness);
+    TTNeighborsPulse neighbor("127.0.0.2", mPort, "14eeffe", mNeighborLiveness);
+    std::thread hostLoop(&TTNeighborsPulse::run, &host);
+    std::thread neighborLoop(&TTNeighborsPulse::run, &neighbor);
+    ASSERT_TRUE(host.add(1, "14eeffe", "127.0.0.2"));
+    ASSERT_TRUE(neighbor.add(7, "6e6e6e6", "127.0.0.1"));
+    EXPECT_TRUE(host.ping(1));
+    WaitForContact(mHostLiveness, 1);
+    WaitForContact(mNeighborLiveness, 7);
+    host.stop();
+    neighbor.stop();
+    hostLoop.join();
+    neighborLoop.join();
+    // Pong proves liveness of the neighbor, ping proves liveness of the host
+    EXPECT_TRUE(mHostLiveness.last(1));
+    EXPECT_TRUE(mNeighborLiveness.last(7));
+}
+
+TEST_F(TTNeighborsPulseTest, UnhappyPathPingToOtherIdentityNotAnswered) {
+    TTNeighborsPulse host("127.0.0.1", mPort, "6e6e6e6", mHostLiveness);
+    TTNeighborsPulse neighbor("127.0.0.2", mPort, "14eeffe", mNeighborLiveness);
+    std::thread hostLoop(&TTNeighborsPulse::run, &host);
+    std::thread neighborLoop(&TTNeighborsPulse::run, &neighbor);
+    // Host restarted under new identity is not mistaken for the old one
+    ASSERT_TRUE(host.add(1, "5e5fe55f", "127.0.0.2"));
+    EXPECT_TRUE(host.ping(1));
+    WaitForContact(mHostLiveness, 1);
+    host.stop();
+    neighbor.stop();
+    hostLoop.join();
+    neighborLoop.join();
+    EXPECT_FALSE(mHostLiveness.last(1));
+}
+
+TEST_F(TTNeighborsPulseTest, UnhappyPathUnknownNeighborOrAddress) {
+    TTNeighborsPulse host("127.0.0.1", mPort, "6e6e6e6", mHostLiveness);
+    EXPECT_FALSE(host.ping(1));
+    EXPECT_FALSE(host.add(1, "14eeffe", "blahblah"));
+    EXPECT_FALSE(host.ping(1));
+}
+
+TEST_F(TTNeighborsPulseTest, UnhappyPathInvalidIpAddress) {
+    EXPECT_THAT([&]() {TTNeighborsPulse("blahblah", mPort, "6e6e6e6", mHostLiveness);},
+        ThrowsMessage<std::runtime_error>(HasSubstr("TTNeighborsPulse: Invalid IP address=blahblah")));
+}
+
+TEST_F(TTNeighborsPulseTest, HappyPathHashIsStable) {
+    EXPECT_EQ(TTNeighborsPulse::hash(""), 14695981039346656037ULL);
+    EXPECT_EQ(TTNeighborsPulse::hash("6e6e6e6"), TTNeighborsPulse::hash("6e6e6e6"));
+    EXPECT_NE(TTNeighborsPulse::hash("6e6e6e6"), TTNeighborsPulse::hash("14eeffe"));
+}
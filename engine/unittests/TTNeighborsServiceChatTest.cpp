@@ -1,4 +1,5 @@
 #include "TTNeighborsServiceChat.hpp"
+#include "TTNeighborsIdentity.hpp"
 #include "TTBroadcasterChatMock.hpp"
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
@@ -29,6 +30,77 @@ TEST(TTNeighborsServiceChatTest, HappyPathTell) {
     EXPECT_EQ(reply.identity(), identity2);
 }
 
+TEST(TTNeighborsServiceChatTest, HappyPathTellSequenced) {
+    grpc::ServerContext context;
+    tt::TellRequest request;
+    request.set_identity("identity1");
+    request.set_message("msg");
+    request.set_epoch(7);
+    request.set_sequence(5);
+    tt::TellReply reply;
+    TTBroadcasterChatMock handler;
+    EXPECT_CALL(handler, handleReceive(TTTellRequest("identity1", "msg", 7, 5)))
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(handler, getIdentity())
+        .Times(1)
+        .WillOnce(Return("identity2"));
+    TTNeighborsServiceChat service(handler);
+    EXPECT_TRUE(service.Tell(&context, &request, &reply).ok());
+    // Cumulative acknowledgement
+    EXPECT_EQ(reply.sequence(), 5);
+}
+
+TEST(TTNeighborsServiceChatTest, HappyPathNarrateSequenced) {
+    grpc::ServerContext context;
+    TTNarrateRequest message;
+    for (size_t i = 0; i < 2; ++i) {
+        tt::NarrateRequest request;
+        request.set_identity("identity1");
+        request.set_message("msg" + std::to_string(i));
+        request.set_epoch(7);
+        request.set_sequence(5 + i);
+        ASSERT_TRUE(TTNeighborsServiceChat::appendNarrate(message, request));
+    }
+    tt::NarrateReply reply;
+    TTBroadcasterChatMock handler;
+    EXPECT_CALL(handler, handleReceive(TTNarrateRequest("identity1", {"msg0", "msg1"}, 7, 5)))
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(handler, getIdentity())
+        .Times(1)
+        .WillOnce(Return("identity2"));
+    TTNeighborsServiceChat service(handler);
+    EXPECT_TRUE(service.handleNarrate(&context, message, &reply).ok());
+    EXPECT_EQ(reply.sequence(), 6);
+}
+
+TEST(TTNeighborsServiceChatTest, HappyPathAppendNarrateMovesMessage) {
+    google::protobuf::Arena arena;
+    auto* request = google::protobuf::Arena::CreateMessage<tt::NarrateRequest>(&arena);
+    TTNarrateRequest message;
+    request->set_identity("identity1");
+    request->set_message(std::string(4096, 'x'));
+    const auto* data = request->message().data();
+    ASSERT_TRUE(TTNeighborsServiceChat::appendNarrate(message, *request));
+    // Buffer of the request is taken over, not copied
+    EXPECT_EQ(message.identity, "identity1");
+    EXPECT_EQ(message.messages.back().data(), data);
+    EXPECT_TRUE(request->message().empty());
+    request->set_identity("identity2");
+    request->set_message("msg");
+    EXPECT_FALSE(TTNeighborsServiceChat::appendNarrate(message, *request));
+    EXPECT_EQ(message.messages.size(), 1);
+}
+
+TEST(TTNeighborsServiceChatTest, UnhappyPathHandleNarrateEmpty) {
+    grpc::ServerContext context;
+    tt::NarrateReply reply;
+    TTBroadcasterChatMock handler;
+    TTNeighborsServiceChat service(handler);
+    EXPECT_FALSE(service.handleNarrate(&context, TTNarrateRequest(), &reply).ok());
+}
+
 TEST(TTNeighborsServiceChatTest, UnhappyPathTellContextIsNull) {
     tt::TellRequest request;
     tt::TellReply reply;
@@ -208,3 +280,146 @@ TEST(TTNeighborsServiceChatTest, UnhappyPathNarrateManyUniqueIds) {
     TTNeighborsServiceChat service(handler);
     EXPECT_FALSE(service.Narrate(&context, srnr, &reply).ok());
 }
+
+class ServerReaderWriterInterfaceConverse : public ::grpc::ServerReaderWriterInterface<::tt::ConverseReply, ::tt::ConverseRequest> {
+public:
+    MOCK_METHOD(void, SendInitialMetadata, (), (override));
+    MOCK_METHOD(bool, NextMessageSize, (uint32_t* sz), (override));
+    MOCK_METHOD(bool, Read, (tt::ConverseRequest* msg), (override));
+    MOCK_METHOD(bool, Write, (const tt::ConverseReply& msg, grpc::WriteOptions options), (override));
+};
+
+TEST(TTNeighborsServiceChatTest, HappyPathConverse) {
+    const std::string identity1 = "identity1";
+    const std::string identity2 = "identity2";
+    const std::deque<std::string> messages = {"msg1", "msg2"};
+    grpc::ServerContext context;
+    size_t counter = 0;
+    auto srwic = std::make_unique<ServerReaderWriterInterfaceConverse>();
+    auto srwc = reinterpret_cast<grpc::ServerReaderWriter<tt::ConverseReply, tt::ConverseRequest>*>(srwic.get());
+    EXPECT_CALL(*srwic, Read(_))
+        .Times(3)
+        .WillRepeatedly([&](tt::ConverseRequest* msg) {
+            const auto value = counter++;
+            if (value < messages.size()) {
+                msg->set_identity(identity1);
+                msg->set_message(messages[value]);
+                msg->set_sequence(value + 1);
+                return true;
+            }
+            return false;
+        });
+    size_t acknowledged = 0;
+    EXPECT_CALL(*srwic, Write(_, _))
+        .Times(2)
+        .WillRepeatedly([&](const tt::ConverseReply& msg, grpc::WriteOptions) {
+            EXPECT_EQ(msg.identity(), identity2);
+            EXPECT_EQ(msg.sequence(), ++acknowledged);
+            return true;
+        });
+    TTBroadcasterChatMock handler;
+    for (size_t i = 0; i < messages.size(); ++i) {
+        EXPECT_CALL(handler, handleReceive(TTTellRequest(identity1, messages[i], 0, i + 1)))
+            .Times(1)
+            .WillOnce(Return(true));
+    }
+    EXPECT_CALL(handler, getIdentity())
+        .Times(2)
+        .WillRepeatedly(Return(identity2));
+    TTNeighborsServiceChat service(handler);
+    EXPECT_TRUE(service.Converse(&context, srwc).ok());
+}
+
+TEST(TTNeighborsServiceChatTest, UnhappyPathConverseStreamIsNull) {
+    grpc::ServerContext context;
+    TTBroadcasterChatMock handler;
+    TTNeighborsServiceChat service(handler);
+    EXPECT_FALSE(service.Converse(&context, nullptr).ok());
+}
+
+TEST(TTNeighborsServiceChatTest, UnhappyPathConverseHandlerFailed) {
+    grpc::ServerContext context;
+    auto srwic = std::make_unique<ServerReaderWriterInterfaceConverse>();
+    auto srwc = reinterpret_cast<grpc::ServerReaderWriter<tt::ConverseReply, tt::ConverseRequest>*>(srwic.get());
+    EXPECT_CALL(*srwic, Read(_))
+        .Times(1)
+        .WillOnce([&](tt::ConverseRequest* msg) {
+            msg->set_identity("identity1");
+            msg->set_message("msg");
+            msg->set_sequence(1);
+            return true;
+        });
+    EXPECT_CALL(*srwic, Write(_, _))
+        .Times(0);
+    TTBroadcasterChatMock handler;
+    EXPECT_CALL(handler, handleReceive(TTTellRequest("identity1", "msg", 0, 1)))
+        .Times(1)
+        .WillOnce(Return(false));
+    TTNeighborsServiceChat service(handler);
+    EXPECT_FALSE(service.Converse(&context, srwc).ok());
+}
+
+TEST(TTNeighborsServiceChatTest, HappyPathConverseIdentityOfFirstRequest) {
+    const std::string identity1 = "a94a8fe5ccb19ba61c4c0873d391e987982fbbd3";
+    const std::deque<std::string> messages = {"msg1", "msg2"};
+    grpc::ServerContext context;
+    size_t counter = 0;
+    auto srwic = std::make_unique<ServerReaderWriterInterfaceConverse>();
+    auto srwc = reinterpret_cast<grpc::ServerReaderWriter<tt::ConverseReply, tt::ConverseRequest>*>(srwic.get());
+    EXPECT_CALL(*srwic, Read(_))
+        .Times(3)
+        .WillRepeatedly([&](tt::ConverseRequest* msg) {
+            const auto value = counter++;
+            msg->Clear();
+            if (value < messages.size()) {
+                if (value == 0) {
+                    TTNeighborsIdentity::set(*msg, identity1);
+                }
+                msg->set_message(messages[value]);
+                msg->set_sequence(value + 1);
+                return true;
+            }
+            return false;
+        });
+    EXPECT_CALL(*srwic, Write(_, _))
+        .Times(2)
+        .WillRepeatedly(Return(true));
+    TTBroadcasterChatMock handler;
+    for (size_t i = 0; i < messages.size(); ++i) {
+        EXPECT_CALL(handler, handleReceive(TTTellRequest(TTContactsKey::make(identity1), messages[i], 0, i + 1)))
+            .Times(1)
+            .WillOnce(Return(true));
+    }
+    EXPECT_CALL(handler, getIdentity())
+        .Times(2)
+        .WillRepeatedly(Return("identity2"));
+    TTNeighborsServiceChat service(handler);
+    EXPECT_TRUE(service.Converse(&context, srwc).ok());
+}
+
+TEST(TTNeighborsServiceChatTest, UnhappyPathConverseIdentityMissing) {
+    grpc::ServerContext context;
+    tt::ConverseRequest request;
+    request.set_message("msg");
+    tt::ConverseReply reply;
+    std::string identity;
+    TTBroadcasterChatMock handler;
+    EXPECT_CALL(handler, handleReceive(::testing::An<const TTTellRequest&>()))
+        .Times(0);
+    TTNeighborsServiceChat service(handler);
+    EXPECT_FALSE(service.handleConverse(&context, &request, identity, &reply).ok());
+}
+
+TEST(TTNeighborsServiceChatTest, HappyPathAppendNarrateIdentityOfFirstRequest) {
+    const std::string identity1 = "a94a8fe5ccb19ba61c4c0873d391e987982fbbd3";
+    TTNarrateRequest message;
+    tt::NarrateRequest request;
+    TTNeighborsIdentity::set(request, identity1);
+    request.set_message("msg0");
+    ASSERT_TRUE(TTNeighborsServiceChat::appendNarrate(message, request));
+    request.Clear();
+    request.set_message("msg1");
+    ASSERT_TRUE(TTNeighborsServiceChat::appendNarrate(message, request));
+    // Key is passed to the handler as it is, contacts resolve it without unpacking
+    EXPECT_EQ(message, TTNarrateRequest(TTContactsKey::make(identity1), {"msg0", "msg1"}));
+}
@@ -33,11 +33,18 @@ TEST(TTNeighborsServiceDiscoveryTest, HappyPathGreet) {
     EXPECT_CALL(handler, getIpAddressAndPort())
         .Times(1)
         .WillOnce(Return(ipAddressAndPort2));
+    EXPECT_CALL(handler, getPeers())
+        .Times(1)
+        .WillOnce(Return(std::deque<TTPeer>{{"nickname3", "identity3", "192.168.1.19:19"}}));
     TTNeighborsServiceDiscovery service(handler);
     EXPECT_TRUE(service.Greet(&context, &request, &reply).ok());
     EXPECT_EQ(reply.nickname(), nickname2);
     EXPECT_EQ(reply.identity(), identity2);
     EXPECT_EQ(reply.ipaddressandport(), ipAddressAndPort2);
+    ASSERT_EQ(reply.peers_size(), 1);
+    EXPECT_EQ(reply.peers(0).nickname(), "nickname3");
+    EXPECT_EQ(reply.peers(0).identity(), "identity3");
+    EXPECT_EQ(reply.peers(0).ipaddressandport(), "192.168.1.19:19");
 }
 
 TEST(TTNeighborsServiceDiscoveryTest, UnhappyPathGreetContextIsNull) {
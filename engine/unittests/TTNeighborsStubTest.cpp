@@ -1,11 +1,15 @@
 #include "TTNeighborsStub.hpp"
+#include "TTNeighborsIdentity.hpp"
 #include "TTNeighborsChatStubMock.hpp"
 #include "TTNeighborsDiscoveryStubMock.hpp"
+#include "TTNeighborsChatStreamMock.hpp"
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <thread>
 
 using ::testing::_;
 using ::testing::Return;
+using ::testing::InSequence;
 
 TEST(TTNeighborsStubTest, HappyPathSendTell) {
     const TTTellRequest request("5ef885a", "Hello world!");
@@ -14,6 +18,8 @@ TEST(TTNeighborsStubTest, HappyPathSendTell) {
         .Times(1)
         .WillOnce([&](::grpc::ClientContext* context, const ::tt::TellRequest& request, ::tt::TellReply* response){
             if (context) {
+                // Unreachable neighbor does not block the caller forever
+                EXPECT_LT(context->deadline(), std::chrono::system_clock::now() + std::chrono::seconds(10));
                 response->set_identity(request.identity());
                 return grpc::Status();
             }
@@ -37,6 +43,47 @@ TEST(TTNeighborsStubTest, UnhappyPathSendTell) {
     EXPECT_FALSE(response.status);
 }
 
+TEST(TTNeighborsStubTest, HappyPathSendTellPackedIdentity) {
+    const std::string identity = "a94a8fe5ccb19ba61c4c0873d391e987982fbbd3";
+    const TTTellRequest request(identity, "Hello world!");
+    TTNeighborsChatStubMock chatStub({});
+    EXPECT_CALL(chatStub, Tell(_, _, _))
+        .Times(1)
+        .WillOnce([&](::grpc::ClientContext* context, const ::tt::TellRequest& request, ::tt::TellReply* response){
+            // SHA-1 identity is sent as 20 raw bytes
+            EXPECT_TRUE(request.identity().empty());
+            EXPECT_EQ(request.key().size(), 20);
+            EXPECT_EQ(TTNeighborsIdentity::unpack(TTNeighborsIdentity::get(request)), identity);
+            return grpc::Status();
+        });
+    TTNeighborsStub stub;
+    EXPECT_TRUE(stub.sendTell(chatStub, request).status);
+}
+
+TEST(TTNeighborsStubTest, HappyPathSendTellCompressedAboveThreshold) {
+    const TTTellRequest smallRequest("5ef885a", std::string(TT_COMPRESSION_THRESHOLD - 1, 'x'));
+    const TTTellRequest largeRequest("5ef885a", std::string(TT_COMPRESSION_THRESHOLD, 'x'));
+    TTNeighborsChatStubMock chatStub({});
+    {
+        InSequence __;
+        EXPECT_CALL(chatStub, Tell(_, _, _))
+            .Times(1)
+            .WillOnce([&](::grpc::ClientContext* context, const ::tt::TellRequest& request, ::tt::TellReply* response){
+                EXPECT_EQ(context->compression_algorithm(), GRPC_COMPRESS_NONE);
+                return grpc::Status();
+            });
+        EXPECT_CALL(chatStub, Tell(_, _, _))
+            .Times(1)
+            .WillOnce([&](::grpc::ClientContext* context, const ::tt::TellRequest& request, ::tt::TellReply* response){
+                EXPECT_EQ(context->compression_algorithm(), TT_COMPRESSION_ALGORITHM);
+                return grpc::Status();
+            });
+    }
+    TTNeighborsStub stub;
+    EXPECT_TRUE(stub.sendTell(chatStub, smallRequest).status);
+    EXPECT_TRUE(stub.sendTell(chatStub, largeRequest).status);
+}
+
 class ClientWriterInterfaceNarrateRequest : public ::grpc::ClientWriterInterface<::tt::NarrateRequest> {
 public:
     MOCK_METHOD(bool, Write, (const ::tt::NarrateRequest& msg, grpc::WriteOptions options), (override));
@@ -57,8 +104,8 @@ TEST(TTNeighborsStubTest, HappyPathSendNarrate) {
     tt::NarrateRequest request1;
     request1.set_identity(identity);
     request1.set_message(message1);
+    // Identity is sent with the first request of the stream only
     tt::NarrateRequest request2;
-    request2.set_identity(identity);
     request2.set_message(message2);
     const TTNarrateRequest request(identity, {message1, message2});
     auto cwinr = std::make_unique<ClientWriterInterfaceNarrateRequest>();
@@ -80,6 +127,7 @@ TEST(TTNeighborsStubTest, HappyPathSendNarrate) {
         .WillOnce([&](::grpc::ClientContext* context, ::tt::NarrateReply* response){
             ClientWriterInterfaceNarrateRequest* result = nullptr;
             if (context) {
+                EXPECT_LT(context->deadline(), std::chrono::system_clock::now() + std::chrono::seconds(10));
                 result = cwinr.release();
             }
             return result;
@@ -110,8 +158,8 @@ TEST(TTNeighborsStubTest, UnhappyPathSendNarrateFailedToWrite) {
     tt::NarrateRequest request1;
     request1.set_identity(identity);
     request1.set_message(message1);
+    // Identity is sent with the first request of the stream only
     tt::NarrateRequest request2;
-    request2.set_identity(identity);
     request2.set_message(message2);
     const TTNarrateRequest request(identity, {message1, message2});
     auto cwinr = std::make_unique<ClientWriterInterfaceNarrateRequest>();
@@ -143,8 +191,8 @@ TEST(TTNeighborsStubTest, UnhappyPathSendNarrateFailedToFinish) {
     tt::NarrateRequest request1;
     request1.set_identity(identity);
     request1.set_message(message1);
+    // Identity is sent with the first request of the stream only
     tt::NarrateRequest request2;
-    request2.set_identity(identity);
     request2.set_message(message2);
     const TTNarrateRequest request(identity, {message1, message2});
     auto cwinr = std::make_unique<ClientWriterInterfaceNarrateRequest>();
@@ -185,6 +233,10 @@ TEST(TTNeighborsStubTest, HappyPathSendGreet) {
                 response->set_nickname(request.nickname());
                 response->set_identity(request.identity());
                 response->set_ipaddressandport(request.ipaddressandport());
+                auto* peer = response->add_peers();
+                peer->set_nickname("Oak");
+                peer->set_identity("14eeffe");
+                peer->set_ipaddressandport("192.168.1.9:88");
                 return grpc::Status();
             }
             return grpc::Status(grpc::INVALID_ARGUMENT, "Context is null!");
@@ -195,6 +247,7 @@ TEST(TTNeighborsStubTest, HappyPathSendGreet) {
     EXPECT_EQ(response.nickname, request.nickname);
     EXPECT_EQ(response.identity, request.identity);
     EXPECT_EQ(response.ipAddressAndPort, request.ipAddressAndPort);
+    EXPECT_EQ(response.peers, (std::deque<TTPeer>{{"Oak", "14eeffe", "192.168.1.9:88"}}));
 }
 
 TEST(TTNeighborsStubTest, UnhappyPathSendGreet) {
@@ -210,6 +263,18 @@ TEST(TTNeighborsStubTest, UnhappyPathSendGreet) {
     EXPECT_FALSE(response.status);
 }
 
+TEST(TTNeighborsStubTest, UnhappyPathSendGreetsCallNotStarted) {
+    TTNeighborsDiscoveryStubMock discoveryStub({});
+    EXPECT_CALL(discoveryStub, AsyncGreetRaw(_, _, _))
+        .Times(2)
+        .WillRepeatedly(Return(nullptr));
+    TTNeighborsStub stub;
+    const auto responses = stub.sendGreets({discoveryStub, discoveryStub}, TTGreetRequest("adriqun", "5ef885a", "192.168.1.8:88"));
+    ASSERT_EQ(responses.size(), 2);
+    EXPECT_FALSE(responses[0].status);
+    EXPECT_FALSE(responses[1].status);
+}
+
 TEST(TTNeighborsStubTest, HappyPathSendHeartbeat) {
     const TTHeartbeatRequest request("5ef885a");
     TTNeighborsDiscoveryStubMock discoveryStub({});
@@ -228,6 +293,36 @@ TEST(TTNeighborsStubTest, HappyPathSendHeartbeat) {
     EXPECT_EQ(response.identity, request.identity);
 }
 
+TEST(TTNeighborsStubTest, HappyPathSendHeartbeatPackedIdentities) {
+    const std::string identity = "a94a8fe5ccb19ba61c4c0873d391e987982fbbd3";
+    const std::string target = "0feca8420feca8420feca8420feca8420feca842";
+    const TTHeartbeatRequest request(identity, {TTMemberUpdate(target, 1, false)}, target);
+    TTNeighborsDiscoveryStubMock discoveryStub({});
+    EXPECT_CALL(discoveryStub, Heartbeat(_, _, _))
+        .Times(1)
+        .WillOnce([&](::grpc::ClientContext* context, const ::tt::HeartbeatRequest& request, ::tt::HeartbeatReply* response){
+            // Target and member updates are sent as 20 raw bytes as well
+            EXPECT_TRUE(request.target().empty());
+            EXPECT_EQ(request.targetkey(), TTNeighborsIdentity::pack(target));
+            EXPECT_EQ(request.updates_size(), 1);
+            EXPECT_TRUE(request.updates(0).identity().empty());
+            EXPECT_EQ(request.updates(0).key(), TTNeighborsIdentity::pack(target));
+            response->set_key(request.key());
+            auto* member = response->add_updates();
+            member->set_key(request.updates(0).key());
+            member->set_incarnation(2);
+            member->set_alive(true);
+            return grpc::Status();
+        });
+    TTNeighborsStub stub;
+    const auto response = stub.sendHeartbeat(discoveryStub, request);
+    EXPECT_TRUE(response.status);
+    // Reply is not unpacked, contacts and membership resolve the key as it is
+    EXPECT_EQ(response.identity, TTNeighborsIdentity::pack(identity));
+    ASSERT_EQ(response.updates.size(), 1);
+    EXPECT_EQ(response.updates.front(), TTMemberUpdate(TTNeighborsIdentity::pack(target).value(), 2, true));
+}
+
 TEST(TTNeighborsStubTest, UnhappyPathSendHeartbeat) {
     const TTHeartbeatRequest request("5ef885a");
     TTNeighborsDiscoveryStubMock discoveryStub({});
@@ -240,3 +335,190 @@ TEST(TTNeighborsStubTest, UnhappyPathSendHeartbeat) {
     const auto response = stub.sendHeartbeat(discoveryStub, request);
     EXPECT_FALSE(response.status);
 }
+
+TEST(TTNeighborsStubTest, UnhappyPathSendHeartbeatsCallNotStarted) {
+    TTNeighborsDiscoveryStubMock discoveryStub({});
+    EXPECT_CALL(discoveryStub, AsyncHeartbeatRaw(_, _, _))
+        .Times(2)
+        .WillRepeatedly(Return(nullptr));
+    TTNeighborsStub stub;
+    const auto responses = stub.sendHeartbeats({discoveryStub, discoveryStub}, TTHeartbeatRequest("5ef885a"));
+    ASSERT_EQ(responses.size(), 2);
+    EXPECT_FALSE(responses[0].status);
+    EXPECT_FALSE(responses[1].status);
+}
+
+TEST(TTNeighborsStubTest, HappyPathChannelSharedByChatAndDiscovery) {
+    TTNeighborsStub stub;
+    const auto channel1 = stub.getChannel("192.168.1.74:17888");
+    const auto channel2 = stub.getChannel("192.168.1.74:17888");
+    const auto channel3 = stub.getChannel("192.168.1.75:17888");
+    EXPECT_EQ(channel1, channel2);
+    EXPECT_NE(channel1, channel3);
+    EXPECT_TRUE(stub.createChatStub("192.168.1.74:17888"));
+    EXPECT_TRUE(stub.createDiscoveryStub("192.168.1.74:17888"));
+    EXPECT_EQ(channel1.use_count(), 3);
+}
+
+TEST(TTNeighborsStubTest, HappyPathChannelEvictedWhenIdle) {
+    TTNeighborsStub stub(std::chrono::milliseconds{50});
+    std::weak_ptr<grpc::Channel> unused = stub.getChannel("192.168.1.74:17888");
+    const auto used = stub.getChannel("192.168.1.75:17888");
+    std::this_thread::sleep_for(std::chrono::milliseconds{100});
+    const auto other = stub.getChannel("192.168.1.76:17888");
+    EXPECT_TRUE(unused.expired());
+    EXPECT_EQ(stub.getChannel("192.168.1.75:17888"), used);
+}
+
+TEST(TTNeighborsStubTest, HappyPathSendConverse) {
+    const TTConverseRequest request("5ef885a", {"Hello ", "world", std::string(TT_COMPRESSION_THRESHOLD, '!')}, 7, 1);
+    auto stream = std::make_unique<TTNeighborsChatStreamMock>();
+    {
+        InSequence __;
+        for (size_t i = 0; i < request.messages.size(); ++i) {
+            EXPECT_CALL(*stream, Write(_, _))
+                .Times(1)
+                .WillOnce([&, i](const ::tt::ConverseRequest& msg, ::grpc::WriteOptions options) {
+                    // Identity is sent with the first request of the stream only
+                    EXPECT_EQ(msg.identity(), i == 0 ? request.identity : "");
+                    EXPECT_EQ(msg.message(), request.messages[i]);
+                    EXPECT_EQ(msg.epoch(), request.epoch);
+                    EXPECT_EQ(msg.sequence(), i + 1);
+                    EXPECT_EQ(options.get_buffer_hint(), i + 1 < request.messages.size());
+                    EXPECT_EQ(options.get_no_compression(), i + 1 < request.messages.size());
+                    return true;
+                });
+        }
+        // Cumulative acknowledgement
+        EXPECT_CALL(*stream, Read(_))
+            .Times(1)
+            .WillOnce([](::tt::ConverseReply* msg) {
+                msg->set_sequence(3);
+                return true;
+            });
+        EXPECT_CALL(*stream, Finish())
+            .Times(1)
+            .WillOnce(Return(grpc::Status()));
+    }
+    TTNeighborsChatStubMock chatStub({});
+    EXPECT_CALL(chatStub, ConverseRaw(_))
+        .Times(1)
+        .WillOnce([&](::grpc::ClientContext* context) {
+            EXPECT_EQ(context->compression_algorithm(), TT_COMPRESSION_ALGORITHM);
+            return stream.release();
+        });
+    TTNeighborsStub stub;
+    auto chatStream = stub.createChatStream(chatStub);
+    ASSERT_TRUE(chatStream);
+    const auto response = stub.sendConverse(*chatStream, request);
+    EXPECT_TRUE(response.status);
+    EXPECT_EQ(response.acknowledged, 3);
+}
+
+TEST(TTNeighborsStubTest, UnhappyPathSendConverseBrokenStream) {
+    const TTConverseRequest request("5ef885a", {"Hello ", "world", "!"}, 7, 1);
+    auto stream = std::make_unique<TTNeighborsChatStreamMock>();
+    EXPECT_CALL(*stream, Write(_, _))
+        .Times(3)
+        .WillRepeatedly(Return(true));
+    {
+        InSequence __;
+        EXPECT_CALL(*stream, Read(_))
+            .Times(1)
+            .WillOnce([](::tt::ConverseReply* msg) {
+                msg->set_sequence(1);
+                return true;
+            });
+        EXPECT_CALL(*stream, Read(_))
+            .Times(1)
+            .WillOnce(Return(false));
+    }
+    EXPECT_CALL(*stream, Finish())
+        .Times(1)
+        .WillOnce(Return(grpc::Status(grpc::UNAVAILABLE, "?")));
+    TTNeighborsChatStubMock chatStub({});
+    EXPECT_CALL(chatStub, ConverseRaw(_))
+        .Times(1)
+        .WillOnce([&](::grpc::ClientContext* context) { return stream.release(); });
+    TTNeighborsStub stub;
+    auto chatStream = stub.createChatStream(chatStub);
+    ASSERT_TRUE(chatStream);
+    const auto response = stub.sendConverse(*chatStream, request);
+    EXPECT_FALSE(response.status);
+    EXPECT_EQ(response.acknowledged, 1);
+}
+
+TEST(TTNeighborsStubTest, UnhappyPathSendConverseAcknowledgementTimedOut) {
+    const TTConverseRequest request("5ef885a", {"Hello ", "world", "!"}, 7, 1);
+    TTUniqueChatStream chatStream;
+    auto stream = std::make_unique<TTNeighborsChatStreamMock>();
+    EXPECT_CALL(*stream, Write(_, _))
+        .Times(3)
+        .WillRepeatedly(Return(true));
+    // Neighbor never acknowledges, read fails only once the stream is cancelled
+    EXPECT_CALL(*stream, Read(_))
+        .Times(1)
+        .WillOnce([&](::tt::ConverseReply* msg) {
+            while (!chatStream->cancelled()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            }
+            return false;
+        });
+    EXPECT_CALL(*stream, Finish())
+        .Times(1)
+        .WillOnce(Return(grpc::Status(grpc::CANCELLED, "?")));
+    TTNeighborsChatStubMock chatStub({});
+    EXPECT_CALL(chatStub, ConverseRaw(_))
+        .Times(1)
+        .WillOnce([&](::grpc::ClientContext* context) { return stream.release(); });
+    TTNeighborsStub stub;
+    chatStream = stub.createChatStream(chatStub);
+    ASSERT_TRUE(chatStream);
+    const auto start = std::chrono::steady_clock::now();
+    const auto response = stub.sendConverse(*chatStream, request);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds{5});
+    EXPECT_FALSE(response.status);
+    EXPECT_EQ(response.acknowledged, 0);
+}
+
+TEST(TTNeighborsStubTest, HappyPathSendConverseAcknowledgedStreamIsNotCancelled) {
+    const TTConverseRequest request("5ef885a", {"Hello ", "world"}, 7, 1);
+    auto stream = std::make_unique<TTNeighborsChatStreamMock>();
+    EXPECT_CALL(*stream, Write(_, _))
+        .Times(4)
+        .WillRepeatedly(Return(true));
+    EXPECT_CALL(*stream, Read(_))
+        .Times(2)
+        .WillOnce([](::tt::ConverseReply* msg) {
+            msg->set_sequence(2);
+            return true;
+        })
+        .WillOnce([](::tt::ConverseReply* msg) {
+            msg->set_sequence(4);
+            return true;
+        });
+    EXPECT_CALL(*stream, Finish())
+        .Times(1)
+        .WillOnce(Return(grpc::Status()));
+    TTNeighborsChatStubMock chatStub({});
+    EXPECT_CALL(chatStub, ConverseRaw(_))
+        .Times(1)
+        .WillOnce([&](::grpc::ClientContext*) { return stream.release(); });
+    TTNeighborsStub stub;
+    auto chatStream = stub.createChatStream(chatStub);
+    ASSERT_TRUE(chatStream);
+    // Both exchanges share the stub watchdog, disarmed stream outlives the deadline untouched
+    EXPECT_TRUE(stub.sendConverse(*chatStream, request).status);
+    EXPECT_TRUE(stub.sendConverse(*chatStream, TTConverseRequest("5ef885a", {"Hello ", "world"}, 7, 3)).status);
+    std::this_thread::sleep_for(std::chrono::milliseconds{2500});
+    EXPECT_FALSE(chatStream->cancelled());
+}
+
+TEST(TTNeighborsStubTest, UnhappyPathCreateChatStreamFailed) {
+    TTNeighborsChatStubMock chatStub({});
+    EXPECT_CALL(chatStub, ConverseRaw(_))
+        .Times(1)
+        .WillOnce([&](::grpc::ClientContext* context) { return static_cast<TTNeighborsChatStreamMock*>(nullptr); });
+    TTNeighborsStub stub;
+    EXPECT_FALSE(stub.createChatStream(chatStub));
+}
@@ -0,0 +1,101 @@
+#include "TTNeighborsSweep.hpp"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using ::testing::ThrowsMessage;
+using ::testing::HasSubstr;
+
+class TTNeighborsSweepTest : public ::testing::Test {
+protected:
+    // Listens on loopback only, other loopback addresses refuse connection
+    virtual void SetUp() override {
+        mSocket = socket(AF_INET, SOCK_STREAM, 0);
+        ASSERT_GE(mSocket, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = 0;
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+        ASSERT_EQ(bind(mSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+        ASSERT_EQ(listen(mSocket, 16), 0);
+        socklen_t length = sizeof(address);
+        ASSERT_EQ(getsockname(mSocket, reinterpret_cast<sockaddr*>(&address), &length), 0);
+        mPort = std::to_string(ntohs(address.sin_port));
+    }
+    virtual void TearDown() override {
+        close(mSocket);
+    }
+    int mSocket = -1;
+    std::string mPort;
+    const std::function<bool()> mRunning = []() { return false; };
+};
+
+TEST_F(TTNeighborsSweepTest, HappyPathSubnetIsSubnet) {
+    EXPECT_TRUE(TTNeighborsSweep::isSubnet("10.0.0.0/22"));
+    EXPECT_TRUE(TTNeighborsSweep::isSubnet("10.0.0.7/32"));
+    EXPECT_TRUE(TTNeighborsSweep::isSubnet("192.168.0.0/16"));
+    EXPECT_FALSE(TTNeighborsSweep::isSubnet("10.0.0.0/8"));
+    EXPECT_FALSE(TTNeighborsSweep::isSubnet("10.0.0.0/33"));
+    EXPECT_FALSE(TTNeighborsSweep::isSubnet("10.0.0.0"));
+    EXPECT_FALSE(TTNeighborsSweep::isSubnet("10.0.0/24"));
+}
+
+TEST_F(TTNeighborsSweepTest, HappyPathNetworkBroadcastAndHostAddressesSkipped) {
+    TTNeighborsSweep sweep({"10.0.0.0/22", "10.0.0.0/24", "172.16.4.1/32"}, mPort, "10.0.0.5");
+    // 1022 hosts (overlapping range counted once) without host itself, single address range
+    EXPECT_EQ(sweep.size(), 1022);
+}
+
+TEST_F(TTNeighborsSweepTest, HappyPathListeningHostFoundOthersBackedOff) {
+    TTNeighborsSweep sweep({"127.0.0.0/30"}, mPort, "192.168.1.1");
+    ASSERT_EQ(sweep.size(), 2);
+    const auto start = std::chrono::steady_clock::now();
+    const auto reachable = sweep.sweep(mRunning);
+    ASSERT_EQ(reachable.size(), 1);
+    EXPECT_EQ(reachable[0], "127.0.0.1:" + mPort);
+    // Refused address is due after backoff, nothing is due now
+    EXPECT_GT(sweep.deadline(), start + std::chrono::milliseconds{1000});
+    EXPECT_TRUE(sweep.sweep(mRunning).empty());
+    sweep.resolve(reachable[0]);
+    EXPECT_EQ(sweep.size(), 1);
+}
+
+TEST_F(TTNeighborsSweepTest, HappyPathBackoffDoubles) {
+    TTNeighborsSweep sweep({"127.0.0.1/32"}, mPort, "192.168.1.1");
+    const auto reachable = sweep.sweep(mRunning);
+    ASSERT_EQ(reachable.size(), 1);
+    // Greet failed, address is probed again later, each time later
+    sweep.backoff(reachable[0]);
+    const auto first = sweep.deadline() - std::chrono::steady_clock::now();
+    sweep.backoff(reachable[0]);
+    const auto second = sweep.deadline() - std::chrono::steady_clock::now();
+    EXPECT_GT(first, std::chrono::milliseconds{1000});
+    EXPECT_GT(second, first + std::chrono::milliseconds{1000});
+}
+
+TEST_F(TTNeighborsSweepTest, HappyPathStoppedSweepProbesNothing) {
+    TTNeighborsSweep sweep({"127.0.0.0/30"}, mPort, "192.168.1.1");
+    EXPECT_TRUE(sweep.sweep([]() { return true; }).empty());
+    EXPECT_LE(sweep.deadline(), std::chrono::steady_clock::now());
+}
+
+TEST_F(TTNeighborsSweepTest, UnhappyPathInvalidSubnet) {
+    EXPECT_THAT([&]() { TTNeighborsSweep({"10.0.0.0/8"}, mPort, "192.168.1.1"); },
+        ThrowsMessage<std::runtime_error>(HasSubstr("TTNeighborsSweep: Invalid subnet=10.0.0.0/8")));
+    EXPECT_THAT([&]() { TTNeighborsSweep({"10.0.0.0/24"}, "port", "192.168.1.1"); },
+        ThrowsMessage<std::runtime_error>(HasSubstr("TTNeighborsSweep: Invalid port=port")));
+}
+
+TEST_F(TTNeighborsSweepTest, HappyPathSubnetSweptWithinSecondsAtLimitedRate) {
+    TTNeighborsSweep sweep({"127.0.0.0/22"}, mPort, "192.168.1.1");
+    const auto start = std::chrono::steady_clock::now();
+    const auto reachable = sweep.sweep(mRunning);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    ASSERT_EQ(reachable.size(), 1);
+    // 1022 connects at 1000 connects per second
+    EXPECT_GT(elapsed, std::chrono::milliseconds{900});
+    EXPECT_LT(elapsed, std::chrono::milliseconds{3000});
+}
@@ -0,0 +1,363 @@
+#include "TTServer.hpp"
+#include "TTBroadcasterChatMock.hpp"
+#include "TTBroadcasterDiscoveryMock.hpp"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <atomic>
+#include <thread>
+
+using ::testing::Test;
+using ::testing::Return;
+using ::testing::_;
+
+class TTServerTest : public Test {
+protected:
+    TTServerTest() :
+        mServiceChat(mBroadcasterChat),
+        mServiceDiscovery(mBroadcasterDiscovery) {}
+
+    std::unique_ptr<tt::NeighborsChat::Stub> CreateChatStub() {
+        return tt::NeighborsChat::NewStub(grpc::CreateChannel(mIpAddressAndPort, grpc::InsecureChannelCredentials()));
+    }
+
+    std::unique_ptr<tt::NeighborsDiscovery::Stub> CreateDiscoveryStub() {
+        return tt::NeighborsDiscovery::NewStub(grpc::CreateChannel(mIpAddressAndPort, grpc::InsecureChannelCredentials()));
+    }
+
+    void SetDeadline(grpc::ClientContext& context) {
+        context.set_deadline(std::chrono::system_clock::now() + std::chrono::milliseconds(3000));
+        context.set_wait_for_ready(true);
+    }
+
+    const std::string mIpAddressAndPort = "127.0.0.1:47817";
+    const std::string mHostIdentity = "6e6e6e6";
+    TTBroadcasterChatMock mBroadcasterChat;
+    TTBroadcasterDiscoveryMock mBroadcasterDiscovery;
+    TTNeighborsServiceChat mServiceChat;
+    TTNeighborsServiceDiscovery mServiceDiscovery;
+};
+
+TEST_F(TTServerTest, HappyPathSyncTell) {
+    const TTTellRequest expectedRequest("5e5fe55f", "Hello world!");
+    EXPECT_CALL(mBroadcasterChat, handleReceive(expectedRequest))
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(mBroadcasterChat, getIdentity())
+        .Times(1)
+        .WillOnce(Return(mHostIdentity));
+    TTServer server(mIpAddressAndPort, mServiceChat, mServiceDiscovery, 0);
+    std::thread loop(&TTServer::run, &server);
+    grpc::ClientContext context;
+    SetDeadline(context);
+    tt::TellRequest request;
+    request.set_identity(expectedRequest.identity);
+    request.set_message(expectedRequest.message);
+    tt::TellReply reply;
+    EXPECT_TRUE(CreateChatStub()->Tell(&context, request, &reply).ok());
+    EXPECT_EQ(reply.identity(), mHostIdentity);
+    server.stop();
+    loop.join();
+    EXPECT_TRUE(server.isStopped());
+}
+
+TEST_F(TTServerTest, HappyPathAsyncTell) {
+    const TTTellRequest expectedRequest("5e5fe55f", "Hello world!");
+    EXPECT_CALL(mBroadcasterChat, handleReceive(expectedRequest))
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(mBroadcasterChat, getIdentity())
+        .Times(1)
+        .WillOnce(Return(mHostIdentity));
+    TTServer server(mIpAddressAndPort, mServiceChat, mServiceDiscovery, 2);
+    std::thread loop(&TTServer::run, &server);
+    grpc::ClientContext context;
+    SetDeadline(context);
+    tt::TellRequest request;
+    request.set_identity(expectedRequest.identity);
+    request.set_message(expectedRequest.message);
+    tt::TellReply reply;
+    EXPECT_TRUE(CreateChatStub()->Tell(&context, request, &reply).ok());
+    EXPECT_EQ(reply.identity(), mHostIdentity);
+    server.stop();
+    loop.join();
+    EXPECT_TRUE(server.isStopped());
+}
+
+TEST_F(TTServerTest, HappyPathAsyncNarrate) {
+    const TTNarrateRequest expectedRequest("5e5fe55f", {"Hello", "world", "!"});
+    EXPECT_CALL(mBroadcasterChat, handleReceive(expectedRequest))
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(mBroadcasterChat, getIdentity())
+        .Times(1)
+        .WillOnce(Return(mHostIdentity));
+    TTServer server(mIpAddressAndPort, mServiceChat, mServiceDiscovery, 2);
+    std::thread loop(&TTServer::run, &server);
+    grpc::ClientContext context;
+    SetDeadline(context);
+    tt::NarrateReply reply;
+    auto stub = CreateChatStub();
+    auto writer = stub->Narrate(&context, &reply);
+    for (const auto& message : expectedRequest.messages) {
+        tt::NarrateRequest request;
+        request.set_identity(expectedRequest.identity);
+        request.set_message(message);
+        EXPECT_TRUE(writer->Write(request));
+    }
+    EXPECT_TRUE(writer->WritesDone());
+    EXPECT_TRUE(writer->Finish().ok());
+    EXPECT_EQ(reply.identity(), mHostIdentity);
+    server.stop();
+    loop.join();
+    EXPECT_TRUE(server.isStopped());
+}
+
+TEST_F(TTServerTest, UnhappyPathAsyncNarrateHandlerFailed) {
+    EXPECT_CALL(mBroadcasterChat, handleReceive(TTNarrateRequest("5e5fe55f", {"Hello"})))
+        .Times(1)
+        .WillOnce(Return(false));
+    TTServer server(mIpAddressAndPort, mServiceChat, mServiceDiscovery, 1);
+    std::thread loop(&TTServer::run, &server);
+    grpc::ClientContext context;
+    SetDeadline(context);
+    tt::NarrateReply reply;
+    auto stub = CreateChatStub();
+    auto writer = stub->Narrate(&context, &reply);
+    tt::NarrateRequest request;
+    request.set_identity("5e5fe55f");
+    request.set_message("Hello");
+    EXPECT_TRUE(writer->Write(request));
+    EXPECT_TRUE(writer->WritesDone());
+    EXPECT_FALSE(writer->Finish().ok());
+    server.stop();
+    loop.join();
+    EXPECT_TRUE(server.isStopped());
+}
+
+TEST_F(TTServerTest, HappyPathAsyncGreetAndHeartbeats) {
+    const size_t heartbeats = 32;
+    EXPECT_CALL(mBroadcasterDiscovery, handleGreet(TTGreetRequest("John", "5e5fe55f", "127.0.0.1:47818")))
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(mBroadcasterDiscovery, handleHeartbeat(TTHeartbeatRequest("5e5fe55f")))
+        .Times(heartbeats)
+        .WillRepeatedly(Return(true));
+    EXPECT_CALL(mBroadcasterDiscovery, getNickname())
+        .WillRepeatedly(Return("Gabrielle"));
+    EXPECT_CALL(mBroadcasterDiscovery, getIdentity())
+        .WillRepeatedly(Return(mHostIdentity));
+    EXPECT_CALL(mBroadcasterDiscovery, getIpAddressAndPort())
+        .WillRepeatedly(Return(mIpAddressAndPort));
+    TTServer server(mIpAddressAndPort, mServiceChat, mServiceDiscovery, 4);
+    std::thread loop(&TTServer::run, &server);
+    auto stub = CreateDiscoveryStub();
+    {
+        grpc::ClientContext context;
+        SetDeadline(context);
+        tt::GreetRequest request;
+        request.set_nickname("John");
+        request.set_identity("5e5fe55f");
+        request.set_ipaddressandport("127.0.0.1:47818");
+        tt::GreetReply reply;
+        EXPECT_TRUE(stub->Greet(&context, request, &reply).ok());
+        EXPECT_EQ(reply.nickname(), "Gabrielle");
+        EXPECT_EQ(reply.identity(), mHostIdentity);
+        EXPECT_EQ(reply.ipaddressandport(), mIpAddressAndPort);
+    }
+    std::vector<std::thread> clients;
+    for (size_t i = 0; i < heartbeats; ++i) {
+        clients.emplace_back([&]() {
+            grpc::ClientContext context;
+            SetDeadline(context);
+            tt::HeartbeatRequest request;
+            request.set_identity("5e5fe55f");
+            tt::HeartbeatReply reply;
+            EXPECT_TRUE(stub->Heartbeat(&context, request, &reply).ok());
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    server.stop();
+    loop.join();
+    EXPECT_TRUE(server.isStopped());
+}
+
+TEST_F(TTServerTest, HappyPathAsyncStopWithoutRun) {
+    TTServer server(mIpAddressAndPort, mServiceChat, mServiceDiscovery, 2);
+    EXPECT_FALSE(server.isStopped());
+    server.stop();
+    EXPECT_TRUE(server.isStopped());
+}
+
+TEST_F(TTServerTest, HappyPathAsyncConverse) {
+    const std::deque<std::string> messages = {"Hello", "world", "!"};
+    for (size_t i = 0; i < 2 * messages.size(); ++i) {
+        EXPECT_CALL(mBroadcasterChat, handleReceive(TTTellRequest("5e5fe55f", messages[i % messages.size()], 7, i + 1)))
+            .Times(1)
+            .WillOnce(Return(true));
+    }
+    EXPECT_CALL(mBroadcasterChat, getIdentity())
+        .WillRepeatedly(Return(mHostIdentity));
+    TTServer server(mIpAddressAndPort, mServiceChat, mServiceDiscovery, 2);
+    std::thread loop(&TTServer::run, &server);
+    auto stub = CreateChatStub();
+    TTNeighborsStub neighborsStub;
+    auto stream = neighborsStub.createChatStream(*stub);
+    ASSERT_TRUE(stream);
+    // Stream stays open between batches
+    for (size_t i = 0; i < 2; ++i) {
+        const auto response = neighborsStub.sendConverse(*stream, TTConverseRequest("5e5fe55f", messages, 7, i * messages.size() + 1));
+        EXPECT_TRUE(response.status);
+        EXPECT_EQ(response.acknowledged, messages.size());
+    }
+    stream.reset();
+    server.stop();
+    loop.join();
+    EXPECT_TRUE(server.isStopped());
+}
+
+TEST_F(TTServerTest, HappyPathSyncConverse) {
+    EXPECT_CALL(mBroadcasterChat, handleReceive(TTTellRequest("5e5fe55f", "Hello")))
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(mBroadcasterChat, getIdentity())
+        .WillRepeatedly(Return(mHostIdentity));
+    TTServer server(mIpAddressAndPort, mServiceChat, mServiceDiscovery, 0);
+    std::thread loop(&TTServer::run, &server);
+    auto stub = CreateChatStub();
+    TTNeighborsStub neighborsStub;
+    auto stream = neighborsStub.createChatStream(*stub);
+    ASSERT_TRUE(stream);
+    const auto response = neighborsStub.sendConverse(*stream, TTConverseRequest("5e5fe55f", {"Hello"}));
+    EXPECT_TRUE(response.status);
+    EXPECT_EQ(response.acknowledged, 1);
+    stream.reset();
+    server.stop();
+    loop.join();
+    EXPECT_TRUE(server.isStopped());
+}
+
+TEST_F(TTServerTest, HappyPathConcurrentHeartbeats) {
+    const size_t neighbors = 8;
+    EXPECT_CALL(mBroadcasterDiscovery, handleHeartbeat(TTHeartbeatRequest("5e5fe55f")))
+        .Times(neighbors)
+        .WillRepeatedly(Return(true));
+    EXPECT_CALL(mBroadcasterDiscovery, getIdentity())
+        .WillRepeatedly(Return(mHostIdentity));
+    TTServer server(mIpAddressAndPort, mServiceChat, mServiceDiscovery, 2);
+    std::thread loop(&TTServer::run, &server);
+    TTNeighborsStub neighborsStub;
+    std::vector<TTUniqueDiscoveryStub> discoveryStubs;
+    std::vector<std::reference_wrapper<TTNeighborsDiscoveryStubIf>> stubs;
+    for (size_t i = 0; i < neighbors; ++i) {
+        discoveryStubs.push_back(CreateDiscoveryStub());
+        stubs.emplace_back(*discoveryStubs.back());
+    }
+    // Nobody listens there
+    discoveryStubs.push_back(neighborsStub.createDiscoveryStub("127.0.0.1:1"));
+    stubs.emplace_back(*discoveryStubs.back());
+    const auto responses = neighborsStub.sendHeartbeats(stubs, TTHeartbeatRequest("5e5fe55f"));
+    ASSERT_EQ(responses.size(), neighbors + 1);
+    for (size_t i = 0; i < neighbors; ++i) {
+        EXPECT_TRUE(responses[i].status);
+        EXPECT_EQ(responses[i].identity, mHostIdentity);
+    }
+    EXPECT_FALSE(responses.back().status);
+    server.stop();
+    loop.join();
+    EXPECT_TRUE(server.isStopped());
+}
+
+TEST_F(TTServerTest, HappyPathAsyncTellWhileHeartbeatsBlocked) {
+    const size_t heartbeats = 2;
+    const TTTellRequest expectedRequest("5e5fe55f", "Hello world!");
+    std::atomic<size_t> blocked{0};
+    std::atomic<bool> released{false};
+    EXPECT_CALL(mBroadcasterDiscovery, handleHeartbeat(TTHeartbeatRequest("5e5fe55f")))
+        .Times(heartbeats)
+        .WillRepeatedly([&](const TTHeartbeatRequest&) {
+            ++blocked;
+            while (!released.load()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            }
+            return true;
+        });
+    EXPECT_CALL(mBroadcasterDiscovery, getIdentity())
+        .WillRepeatedly(Return(mHostIdentity));
+    EXPECT_CALL(mBroadcasterChat, handleReceive(expectedRequest))
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(mBroadcasterChat, getIdentity())
+        .Times(1)
+        .WillOnce(Return(mHostIdentity));
+    // As many slow handlers as polling threads
+    TTServer server(mIpAddressAndPort, mServiceChat, mServiceDiscovery, heartbeats);
+    std::thread loop(&TTServer::run, &server);
+    auto discoveryStub = CreateDiscoveryStub();
+    std::vector<std::thread> clients;
+    for (size_t i = 0; i < heartbeats; ++i) {
+        clients.emplace_back([&]() {
+            grpc::ClientContext context;
+            SetDeadline(context);
+            tt::HeartbeatRequest request;
+            request.set_identity("5e5fe55f");
+            tt::HeartbeatReply reply;
+            EXPECT_TRUE(discoveryStub->Heartbeat(&context, request, &reply).ok());
+        });
+    }
+    while (blocked.load() < heartbeats) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    {
+        grpc::ClientContext context;
+        context.set_deadline(std::chrono::system_clock::now() + std::chrono::milliseconds(1000));
+        tt::TellRequest request;
+        request.set_identity(expectedRequest.identity);
+        request.set_message(expectedRequest.message);
+        tt::TellReply reply;
+        EXPECT_TRUE(CreateChatStub()->Tell(&context, request, &reply).ok());
+        EXPECT_EQ(reply.identity(), mHostIdentity);
+    }
+    released.store(true);
+    for (auto& client : clients) {
+        client.join();
+    }
+    server.stop();
+    loop.join();
+    EXPECT_TRUE(server.isStopped());
+}
+
+TEST_F(TTServerTest, HappyPathAsyncRunReturnsAfterRunningHandler) {
+    std::atomic<bool> running{false};
+    std::atomic<bool> completed{false};
+    EXPECT_CALL(mBroadcasterDiscovery, handleHeartbeat(TTHeartbeatRequest("5e5fe55f")))
+        .Times(1)
+        .WillOnce([&](const TTHeartbeatRequest&) {
+            running.store(true);
+            std::this_thread::sleep_for(std::chrono::milliseconds{500});
+            completed.store(true);
+            return true;
+        });
+    EXPECT_CALL(mBroadcasterDiscovery, getIdentity())
+        .WillRepeatedly(Return(mHostIdentity));
+    TTServer server(mIpAddressAndPort, mServiceChat, mServiceDiscovery, 2);
+    std::thread loop(&TTServer::run, &server);
+    std::thread client([&]() {
+        grpc::ClientContext context;
+        SetDeadline(context);
+        tt::HeartbeatRequest request;
+        request.set_identity("5e5fe55f");
+        tt::HeartbeatReply reply;
+        // Call is cancelled by the shutdown
+        CreateDiscoveryStub()->Heartbeat(&context, request, &reply);
+    });
+    while (!running.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    server.stop();
+    loop.join();
+    // Services might be destroyed once run returns
+    EXPECT_TRUE(completed.load());
+    client.join();
+}
@@ -18,6 +18,10 @@ void contactsSelection(size_t id) {
     std::cout << '#' << id << std::endl;
 }
 
+void chatPage(size_t page) {
+    std::cout << '^' << page << std::endl;
+}
+
 void signalInterruptHandler(int) {
     if (handler) {
         LOG_WARNING("Stopping due to caught signal!");
@@ -31,7 +35,7 @@ int main(int argc, char** argv) {
         signals.setup(signalInterruptHandler, { SIGINT, SIGTERM, SIGSTOP });
         // Run main app
         const TTTextBoxSettings settings(argc, argv);
-        handler = std::make_unique<TTTextBoxHandler>(settings, &messageSent, &contactsSelection);
+        handler = std::make_unique<TTTextBoxHandler>(settings, &messageSent, &contactsSelection, &chatPage);
         LOG_INFO("TextBox handler initialized");
         while (!handler->isStopped()) {
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
@@ -92,6 +92,7 @@ bool TTTextBox::execute(const std::vector<std::string>& args) {
         mOutputStream.print("Type #help to print a help message").endl();
         mOutputStream.print("Type #quit to quit the application").endl();
         mOutputStream.print("Type #select <id> to select contact").endl();
+        mOutputStream.print("Type #page <n> to show older messages (0 is the latest page)").endl();
         mOutputStream.print("Skip # and send a message to the currently selected contact.").endl();
         return true;
     }
@@ -110,26 +111,30 @@ bool TTTextBox::execute(const std::vector<std::string>& args) {
             LOG_WARNING("Received \"{}\" command with invalid number of arguments!", command);
             return false;
         }
-        auto identity = args[1];
-        if (!std::all_of(identity.begin(), identity.end(), ::isdigit)) {
-            LOG_WARNING("Contacts selection attempt failed - string has characters other than digits!");
+        size_t id = 0;
+        if (!toNumber(args[1], id)) {
+            LOG_WARNING("Contacts selection attempt failed!");
             return false;
         }
+        auto message = std::make_unique<TTTextBoxMessage>(TTTextBoxStatus::CONTACTS_SELECT, sizeof(id), reinterpret_cast<char*>(&id));
+        queue(std::move(message));
+        LOG_INFO("Successfully selected contact!");
+        return true;
+    }
 
-        if (identity.size() > TTTextBoxMessage::DATA_MAX_DIGITS) {
-            LOG_WARNING("Contacts selection attempt failed - too many digits!");
+    if (command == "page") {
+        if (args.size() != 2) {
+            LOG_WARNING("Received \"{}\" command with invalid number of arguments!", command);
             return false;
         }
-
-        size_t id = 0;
-        auto [ptr, ec] = std::from_chars(identity.c_str(), identity.c_str() + identity.size(), id);
-        if (ec != std::errc()) {
-            LOG_ERROR("Failed to convert string to decimal on contacts selection attempt!");
+        size_t page = 0;
+        if (!toNumber(args[1], page)) {
+            LOG_WARNING("Chat page attempt failed!");
             return false;
         }
-        auto message = std::make_unique<TTTextBoxMessage>(TTTextBoxStatus::CONTACTS_SELECT, sizeof(id), reinterpret_cast<char*>(&id));
+        auto message = std::make_unique<TTTextBoxMessage>(TTTextBoxStatus::CHAT_PAGE, sizeof(page), reinterpret_cast<char*>(&page));
         queue(std::move(message));
-        LOG_INFO("Successfully selected contact!");
+        LOG_INFO("Successfully requested chat page!");
         return true;
     }
 
@@ -137,6 +142,25 @@ bool TTTextBox::execute(const std::vector<std::string>& args) {
     return false;
 }
 
+bool TTTextBox::toNumber(const std::string& arg, size_t& number) const {
+    if (!std::all_of(arg.begin(), arg.end(), ::isdigit)) {
+        LOG_WARNING("Argument has characters other than digits!");
+        return false;
+    }
+
+    if (arg.size() > TTTextBoxMessage::DATA_MAX_DIGITS) {
+        LOG_WARNING("Argument has too many digits!");
+        return false;
+    }
+
+    auto [ptr, ec] = std::from_chars(arg.c_str(), arg.c_str() + arg.size(), number);
+    if (ec != std::errc()) {
+        LOG_ERROR("Failed to convert argument to decimal!");
+        return false;
+    }
+    return true;
+}
+
 bool TTTextBox::send(const char* cbegin, const char* cend) {
     LOG_INFO("Received casual message from the input");
     LOG_INFO("Splitting string into smaller chunks...");
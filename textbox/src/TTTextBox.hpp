@@ -27,6 +27,8 @@ private:
     bool parse(const std::string& line);
     // Executes command
     bool execute(const std::vector<std::string>& args);
+    // Converts command argument to decimal number
+    bool toNumber(const std::string& arg, size_t& number) const;
     // Sends casual message
     bool send(const char* cbegin, const char* cend);
     // Sends heartbeat periodically and main data
@@ -4,10 +4,12 @@
 
 TTTextBoxHandler::TTTextBoxHandler(const TTTextBoxSettings& settings,
     TTTextBoxCallbackMessageSent callbackMessageSent,
-    TTTextBoxCallbackContactSelect callbackContactsSelect) :
+    TTTextBoxCallbackContactSelect callbackContactsSelect,
+    TTTextBoxCallbackChatPage callbackChatPage) :
         mPipe(settings.getNamedPipe()),
         mCallbackMessageSent(callbackMessageSent),
-        mCallbackContactsSelect(callbackContactsSelect) {
+        mCallbackContactsSelect(callbackContactsSelect),
+        mCallbackChatPage(callbackChatPage) {
     LOG_INFO("Constructing...");
     // Open pipe
     if (!mPipe->open()) {
@@ -57,6 +59,14 @@ void TTTextBoxHandler::main(std::promise<void> promise) {
                         mCallbackContactsSelect(id);
                         break;
                     }
+                    case TTTextBoxStatus::CHAT_PAGE:
+                    {
+                        LOG_INFO("Received chat page message");
+                        size_t page = 0;
+                        memcpy(&page, message.data, message.dataLength);
+                        mCallbackChatPage(page);
+                        break;
+                    }
                     case TTTextBoxStatus::MESSAGE:
                     {
                         LOG_INFO("Received message");
@@ -9,6 +9,7 @@
 
 using TTTextBoxCallbackMessageSent = std::function<void(const std::string&)>;
 using TTTextBoxCallbackContactSelect = std::function<void(size_t)>;
+using TTTextBoxCallbackChatPage = std::function<void(size_t)>;
 
 // Class meant to be embedded into other higher abstract class.
 // Allows to control TTTextBox process concurrently.
@@ -16,7 +17,8 @@ class TTTextBoxHandler : public TTUtilsStopable {
 public:
     explicit TTTextBoxHandler(const TTTextBoxSettings& settings,
         TTTextBoxCallbackMessageSent callbackMessageSent,
-        TTTextBoxCallbackContactSelect callbackContactsSelect);
+        TTTextBoxCallbackContactSelect callbackContactsSelect,
+        TTTextBoxCallbackChatPage callbackChatPage);
     virtual ~TTTextBoxHandler();
     TTTextBoxHandler(const TTTextBoxHandler&) = delete;
     TTTextBoxHandler(TTTextBoxHandler&&) = delete;
@@ -34,6 +36,7 @@ private:
     // Callbacks
     TTTextBoxCallbackMessageSent mCallbackMessageSent;
     TTTextBoxCallbackContactSelect mCallbackContactsSelect;
+    TTTextBoxCallbackChatPage mCallbackChatPage;
     // Thread concurrent message communication
     std::deque<std::thread> mThreads;
     std::deque<std::future<void>> mBlockers;
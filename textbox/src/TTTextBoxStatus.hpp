@@ -6,7 +6,9 @@ enum class TTTextBoxStatus : unsigned int {
     HEARTBEAT,
     CONTACTS_SELECT,
     MESSAGE,
-    GOODBYE
+    GOODBYE,
+    // Appended, values of the others go over the pipe and are kept
+    CHAT_PAGE
 };
 
 inline std::ostream& operator<<(std::ostream& os, const TTTextBoxStatus& rhs)
@@ -17,6 +19,7 @@ inline std::ostream& operator<<(std::ostream& os, const TTTextBoxStatus& rhs)
         case TTTextBoxStatus::CONTACTS_SELECT: os << "CONTACTS_SELECT"; break;
         case TTTextBoxStatus::MESSAGE: os << "MESSAGE"; break;
         case TTTextBoxStatus::GOODBYE: os << "GOODBYE"; break;
+        case TTTextBoxStatus::CHAT_PAGE: os << "CHAT_PAGE"; break;
         default: os << "UNKNOWN"; break;
     }
     return os;
@@ -35,12 +35,15 @@ protected:
         mExpectedMessages.clear();
         mReceivedContactSelections.clear();
         mExpectedContactSelections.clear();
+        mReceivedChatPages.clear();
+        mExpectedChatPages.clear();
     }
 
     void RestartApplication() {
         mHandler = std::make_unique<TTTextBoxHandler>(*mSettingsMock,
             std::bind(&TTTextBoxHandlerTest::MessageReceiver, this, _1),
-            std::bind(&TTTextBoxHandlerTest::ContactsSelectionReceiver, this, _1));
+            std::bind(&TTTextBoxHandlerTest::ContactsSelectionReceiver, this, _1),
+            std::bind(&TTTextBoxHandlerTest::ChatPageReceiver, this, _1));
         EXPECT_FALSE(mHandler->isStopped());
     }
 
@@ -58,6 +61,10 @@ protected:
         mReceivedContactSelections.emplace_back(id);
     }
 
+    void ChatPageReceiver(size_t page) {
+        mReceivedChatPages.emplace_back(page);
+    }
+
     TTTextBoxMessage createUndefinedMessage() {
         return TTTextBoxMessage{TTTextBoxStatus::UNDEFINED, 0, nullptr};
     }
@@ -86,6 +93,11 @@ protected:
         return TTTextBoxMessage{TTTextBoxStatus::CONTACTS_SELECT, sizeof(id), reinterpret_cast<char*>(&id)};
     }
 
+    TTTextBoxMessage createChatPageMessage(size_t page) {
+        mExpectedChatPages.push_back(page);
+        return TTTextBoxMessage{TTTextBoxStatus::CHAT_PAGE, sizeof(page), reinterpret_cast<char*>(&page)};
+    }
+
     std::shared_ptr<TTTextBoxSettingsMock> mSettingsMock;
     std::shared_ptr<TTUtilsNamedPipeMock> mNamedPipeMock;
     std::unique_ptr<TTTextBoxHandler> mHandler;
@@ -93,6 +105,8 @@ protected:
     std::vector<std::string> mExpectedMessages;
     std::vector<size_t> mReceivedContactSelections;
     std::vector<size_t> mExpectedContactSelections;
+    std::vector<size_t> mReceivedChatPages;
+    std::vector<size_t> mExpectedChatPages;
 };
 
 ACTION_P(SetArgPointerInReceiveMessage, rhs) {
@@ -348,3 +362,37 @@ TEST_F(TTTextBoxHandlerTest, SuccessReceivedMixOfMessages) {
         EXPECT_EQ(mExpectedContactSelections[i], mReceivedContactSelections[i]);
     }
 }
+
+TEST_F(TTTextBoxHandlerTest, SuccessReceivedChatPage) {
+    EXPECT_CALL(*mNamedPipeMock, open)
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mNamedPipeMock, alive)
+        .Times(1)
+        .WillOnce(Return(true));
+    const auto heartbeatMessage = createHeartbeatMessage();
+    const std::vector<TTTextBoxMessage> messages = {
+        createChatPageMessage(1),
+        createContactsSelectionMessage(2),
+        createChatPageMessage(7),
+        createChatPageMessage(0)
+    };
+    {
+        InSequence _;
+        for (const auto& msg : messages) {
+            EXPECT_CALL(*mNamedPipeMock, receive)
+                .Times(1)
+                .WillOnce(DoAll(SetArgPointerInReceiveMessage(msg), Return(true)));
+        }
+        EXPECT_CALL(*mNamedPipeMock, receive)
+            .Times(AtLeast(1))
+            .WillRepeatedly(DoAll(SetArgPointerInReceiveMessage(heartbeatMessage), Return(true)));
+    }
+    RestartApplication();
+    std::this_thread::sleep_for(std::chrono::milliseconds{1000});
+    mHandler->stop();
+    VerifyApplicationTimeout(std::chrono::milliseconds{100});
+    // Verify
+    EXPECT_EQ(mExpectedContactSelections, mReceivedContactSelections);
+    EXPECT_EQ(mExpectedChatPages, mReceivedChatPages);
+}
@@ -112,6 +112,10 @@ protected:
         mExpectedMessages.emplace_back(TTTextBoxStatus::CONTACTS_SELECT, sizeof(id), reinterpret_cast<char*>(&id));
     }
 
+    void AddExpectedChatPageMessage(size_t page) {
+        mExpectedMessages.emplace_back(TTTextBoxStatus::CHAT_PAGE, sizeof(page), reinterpret_cast<char*>(&page));
+    }
+
     void AddExpectedMessage(const std::string& msg) {
         mExpectedMessages.emplace_back(TTTextBoxStatus::MESSAGE, msg.size(), msg.c_str());
     }
@@ -322,6 +326,7 @@ TEST_F(TTTextBoxTest, SuccessHelpCommand) {
             "Type #help to print a help message\n" // no comma on purpose
             "Type #quit to quit the application\n" // no comma on purpose
             "Type #select <id> to select contact\n" // no comma on purpose
+            "Type #page <n> to show older messages (0 is the latest page)\n" // no comma on purpose
             "Skip # and send a message to the currently selected contact.\n",
         ""
     };
@@ -463,6 +468,76 @@ TEST_F(TTTextBoxTest, SuccessSelectCommand) {
     EXPECT_TRUE(IsAtLeastOneEqualTo({mSentMessages.begin(), mSentMessages.end()}, mExpectedMessages[1]));
 }
 
+TEST_F(TTTextBoxTest, SuccessPageCommand) {
+    // Expected messages
+    AddExpectedHeartbeatMessage();
+    AddExpectedChatPageMessage(3);
+    AddExpectedGoodbyeMessage();
+    // Expected flow
+    EXPECT_CALL(*mNamedPipeMock, create)
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mNamedPipeMock, alive)
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mNamedPipeMock, send)
+        .Times(AtLeast(1))
+        .WillRepeatedly(std::bind(&TTTextBoxTest::RetrieveSentMessageTrue, this, _1));
+    RestartApplication(std::chrono::milliseconds{600});
+    std::this_thread::sleep_for(std::chrono::milliseconds{600});
+    mInputStreamMock->input("#page 3");
+    std::this_thread::sleep_for(std::chrono::milliseconds{600});
+    mTextBox->stop();
+    mInputStreamMock->input("");
+    std::this_thread::sleep_for(std::chrono::milliseconds{100});
+    // Verify
+    VerifyApplicationTimeout();
+    const auto& actual = mOutputStreamMock->mOutput;
+    const auto& expected = std::vector<std::string>{
+        "Type #help to print a help message\n",
+        "",
+        ""
+    };
+    EXPECT_EQ(actual, expected);
+    EXPECT_TRUE(IsFirstEqualTo({mSentMessages.begin(), mSentMessages.end() - 1}, mExpectedMessages.front()));
+    EXPECT_TRUE(IsLastEqualTo({mSentMessages.begin(), mSentMessages.end()}, mExpectedMessages.back()));
+    EXPECT_TRUE(IsAtLeastOneEqualTo({mSentMessages.begin(), mSentMessages.end()}, mExpectedMessages[1]));
+}
+
+TEST_F(TTTextBoxTest, FailurePageCommandNoArgument) {
+    // Expected messages
+    AddExpectedHeartbeatMessage();
+    AddExpectedGoodbyeMessage();
+    // Expected flow
+    EXPECT_CALL(*mNamedPipeMock, create)
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mNamedPipeMock, alive)
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mNamedPipeMock, send)
+        .Times(AtLeast(1))
+        .WillRepeatedly(std::bind(&TTTextBoxTest::RetrieveSentMessageTrue, this, _1));
+    RestartApplication(std::chrono::milliseconds{600});
+    mInputStreamMock->input("#page");
+    std::this_thread::sleep_for(std::chrono::milliseconds{600});
+    mTextBox->stop();
+    mInputStreamMock->input("");
+    std::this_thread::sleep_for(std::chrono::milliseconds{100});
+    // Verify
+    VerifyApplicationTimeout();
+    const auto& actual = mOutputStreamMock->mOutput;
+    const auto& expected = std::vector<std::string>{
+        "Type #help to print a help message\n",
+        "",
+        ""
+    };
+    EXPECT_EQ(actual, expected);
+    EXPECT_GE(mSentMessages.size(), 2);
+    EXPECT_TRUE(IsEachEqualTo({mSentMessages.begin(), mSentMessages.end() - 1}, mExpectedMessages.front()));
+    EXPECT_TRUE(IsLastEqualTo({mSentMessages.begin(), mSentMessages.end()}, mExpectedMessages.back()));
+}
+
 TEST_F(TTTextBoxTest, FailureSelectCommandTooManyArguments) {
     // Expected messages
     AddExpectedHeartbeatMessage();
@@ -698,6 +773,7 @@ TEST_F(TTTextBoxTest, SuccessMixOfMessagesAndCommands) {
             "Type #help to print a help message\n" // no comma on purpose
             "Type #quit to quit the application\n" // no comma on purpose
             "Type #select <id> to select contact\n" // no comma on purpose
+            "Type #page <n> to show older messages (0 is the latest page)\n" // no comma on purpose
             "Skip # and send a message to the currently selected contact.\n",
         "",
         "",
@@ -0,0 +1,94 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed number of worker threads executing submitted tasks in FIFO order
+class TTUtilsExecutor {
+public:
+    explicit TTUtilsExecutor(size_t workers) {
+        for (size_t i = 0; i < workers; ++i) {
+            mWorkers.emplace_back(&TTUtilsExecutor::work, this);
+        }
+    }
+    virtual ~TTUtilsExecutor() {
+        stop();
+        join();
+    }
+    TTUtilsExecutor(const TTUtilsExecutor&) = delete;
+    TTUtilsExecutor(TTUtilsExecutor&&) = delete;
+    TTUtilsExecutor& operator=(const TTUtilsExecutor&) = delete;
+    TTUtilsExecutor& operator=(TTUtilsExecutor&&) = delete;
+    // Thread-safe submit, returns false if executor is stopped
+    virtual bool submit(std::function<void()> task) {
+        {
+            std::scoped_lock lock(mTasksMutex);
+            if (mStopped) {
+                return false;
+            }
+            mTasks.push_back(std::move(task));
+        }
+        mTasksCondition.notify_one();
+        return true;
+    }
+    // Thread-safe stop, queued tasks are dropped, running tasks are completed
+    virtual void stop() {
+        {
+            std::scoped_lock lock(mTasksMutex);
+            mStopped = true;
+            // Drained tasks are kept, executor might be destructed right after drain
+            if (!mDrained) {
+                mTasks.clear();
+            }
+        }
+        mTasksCondition.notify_all();
+    }
+    // Thread-safe stop, queued tasks are still executed, then workers exit
+    virtual void drain() {
+        {
+            std::scoped_lock lock(mTasksMutex);
+            mStopped = true;
+            mDrained = true;
+        }
+        mTasksCondition.notify_all();
+    }
+    // Waits until workers exit (after stop or drain), executor cannot be used afterwards
+    virtual void join() {
+        std::scoped_lock lock(mWorkersMutex);
+        for (auto& worker : mWorkers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+    [[nodiscard]] size_t size() const {
+        return mWorkers.size();
+    }
+private:
+    void work() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock lock(mTasksMutex);
+                mTasksCondition.wait(lock, [this]() { return mStopped || !mTasks.empty(); });
+                if (mTasks.empty()) {
+                    return;
+                }
+                task = std::move(mTasks.front());
+                mTasks.pop_front();
+            }
+            task();
+        }
+    }
+    std::deque<std::function<void()>> mTasks;
+    std::mutex mTasksMutex;
+    std::condition_variable mTasksCondition;
+    bool mStopped = false;
+    bool mDrained = false;
+    std::mutex mWorkersMutex;
+    // Workers have to be started after the rest is initialized
+    std::vector<std::thread> mWorkers;
+};
@@ -0,0 +1,51 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+// Lock-free multiple producers single consumer queue
+template <typename T>
+class TTUtilsMpscQueue {
+public:
+    TTUtilsMpscQueue() :
+        mHead{nullptr} {}
+    virtual ~TTUtilsMpscQueue() {
+        release(mHead.exchange(nullptr));
+    }
+    TTUtilsMpscQueue(const TTUtilsMpscQueue&) = delete;
+    TTUtilsMpscQueue(TTUtilsMpscQueue&&) = delete;
+    TTUtilsMpscQueue& operator=(const TTUtilsMpscQueue&) = delete;
+    TTUtilsMpscQueue& operator=(TTUtilsMpscQueue&&) = delete;
+    // Thread-safe push (any producer)
+    void push(T value) {
+        auto* node = new Node{std::move(value), mHead.load(std::memory_order_relaxed)};
+        while (!mHead.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed));
+    }
+    // Thread-safe pop of all values in push order (single consumer)
+    [[nodiscard]] std::vector<T> pop() {
+        auto* node = mHead.exchange(nullptr, std::memory_order_acquire);
+        std::vector<T> values;
+        for (auto* it = node; it; it = it->next) {
+            values.push_back(std::move(it->value));
+        }
+        release(node);
+        std::reverse(values.begin(), values.end());
+        return values;
+    }
+    // Thread-safe getter
+    [[nodiscard]] bool empty() const {
+        return mHead.load(std::memory_order_acquire) == nullptr;
+    }
+private:
+    struct Node {
+        T value;
+        Node* next;
+    };
+    static void release(Node* node) {
+        while (node) {
+            delete std::exchange(node, node->next);
+        }
+    }
+    std::atomic<Node*> mHead;
+};
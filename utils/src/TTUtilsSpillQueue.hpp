@@ -0,0 +1,101 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+// File backed FIFO queue of strings, file is removed on destruction (thread-unsafe)
+class TTUtilsSpillQueue {
+public:
+    explicit TTUtilsSpillQueue(const std::filesystem::path& path) : mPath(path) {
+        mFile.open(mPath, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!mFile) {
+            throw std::runtime_error("TTUtilsSpillQueue: Failed to open file=" + mPath.string());
+        }
+    }
+    virtual ~TTUtilsSpillQueue() {
+        mFile.close();
+        std::error_code error;
+        std::filesystem::remove(mPath, error);
+    }
+    TTUtilsSpillQueue(const TTUtilsSpillQueue&) = delete;
+    TTUtilsSpillQueue(TTUtilsSpillQueue&&) = delete;
+    TTUtilsSpillQueue& operator=(const TTUtilsSpillQueue&) = delete;
+    TTUtilsSpillQueue& operator=(TTUtilsSpillQueue&&) = delete;
+    // Appends value at the end of the file, value is written through so that failure is reported at once
+    bool push(const std::string& value) {
+        const auto length = static_cast<uint32_t>(value.size());
+        mFile.seekp(mEnd);
+        mFile.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        mFile.write(value.data(), value.size());
+        mFile.flush();
+        if (!mFile) [[unlikely]] {
+            recover();
+            return false;
+        }
+        mEnd = mFile.tellp();
+        ++mSize;
+        mBytes += value.size();
+        return true;
+    }
+    // Returns size of the front value without reading it
+    [[nodiscard]] std::optional<size_t> peek() {
+        if (!mSize) {
+            return std::nullopt;
+        }
+        uint32_t length = 0;
+        mFile.seekg(mOffset);
+        mFile.read(reinterpret_cast<char*>(&length), sizeof(length));
+        if (!mFile) [[unlikely]] {
+            mFile.clear();
+            return std::nullopt;
+        }
+        return length;
+    }
+    [[nodiscard]] std::optional<std::string> pop() {
+        const auto length = peek();
+        if (!length) {
+            return std::nullopt;
+        }
+        std::string value(*length, '\0');
+        mFile.read(value.data(), value.size());
+        if (!mFile) [[unlikely]] {
+            mFile.clear();
+            return std::nullopt;
+        }
+        mOffset = mFile.tellg();
+        --mSize;
+        mBytes -= value.size();
+        // Drained file is truncated, so it does not grow forever
+        if (!mSize) {
+            std::error_code error;
+            mFile.flush();
+            std::filesystem::resize_file(mPath, 0, error);
+            mOffset = 0;
+            mEnd = 0;
+        }
+        return value;
+    }
+    [[nodiscard]] bool empty() const { return mSize == 0; }
+    [[nodiscard]] size_t size() const { return mSize; }
+    [[nodiscard]] size_t bytes() const { return mBytes; }
+private:
+    // Partially written value is cut off and the file is reopened, so that the following values stay readable
+    void recover() {
+        mFile.clear();
+        mFile.close();
+        std::error_code error;
+        std::filesystem::resize_file(mPath, mEnd, error);
+        mFile.open(mPath, std::ios::in | std::ios::out | std::ios::binary);
+    }
+    std::filesystem::path mPath;
+    std::fstream mFile;
+    // Offset of the front value
+    std::streamoff mOffset = 0;
+    // Offset past the last complete value
+    std::streamoff mEnd = 0;
+    size_t mSize = 0;
+    size_t mBytes = 0;
+};
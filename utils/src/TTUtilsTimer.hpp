@@ -22,6 +22,10 @@ public:
         const auto difference = std::chrono::duration_cast<std::chrono::milliseconds>(end - mTimestamp);
         return difference;
     }
+    // Point in time when timer expires
+    virtual std::chrono::steady_clock::time_point deadline() const {
+        return mTimestamp + mThreshold;
+    }
     virtual void kick() {
         mTimestamp = std::chrono::steady_clock::now();
     }
@@ -0,0 +1,121 @@
+#include "TTUtilsExecutor.hpp"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using ::testing::ElementsAre;
+
+TEST(TTUtilsExecutorTest, HappyPathTasksExecutedInOrder) {
+    std::mutex mutex;
+    std::vector<int> executed;
+    {
+        TTUtilsExecutor executor(1);
+        EXPECT_EQ(executor.size(), 1);
+        for (int i = 0; i < 3; ++i) {
+            EXPECT_TRUE(executor.submit([&, i]() {
+                std::scoped_lock lock(mutex);
+                executed.push_back(i);
+            }));
+        }
+        while (true) {
+            std::scoped_lock lock(mutex);
+            if (executed.size() == 3) {
+                break;
+            }
+        }
+    }
+    EXPECT_THAT(executed, ElementsAre(0, 1, 2));
+}
+
+TEST(TTUtilsExecutorTest, HappyPathStopWithPendingTasks) {
+    std::atomic<bool> running{false};
+    std::atomic<bool> released{false};
+    std::atomic<bool> completed{false};
+    std::atomic<size_t> pending{0};
+    TTUtilsExecutor executor(1);
+    EXPECT_TRUE(executor.submit([&]() {
+        running.store(true);
+        while (!released.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        completed.store(true);
+    }));
+    while (!running.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    // The only worker is busy, so these stay queued
+    for (size_t i = 0; i < 5; ++i) {
+        EXPECT_TRUE(executor.submit([&]() { ++pending; }));
+    }
+    executor.stop();
+    EXPECT_FALSE(executor.submit([&]() { ++pending; }));
+    // Running task is completed, queued ones are dropped
+    released.store(true);
+    while (!completed.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds{100});
+    EXPECT_EQ(pending.load(), 0);
+}
+
+TEST(TTUtilsExecutorTest, HappyPathDestructorWaitsForRunningTask) {
+    std::atomic<bool> running{false};
+    std::atomic<bool> completed{false};
+    {
+        TTUtilsExecutor executor(2);
+        EXPECT_TRUE(executor.submit([&]() {
+            running.store(true);
+            std::this_thread::sleep_for(std::chrono::milliseconds{100});
+            completed.store(true);
+        }));
+        while (!running.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+    }
+    EXPECT_TRUE(completed.load());
+}
+
+TEST(TTUtilsExecutorTest, HappyPathDrainWithPendingTasks) {
+    std::atomic<bool> running{false};
+    std::atomic<bool> released{false};
+    std::atomic<size_t> pending{0};
+    {
+        TTUtilsExecutor executor(1);
+        EXPECT_TRUE(executor.submit([&]() {
+            running.store(true);
+            while (!released.load()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            }
+        }));
+        while (!running.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        for (size_t i = 0; i < 5; ++i) {
+            EXPECT_TRUE(executor.submit([&]() { ++pending; }));
+        }
+        executor.drain();
+        EXPECT_FALSE(executor.submit([&]() { ++pending; }));
+        released.store(true);
+    }
+    // Queued tasks are executed before workers exit
+    EXPECT_EQ(pending.load(), 5);
+}
+
+TEST(TTUtilsExecutorTest, HappyPathJoinWaitsForDrainedTasks) {
+    std::atomic<size_t> completed{0};
+    TTUtilsExecutor executor(2);
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_TRUE(executor.submit([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds{50});
+            ++completed;
+        }));
+    }
+    executor.drain();
+    executor.join();
+    EXPECT_EQ(completed.load(), 4);
+    EXPECT_FALSE(executor.submit([&]() { ++completed; }));
+}
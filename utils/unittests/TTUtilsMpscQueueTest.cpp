@@ -0,0 +1,67 @@
+#include "TTUtilsMpscQueue.hpp"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+TEST(TTUtilsMpscQueueTest, HappyPathPopInPushOrder) {
+    TTUtilsMpscQueue<int> queue;
+    EXPECT_TRUE(queue.empty());
+    queue.push(1);
+    queue.push(2);
+    queue.push(3);
+    EXPECT_FALSE(queue.empty());
+    EXPECT_THAT(queue.pop(), ElementsAre(1, 2, 3));
+    EXPECT_TRUE(queue.empty());
+    EXPECT_THAT(queue.pop(), IsEmpty());
+}
+
+TEST(TTUtilsMpscQueueTest, HappyPathConcurrentProducersKeepTheirOrder) {
+    const size_t producers = 4;
+    const size_t values = 10000;
+    TTUtilsMpscQueue<std::pair<size_t, size_t>> queue;
+    std::vector<std::pair<size_t, size_t>> popped;
+    std::vector<std::thread> threads;
+    for (size_t producer = 0; producer < producers; ++producer) {
+        threads.emplace_back([&queue, producer]() {
+            for (size_t value = 0; value < values; ++value) {
+                queue.push({producer, value});
+            }
+        });
+    }
+    // Consumer pops while producers are still pushing
+    while (popped.size() < producers * values) {
+        for (auto& value : queue.pop()) {
+            popped.push_back(value);
+        }
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_TRUE(queue.empty());
+    // Values of each producer come out in the order they were pushed
+    std::vector<size_t> expected(producers, 0);
+    for (const auto& [producer, value] : popped) {
+        ASSERT_LT(producer, producers);
+        EXPECT_EQ(value, expected[producer]++);
+    }
+    for (const auto& count : expected) {
+        EXPECT_EQ(count, values);
+    }
+}
+
+TEST(TTUtilsMpscQueueTest, HappyPathDestructorReleasesValues) {
+    auto value = std::make_shared<int>(1);
+    {
+        TTUtilsMpscQueue<std::shared_ptr<int>> queue;
+        queue.push(value);
+        queue.push(value);
+        EXPECT_EQ(value.use_count(), 3);
+    }
+    EXPECT_EQ(value.use_count(), 1);
+}
@@ -0,0 +1,103 @@
+#include "TTUtilsSpillQueue.hpp"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <sys/resource.h>
+
+using ::testing::ThrowsMessage;
+using ::testing::HasSubstr;
+using ::testing::Optional;
+
+class TTUtilsSpillQueueTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        std::filesystem::remove(mPath);
+    }
+    void TearDown() override {
+        std::filesystem::remove(mPath);
+    }
+    const std::filesystem::path mPath = std::filesystem::path(::testing::TempDir()) / "tteams-spill-queue-test";
+};
+
+TEST_F(TTUtilsSpillQueueTest, HappyPathPushPopInOrder) {
+    TTUtilsSpillQueue queue(mPath);
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.peek(), std::nullopt);
+    EXPECT_EQ(queue.pop(), std::nullopt);
+    EXPECT_TRUE(queue.push("foo"));
+    EXPECT_TRUE(queue.push(""));
+    EXPECT_TRUE(queue.push("barbaz"));
+    EXPECT_EQ(queue.size(), 3);
+    EXPECT_EQ(queue.bytes(), 9);
+    EXPECT_THAT(queue.peek(), Optional(3));
+    EXPECT_THAT(queue.pop(), Optional(std::string("foo")));
+    EXPECT_THAT(queue.pop(), Optional(std::string("")));
+    EXPECT_THAT(queue.pop(), Optional(std::string("barbaz")));
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.bytes(), 0);
+}
+
+TEST_F(TTUtilsSpillQueueTest, HappyPathDrainedFileTruncatedAndReused) {
+    TTUtilsSpillQueue queue(mPath);
+    EXPECT_TRUE(queue.push("foo"));
+    EXPECT_TRUE(queue.push("bar"));
+    EXPECT_THAT(queue.pop(), Optional(std::string("foo")));
+    // Pushes interleaved with pops keep the order
+    EXPECT_TRUE(queue.push("baz"));
+    EXPECT_THAT(queue.pop(), Optional(std::string("bar")));
+    EXPECT_THAT(queue.pop(), Optional(std::string("baz")));
+    EXPECT_EQ(std::filesystem::file_size(mPath), 0);
+    EXPECT_TRUE(queue.push("qux"));
+    EXPECT_THAT(queue.pop(), Optional(std::string("qux")));
+}
+
+TEST_F(TTUtilsSpillQueueTest, HappyPathFileTruncatedOnOpenAndRemovedOnDestruction) {
+    {
+        TTUtilsSpillQueue queue(mPath);
+        EXPECT_TRUE(queue.push("foo"));
+    }
+    EXPECT_FALSE(std::filesystem::exists(mPath));
+    {
+        std::ofstream stale(mPath);
+        stale << "stale";
+    }
+    // Leftover of previous run is not read back
+    TTUtilsSpillQueue queue(mPath);
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(std::filesystem::file_size(mPath), 0);
+    EXPECT_TRUE(queue.push("bar"));
+    EXPECT_THAT(queue.pop(), Optional(std::string("bar")));
+}
+
+TEST_F(TTUtilsSpillQueueTest, UnhappyPathWriteFailureKeepsQueueReadable) {
+    TTUtilsSpillQueue queue(mPath);
+    EXPECT_TRUE(queue.push("foo"));
+    // File size limit makes the next write fail half way
+    rlimit previous{};
+    ASSERT_EQ(getrlimit(RLIMIT_FSIZE, &previous), 0);
+    const auto handler = std::signal(SIGXFSZ, SIG_IGN);
+    rlimit limited = previous;
+    limited.rlim_cur = 1024;
+    ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &limited), 0);
+    const bool pushed = queue.push(std::string(64 * 1024, 'x'));
+    ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &previous), 0);
+    std::signal(SIGXFSZ, handler);
+    EXPECT_FALSE(pushed);
+    EXPECT_EQ(queue.size(), 1);
+    EXPECT_EQ(queue.bytes(), 3);
+    // Partially written value is discarded, the file is reopened and values around it stay intact
+    EXPECT_TRUE(queue.push("bar"));
+    EXPECT_THAT(queue.pop(), Optional(std::string("foo")));
+    EXPECT_THAT(queue.pop(), Optional(std::string("bar")));
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(TTUtilsSpillQueueTest, UnhappyPathFailedToOpen) {
+    const auto path = mPath / "missing" / "file";
+    EXPECT_THAT([&]() {TTUtilsSpillQueue queue(path);},
+        ThrowsMessage<std::runtime_error>(HasSubstr("TTUtilsSpillQueue: Failed to open file=")));
+}